@@ -0,0 +1,10 @@
+#version 460 core
+
+layout (location = 0) in vec4 color;
+
+out vec4 outColor;
+
+void main()
+{
+    outColor = color;
+}
\ No newline at end of file
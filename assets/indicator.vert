@@ -0,0 +1,19 @@
+#version 460 core
+
+layout (location = 0) in vec2 position;
+
+//Center and half size of each lane's bar, uploaded once a frame however many controller messages came in
+layout (location = 0) uniform vec4 bounds[8];
+layout (location = 8) uniform vec4 colors[8];
+
+layout (location = 0) out vec4 outColor;
+
+void main()
+{
+    vec4 bar = bounds[gl_InstanceID];
+
+    //The note quad's corners sit at plus or minus the note size, their signs give a unit quad to stretch over the bar
+    vec2 corner = sign(position);
+    gl_Position = vec4(bar.xy + corner * bar.zw, 0.9, 1.0);
+    outColor = colors[gl_InstanceID];
+}
\ No newline at end of file
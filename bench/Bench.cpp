@@ -0,0 +1,788 @@
+#include "Defines.hpp"
+
+#include "Allocations.hpp"
+#include "CloneHero.hpp"
+#include "Config.hpp"
+#include "Controllers.hpp"
+#include "Engine.hpp"
+#include "EventSource.hpp"
+#include "FrameArena.hpp"
+#include "MidiDispatch.hpp"
+#include "RawMidi.hpp"
+#include "SettingsWriter.hpp"
+#include "StringTable.hpp"
+#include "Time.hpp"
+#include "Parser.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef DV_PLATFORM_LINUX
+#	include <fcntl.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+#ifdef DV_BENCH_RTMIDI
+#	include "rtmidi/RtMidi.h"
+#endif
+
+struct BenchResult
+{
+	std::string name;
+	U64 iterations;
+	F64 nsPerOp;
+	F64 minNsPerOp;
+	F64 allocationsPerOp;
+	F64 bytesPerOp;
+	bool allocationFree;
+};
+
+struct BenchOptions
+{
+	std::string filter{};
+	std::string jsonPath{};
+	U32 repeats{ 5 };
+	U64 minBatchTime{ 20000000 };
+	bool checkAllocations{ false };
+	std::string virmidiWrite{};		//snd-virmidi device the round trips write to
+	std::string virmidiRead{};		//snd-virmidi device connected to virmidiWrite with aconnect, read raw
+	std::string rtmidiPort{};		//Part of the name of virmidiWrite's sequencer port, read through RtMidi
+};
+
+/// <summary>
+/// Microbenchmarks for the input, spawn and parsing hot paths, links only the core library so it runs without a
+/// window or GL context
+/// </summary>
+class Bench
+{
+public:
+	static I32 Run(const BenchOptions& options);
+
+private:
+	/// <summary>
+	/// Times op in batches, setup runs untimed before every batch
+	/// </summary>
+	/// <param name="allocationFree:">The op is on a per-event or per-frame path and must not allocate</param>
+	static void Measure(const std::string& name, const std::function<void()>& setup, const std::function<void()>& op, bool allocationFree = false);
+
+	static void PrepareEngine();
+	static void WriteInputs();
+	static void WriteJson(std::ostream& output);
+
+	/// <summary>
+	/// Prints how much longer a benchmark takes on a larger input, a linear one grows with the input
+	/// </summary>
+	/// <param name="inputRatio:">How many times larger the large benchmark's input is</param>
+	static void ReportScaling(const std::string& small, const std::string& large, F64 inputRatio);
+
+	static void MidiDispatch();
+	static void SpawnNotes();
+	static void NoteUpdate();
+	static void Colors();
+	static void MidiProfiles();
+	static void Config();
+	static void Profiles();
+	static void RawMidi();
+
+	/// <summary>
+	/// Writes a note-on to a device and waits until a reader on the other end has seen it
+	/// </summary>
+	static void RoundTrip(const std::string& name, const std::string& writePath);
+
+	static std::string SyntheticColors();
+	static std::string SyntheticMidiProfile(U32 mappingsPerPad);
+	static std::string SyntheticConfig(U32 paddingLines);
+	static std::string SyntheticProfiles(U32 profileCount);
+	static void ClearProfiles();
+
+	static BenchOptions options;
+	static std::vector<BenchResult> results;
+	static std::filesystem::path folder;
+	static Texture texture;
+
+	static Settings settings;
+	static ColorProfile colors;
+	static NoteLayout layout;
+	static Engine engine;
+	static std::filesystem::path cloneHeroFolder;
+	static std::vector<Profile> profiles;
+	static StringTable profileNames;
+	static StringTable colorProfileNames;
+	static std::vector<Mapping> mappings;
+	static std::atomic<U64> received;
+
+	STATIC_CLASS(Bench)
+};
+
+BenchOptions Bench::options;
+std::vector<BenchResult> Bench::results;
+std::filesystem::path Bench::folder;
+Texture Bench::texture{ "bench", 0, 1, 1 };
+Settings Bench::settings{};
+ColorProfile Bench::colors{};
+NoteLayout Bench::layout = ConfigFile::DefaultLayout();
+Engine Bench::engine{ settings, colors };
+std::filesystem::path Bench::cloneHeroFolder;
+std::vector<Profile> Bench::profiles;
+StringTable Bench::profileNames;
+StringTable Bench::colorProfileNames;
+std::vector<Mapping> Bench::mappings;
+std::atomic<U64> Bench::received{ 0 };
+
+//Swallows the console output of the functions being measured
+struct NullBuffer : std::streambuf
+{
+	I32 overflow(I32 c) override { return c; }
+};
+
+struct NullWideBuffer : std::wstreambuf
+{
+	std::wint_t overflow(std::wint_t c) override { return c; }
+};
+
+I32 Bench::Run(const BenchOptions& options_)
+{
+	options = options_;
+
+	folder = std::filesystem::temp_directory_path() / "DrumVisualizerBench";
+	std::filesystem::create_directories(folder);
+
+	PrepareEngine();
+	WriteInputs();
+
+	std::filesystem::path workingDirectory = std::filesystem::current_path();
+	std::filesystem::current_path(folder);
+
+	NullBuffer nullBuffer;
+	NullWideBuffer nullWideBuffer;
+	std::streambuf* out = std::cout.rdbuf(&nullBuffer);
+	std::wstreambuf* wideOut = std::wcout.rdbuf(&nullWideBuffer);
+
+	MidiDispatch();
+	SpawnNotes();
+	NoteUpdate();
+	Colors();
+	MidiProfiles();
+	Config();
+	Profiles();
+	RawMidi();
+
+	std::cout.rdbuf(out);
+	std::wcout.rdbuf(wideOut);
+
+	std::filesystem::current_path(workingDirectory);
+
+	std::cout << "benchmark                                   ns/op        min ns/op    allocs/op   bytes/op" << std::endl;
+	for (const BenchResult& result : results)
+	{
+		C8 line[256];
+		snprintf(line, sizeof(line), "%-40s %12.1f %12.1f %11.2f %10.1f", result.name.c_str(), result.nsPerOp,
+			result.minNsPerOp, result.allocationsPerOp, result.bytesPerOp);
+		std::cout << line << std::endl;
+	}
+
+	ReportScaling("load_profiles/1000_profiles", "load_profiles/20000_profiles", 20.0);
+
+	if (!options.jsonPath.empty())
+	{
+		if (options.jsonPath == "-") { WriteJson(std::cout); }
+		else
+		{
+			std::ofstream output(options.jsonPath);
+			if (!output.is_open())
+			{
+				std::cout << "Failed To Write Results: " << options.jsonPath << std::endl;
+				return -1;
+			}
+
+			WriteJson(output);
+		}
+	}
+
+	if (options.checkAllocations)
+	{
+		bool passed = true;
+
+		for (const BenchResult& result : results)
+		{
+			if (result.allocationFree && result.allocationsPerOp > 0.0)
+			{
+				std::cout << "FAILED: " << result.name << " allocates " << result.allocationsPerOp << " times per op" << std::endl;
+				passed = false;
+			}
+		}
+
+		if (!passed) { return 1; }
+
+		std::cout << "Allocation check passed" << std::endl;
+	}
+
+	return 0;
+}
+
+void Bench::Measure(const std::string& name, const std::function<void()>& setup, const std::function<void()>& op, bool allocationFree)
+{
+	if (!options.filter.empty() && name.find(options.filter) == std::string::npos) { return; }
+
+	setup();
+	op();
+
+	//Grow the batch until it runs long enough for the clock to be meaningful
+	U64 iterations = 1;
+	while (true)
+	{
+		setup();
+		U64 start = Time::Now();
+		for (U64 i = 0; i < iterations; ++i) { op(); }
+		U64 elapsed = Time::Now() - start;
+
+		if (elapsed >= options.minBatchTime || iterations >= (1ull << 30)) { break; }
+
+		U64 scale = elapsed ? options.minBatchTime * 2 / elapsed : 100;
+		iterations *= scale < 2 ? 2 : (scale > 100 ? 100 : scale);
+	}
+
+	std::vector<F64> samples;
+	U64 allocations = 0;
+	U64 bytes = 0;
+
+	for (U32 r = 0; r < options.repeats; ++r)
+	{
+		setup();
+
+		U64 startAllocations = Allocations::ThreadCount();
+		U64 startBytes = Allocations::ThreadBytes();
+		U64 startOverflows = FrameArena::GetOverflowCount();
+		U64 start = Time::Now();
+
+		for (U64 i = 0; i < iterations; ++i) { op(); }
+
+		U64 elapsed = Time::Now() - start;
+		//Arena overflows go straight to malloc, they count as allocations even though operator new never sees them
+		allocations += Allocations::ThreadCount() - startAllocations + FrameArena::GetOverflowCount() - startOverflows;
+		bytes += Allocations::ThreadBytes() - startBytes;
+
+		samples.push_back(static_cast<F64>(elapsed) / iterations);
+	}
+
+	std::sort(samples.begin(), samples.end());
+
+	F64 ops = static_cast<F64>(iterations) * options.repeats;
+	results.push_back({ name, iterations, samples[samples.size() / 2], samples[0], allocations / ops, bytes / ops, allocationFree });
+}
+
+void Bench::PrepareEngine()
+{
+	FrameArena::Initialize();
+	engine.SetDefaultTexture(&texture);
+
+	settings.tomTexture = &texture;
+	settings.cymbalTexture = &texture;
+	settings.kickTexture = &texture;
+
+	cloneHeroFolder = folder;
+}
+
+void Bench::WriteInputs()
+{
+	auto write = [](const std::filesystem::path& path, const std::string& data)
+	{
+		std::ofstream output(path, std::ios::binary);
+		output << data;
+	};
+
+	write(folder / "colors.ini", SyntheticColors());
+	write(folder / "profile.yaml", SyntheticMidiProfile(256));
+	write(folder / "settings.cfg", SyntheticConfig(4096));
+	write(folder / "profiles.ini", SyntheticProfiles(1000));
+
+	std::filesystem::path large = folder / "Large";
+	std::filesystem::create_directories(large / "Custom" / "Colors");
+	write(large / "profiles.ini", SyntheticProfiles(20000));
+
+	//Only the listing is measured, the files just need the right extension
+	for (U32 i = 0; i < 2000; ++i) { write(large / "Custom" / "Colors" / ("colors" + std::to_string(i) + ".ini"), "[drums]\n"); }
+}
+
+void Bench::ReportScaling(const std::string& small, const std::string& large, F64 inputRatio)
+{
+	const BenchResult* smallResult = nullptr;
+	const BenchResult* largeResult = nullptr;
+
+	for (const BenchResult& result : results)
+	{
+		if (result.name == small) { smallResult = &result; }
+		if (result.name == large) { largeResult = &result; }
+	}
+
+	if (!smallResult || !largeResult || smallResult->minNsPerOp <= 0.0) { return; }
+
+	//Min times, the medians of long runs pick up more noise than the ratio can take
+	C8 line[256];
+	snprintf(line, sizeof(line), "%s: %.1fx the time for %.0fx the input", large.c_str(),
+		largeResult->minNsPerOp / smallResult->minNsPerOp, inputRatio);
+	std::cout << line << std::endl;
+}
+
+void Bench::WriteJson(std::ostream& output)
+{
+	output << "{\n\t\"benchmark\": \"DrumVisualizerBench\",\n\t\"results\": [";
+
+	for (U64 i = 0; i < results.size(); ++i)
+	{
+		const BenchResult& result = results[i];
+
+		output << (i ? ",\n" : "\n") << "\t\t{ \"name\": \"" << result.name << "\", \"iterations\": " << result.iterations <<
+			", \"ns_per_op\": " << result.nsPerOp << ", \"min_ns_per_op\": " << result.minNsPerOp <<
+			", \"allocations_per_op\": " << result.allocationsPerOp << ", \"bytes_per_op\": " << result.bytesPerOp <<
+			", \"allocation_free\": " << (result.allocationFree ? "true" : "false") << " }";
+	}
+
+	output << "\n\t]\n}\n";
+}
+
+void Bench::MidiDispatch()
+{
+	//Lookup cost grows with the profile, measure a stock sized profile and a large one, half the notes miss
+	for (U32 mappingsPerPad : { 8u, 64u })
+	{
+		std::filesystem::path path = folder / ("dispatch" + std::to_string(mappingsPerPad) + ".yaml");
+		std::ofstream(path, std::ios::binary) << SyntheticMidiProfile(mappingsPerPad);
+
+		U64 time = 0;
+		U32 note = 0;
+
+		Measure("midi_dispatch/" + std::to_string(mappingsPerPad * 8) + "_mappings",
+			[&]()
+			{
+				CloneHero::LoadMidiProfile(path, engine.GetMappings());
+				for (Mapping& mapping : engine.GetMappings()) { mapping.overhitThreshold = 0.0; }
+				engine.Reset();
+			},
+			[&]()
+			{
+				MidiEvent event{};
+				event.time = time += 1000000;
+				event.size = 3;
+				event.bytes[0] = 153;
+				event.bytes[1] = static_cast<U8>(note++ & 127);
+				event.bytes[2] = 100;
+
+				engine.ProcessEvent(event);
+			}, true);
+	}
+
+	//What a kit streams besides hits, clock, sensing, hi-hat CC, MTC and notes on a channel that isn't read
+	static constexpr U8 Traffic[][3] = { { 0x99, 38, 100 }, { 0xF8, 0, 0 }, { 0xB9, 4, 64 }, { 0xFE, 0, 0 },
+		{ 0x92, 38, 100 }, { 0xF1, 0x21, 0 }, { 0x89, 38, 0 }, { 0xA9, 49, 127 } };
+
+	std::vector<MidiEvent> events(4096);
+	for (U32 i = 0; i < events.size(); ++i)
+	{
+		const U8* bytes = Traffic[i % CountOf(Traffic)];
+		events[i].size = bytes[0] >= 0xF8 ? 1 : (bytes[0] == 0xF1 ? 2 : 3);
+		memcpy(events[i].bytes, bytes, 3);
+	}
+
+	::MidiDispatch dispatch;
+	U64 kept = 0;
+
+	Measure("midi_dispatch/classify/4096_messages", []() {},
+		[&]()
+		{
+			for (const MidiEvent& event : events) { kept += dispatch.Classify(event) != MidiMessage::Ignored; }
+		}, true);
+
+	if (kept == 0) { std::cout << kept; }
+
+	//A hi-hat pedal swept back and forth at 1000 messages a second, the rate Controllers decimates down from
+	std::vector<MidiEvent> pedal(4096);
+	for (U32 i = 0; i < pedal.size(); ++i)
+	{
+		U32 phase = i & 255;
+		pedal[i] = { i * 1000000ull, 3, { 0xB9, 4, static_cast<U8>(phase < 128 ? phase : 255 - phase) } };
+	}
+
+	Controllers controllers;
+	controllers.SetLanes({ -1, -1, 4, -1, -1, -1, -1, -1 });
+	std::array<F32, Controllers::LaneCount> levels{};
+	std::array<U32, Controllers::LaneCount> closes{};
+
+	Measure("midi_dispatch/controllers/4096_messages", [&]() { controllers.Reset(); },
+		[&]()
+		{
+			for (const MidiEvent& event : pedal) { controllers.Feed(event); }
+			controllers.Sample(pedal.back().time, levels, closes);
+		}, true);
+
+	if (levels[2] < 0.0f) { std::cout << levels[2]; }
+}
+
+void Bench::SpawnNotes()
+{
+	static const C8* directionNames[] = { "up", "down", "left", "right" };
+	static const C8* modeNames[] = { "none", "cutoff", "squish" };
+
+	Stats stats{};
+
+	for (U32 direction = 0; direction < CountOf(directionNames); ++direction)
+	{
+		for (U32 mode = 0; mode < CountOf(modeNames); ++mode)
+		{
+			Measure(std::string("spawn_note/") + directionNames[direction] + '/' + modeNames[mode],
+				[&]()
+				{
+					settings.scrollDirection = (ScrollDirection)direction;
+					settings.noteSeparationMode = (NoteSeparationMode)mode;
+					engine.Reset();
+					stats = {};
+				},
+				[&]()
+				{
+					//Spawning on top of the previous note takes the separation path every time
+					engine.SpawnNote(stats, { 1.0f, 0.0f, 0.0f }, &texture);
+				}, true);
+		}
+	}
+
+	settings.scrollDirection = ScrollDirection::Down;
+	settings.noteSeparationMode = NoteSeparationMode::Cutoff;
+}
+
+void Bench::NoteUpdate()
+{
+	Measure("note_update/simulate", []() { engine.Reset(); },
+		[]() { engine.Simulate({ 0.0f, -0.001f }); }, true);
+
+	//What Renderer::Upload does before flushing the instance buffer, a frame's arena reset included
+	Measure("note_update/pack_instances", []() { engine.Reset(); },
+		[]()
+		{
+			FrameArena::BeginFrame();
+			U8* instances = FrameArena::Allocate<U8>(Engine::InstanceSize);
+			engine.PackInstances(instances);
+		}, true);
+}
+
+void Bench::Colors()
+{
+	static const std::string hexes[] = { "FF0000", "FFE531", "0089FF", "1D63FF", "00FF00", "0CFF0C", "FF4600", "garbage" };
+	U32 index = 0;
+	F32 sink = 0.0f;
+
+	Measure("hex_to_rgb", []() {},
+		[&]() { sink += CloneHero::HexToRBG(hexes[index++ & 7]).x; });
+
+	std::filesystem::path path = folder / "colors.ini";
+
+	ColorProfile loaded{};
+
+	Measure("load_colors", []() {}, [&]() { CloneHero::LoadColors(path, loaded); });
+
+	if (sink < 0.0f) { std::cout << sink; }
+}
+
+void Bench::MidiProfiles()
+{
+	std::filesystem::path path = folder / "profile.yaml";
+
+	Measure("load_midi_profile/2048_mappings", []() {},
+		[&]()
+		{
+			CloneHero::LoadMidiProfile(path, mappings);
+		});
+
+	std::string data = SyntheticMidiProfile(256);
+
+	Measure("parse_midi_profile/2048_mappings", []() {},
+		[&]()
+		{
+			CloneHero::ParseMidiProfile(data, mappings);
+		});
+
+	U64 sink = 0;
+
+	Measure("tokenize_yaml/2048_mappings", []() {},
+		[&]()
+		{
+			YamlReader reader(data);
+			YamlLine line;
+			while (reader.Next(line)) { sink += line.value.size(); }
+		}, true);
+
+	if (sink == 0) { std::cout << sink; }
+}
+
+void Bench::Config()
+{
+	Measure("load_config/4096_lines", []() {}, []() { ConfigFile::Load(ConfigFile::Read(SettingsWriter::Path), settings, layout); });
+}
+
+void Bench::Profiles()
+{
+	Measure("load_profiles/1000_profiles", []() {},
+		[]()
+		{
+			CloneHero::LoadProfiles(cloneHeroFolder, profiles, profileNames);
+		});
+
+	std::string data = SyntheticProfiles(1000);
+	U64 tokens = 0;
+
+	Measure("tokenize_ini/1000_profiles", []() {},
+		[&]()
+		{
+			IniReader reader(data);
+			IniLine line;
+			while (reader.Next(line)) { tokens += line.value.size(); }
+		}, true);
+
+	if (tokens == 0) { std::cout << tokens; }
+
+	//A Clone Hero folder shared by a whole venue worth of players
+	std::filesystem::path largeFolder = folder / "Large";
+
+	Measure("load_profiles/20000_profiles", []() {},
+		[&]()
+		{
+			CloneHero::LoadProfiles(largeFolder, profiles, profileNames);
+		});
+
+	Measure("load_color_profiles/2000_files", []() {},
+		[&]()
+		{
+			CloneHero::LoadColorProfiles(largeFolder, colorProfileNames);
+		});
+
+	//What UI::Initialize does to find the saved profile in a list
+	static const std::string names[] = { "Player 0", "Player 517", "Player 999", "Nobody" };
+	U32 index = 0;
+	U32 sink = 0;
+
+	Measure("profile_lookup/1000_profiles", []() {},
+		[&]() { sink += profileNames.Find(names[index++ & 3]); }, true);
+
+	ClearProfiles();
+}
+
+void Bench::RawMidi()
+{
+	//A kit's worth of hits with running status, interleaved with clock and active sensing like a real device
+	std::vector<U8> stream;
+	for (U32 i = 0; i < 4096; ++i)
+	{
+		if ((i & 15) == 0) { stream.push_back(0x99); }
+		stream.push_back(static_cast<U8>(36 + (i & 31)));
+		if ((i & 7) == 0) { stream.push_back(0xF8); }
+		stream.push_back(static_cast<U8>(1 + (i & 127)));
+		if ((i & 63) == 0) { stream.push_back(0xFE); }
+	}
+
+	MidiStream parser;
+	MidiEvent event{};
+	U64 messages = 0;
+
+	Measure("raw_midi/parse/4096_notes", []() {},
+		[&]()
+		{
+			for (U8 byte : stream) { messages += parser.Feed(byte, event); }
+		}, true);
+
+	if (messages == 0) { std::cout << messages; }
+
+#ifdef DV_PLATFORM_LINUX
+	RawMidiReader reader;
+	RawMidiReader::Sink count = [](const MidiEvent&, void*) { received.fetch_add(1, std::memory_order_release); };
+
+	//A FIFO polls and reads like a rawmidi device, so it isolates the reader's own wakeup and parse cost
+	std::string fifo = (folder / "rawmidi.fifo").string();
+	unlink(fifo.c_str());
+	if (mkfifo(fifo.c_str(), 0600) == 0 && reader.Open(fifo, count, nullptr))
+	{
+		RoundTrip("raw_midi/round_trip/fifo", fifo);
+		reader.Close();
+	}
+	unlink(fifo.c_str());
+
+	if (options.virmidiWrite.empty()) { return; }
+
+	//The same hits through the sequencer, read raw off the connected virmidi device and through RtMidi's callback
+	if (reader.Open(options.virmidiRead, count, nullptr))
+	{
+		RoundTrip(reader.HasKernelTimestamps() ? "raw_midi/round_trip/virmidi_framed" : "raw_midi/round_trip/virmidi", options.virmidiWrite);
+		reader.Close();
+	}
+	else { std::cerr << "Can't open " << options.virmidiRead << ", skipping the virmidi round trip" << std::endl; }
+
+#ifdef DV_BENCH_RTMIDI
+	if (options.rtmidiPort.empty()) { return; }
+
+	rt::midi::RtMidiIn input;
+	for (U32 i = 0; i < input.getPortCount(); ++i)
+	{
+		if (input.getPortName(i).find(options.rtmidiPort) == std::string::npos) { continue; }
+
+		input.openPort(i);
+		input.setCallback([](F64, std::vector<U8>*, void*) { received.fetch_add(1, std::memory_order_release); }, nullptr);
+
+		RoundTrip("raw_midi/round_trip/rtmidi", options.virmidiWrite);
+
+		input.cancelCallback();
+		input.closePort();
+		break;
+	}
+#endif
+#endif
+}
+
+void Bench::RoundTrip(const std::string& name, const std::string& writePath)
+{
+#ifdef DV_PLATFORM_LINUX
+	I32 output = open(writePath.c_str(), O_WRONLY | O_CLOEXEC);
+	if (output < 0)
+	{
+		std::cerr << "Can't open " << writePath << " for writing, skipping " << name << std::endl;
+		return;
+	}
+
+	U8 note = 0;
+
+	Measure(name, []() {},
+		[&]()
+		{
+			U8 message[3] = { 0x99, static_cast<U8>(36 + (note++ & 31)), 100 };
+			U64 expected = received.load(std::memory_order_acquire) + 1;
+
+			if (write(output, message, sizeof(message)) != sizeof(message)) { return; }
+
+			//A lost message gives up after a second rather than hanging the run
+			U64 deadline = Time::Now() + 1000000000;
+			while (received.load(std::memory_order_acquire) < expected && Time::Now() < deadline) {}
+		});
+
+	close(output);
+#endif
+}
+
+std::string Bench::SyntheticColors()
+{
+	std::ostringstream output;
+
+	//Clone Hero color files carry every instrument, the drum section is near the end
+	for (U32 i = 0; i < 64; ++i)
+	{
+		output << "[guitar" << i << "]\n";
+		for (U32 j = 0; j < 32; ++j) { output << "note_" << j << " = #" << std::hex << (i * 32 + j) * 4099 % 0xFFFFFF << std::dec << '\n'; }
+	}
+
+	output << "[drums]\n";
+	output << "note_kick = #FF4600\n";
+	output << "cym_blue = #1D63FF\n";
+	output << "cym_yellow = #FFE531\n";
+	output << "cym_green = #0CFF0C\n";
+	output << "tom_blue = #0089FF\n";
+	output << "tom_yellow = #FFFF00\n";
+	output << "tom_red = #FF0000\n";
+	output << "tom_green = #00FF00\n";
+
+	return output.str();
+}
+
+std::string Bench::SyntheticMidiProfile(U32 mappingsPerPad)
+{
+	static const C8* pads[] = { "Red Pad:", "Yellow Pad:", "Blue Pad:", "Green Pad:", "Kick Pad:", "Yellow Cymbal:", "Blue Cymbal:", "Green Cymbal:" };
+
+	std::ostringstream output;
+	output << "Version: 1\nDevice: Bench\n";
+
+	U32 note = 0;
+	for (const C8* pad : pads)
+	{
+		output << pad << '\n';
+		for (U32 i = 0; i < mappingsPerPad; ++i)
+		{
+			output << "- Note: " << (note++ % 64) << "\n  Velocity: 1\n  Overhit: 0.05\n";
+		}
+	}
+
+	output << "Start:\n";
+
+	return output.str();
+}
+
+std::string Bench::SyntheticConfig(U32 paddingLines)
+{
+	std::ostringstream output;
+	output << ConfigFile::Serialize(settings, layout);
+
+	//Unknown keys take the default path through the setting switch
+	for (U32 i = 0; i < paddingLines; ++i) { output << "unusedSetting" << i << '=' << i << '\n'; }
+
+	return output.str();
+}
+
+std::string Bench::SyntheticProfiles(U32 profileCount)
+{
+	std::ostringstream output;
+
+	for (U32 i = 0; i < profileCount; ++i)
+	{
+		output << "[profile" << i << "]\n";
+		output << "player_name = Player " << i << '\n';
+		output << "color_profile_name = Default\n";
+		output << "dynamics_threshold = " << (i % 128) << '\n';
+		output << "lefty_flip = " << (i & 1) << '\n';
+	}
+
+	return output.str();
+}
+
+void Bench::ClearProfiles()
+{
+	profileNames.Clear();
+	profiles.clear();
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options{};
+
+	for (I32 i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--filter" && i + 1 < argc) { options.filter = argv[++i]; }
+		else if (arg == "--json" && i + 1 < argc) { options.jsonPath = argv[++i]; }
+		else if (arg == "--repeats" && i + 1 < argc)
+		{
+			I32 repeats = std::atoi(argv[++i]);
+			options.repeats = repeats > 0 ? static_cast<U32>(repeats) : 1;
+		}
+		else if (arg == "--check-allocations") { options.checkAllocations = true; }
+		else if (arg == "--min-time" && i + 1 < argc) { options.minBatchTime = static_cast<U64>(Time::FromSeconds(std::atof(argv[++i]) / 1000.0)); }
+		else if (arg == "--virmidi" && i + 2 < argc)
+		{
+			options.virmidiWrite = argv[++i];
+			options.virmidiRead = argv[++i];
+		}
+		else if (arg == "--rtmidi-port" && i + 1 < argc) { options.rtmidiPort = argv[++i]; }
+		else
+		{
+			std::cout << "Usage: DrumVisualizerBench [--filter <substring>] [--json <file|->] [--repeats N] [--min-time ms] [--check-allocations]"
+				" [--virmidi <write device> <read device>] [--rtmidi-port <name>]" << std::endl;
+			return arg == "--help" ? 0 : -1;
+		}
+	}
+
+	return Bench::Run(options);
+}
\ No newline at end of file
@@ -81,6 +81,10 @@
 #   error "Unknown compiler"
 #endif
 
+#ifndef RTMIDI_DLL_PUBLIC
+#   define RTMIDI_DLL_PUBLIC
+#endif
+
 #define RTMIDI_VERSION_MAJOR 6
 #define RTMIDI_VERSION_MINOR 0
 #define RTMIDI_VERSION_PATCH 0
@@ -0,0 +1,125 @@
+#include "Allocations.hpp"
+
+#include "FrameArena.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+static thread_local U64 allocationCount = 0;
+static thread_local U64 allocationBytes = 0;
+
+#ifdef DV_COUNT_ALLOCATIONS
+void* operator new(std::size_t size)
+{
+	++allocationCount;
+	allocationBytes += size;
+
+	if (void* ptr = std::malloc(size ? size : 1)) { return ptr; }
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+bool Allocations::checking = false;
+U64 Allocations::frames = 0;
+U64 Allocations::frameStart = 0;
+U64 Allocations::failedFrames = 0;
+U64 Allocations::frameAllocations = 0;
+U64 Allocations::frameOverflowStart = 0;
+U64 Allocations::overflowFrames = 0;
+U64 Allocations::frameOverflows = 0;
+bool Allocations::excludeFrame = false;
+std::atomic<U64> Allocations::events{ 0 };
+std::atomic<U64> Allocations::failedEvents{ 0 };
+std::atomic<U64> Allocations::eventAllocations{ 0 };
+
+U64 Allocations::ThreadCount()
+{
+	return allocationCount;
+}
+
+U64 Allocations::ThreadBytes()
+{
+	return allocationBytes;
+}
+
+void Allocations::StartCheck()
+{
+	if (!Counting)
+	{
+		std::cout << "Allocation checks need a build with DV_COUNT_ALLOCATIONS defined, ignoring" << std::endl;
+		return;
+	}
+
+	checking = true;
+}
+
+void Allocations::CheckEvent()
+{
+	if (!checking) { return; }
+
+	static thread_local U64 threadEvents = 0;
+	static thread_local U64 previousCount = 0;
+
+	U64 count = allocationCount - previousCount;
+	previousCount = allocationCount;
+
+	if (++threadEvents <= WarmupEvents) { return; }
+
+	events.fetch_add(1, std::memory_order_relaxed);
+
+	if (count)
+	{
+		failedEvents.fetch_add(1, std::memory_order_relaxed);
+		eventAllocations.fetch_add(count, std::memory_order_relaxed);
+	}
+}
+
+void Allocations::BeginFrame()
+{
+	frameStart = allocationCount;
+	frameOverflowStart = FrameArena::GetOverflowCount();
+	excludeFrame = false;
+}
+
+void Allocations::EndFrame()
+{
+	if (!checking || excludeFrame || ++frames <= WarmupFrames) { return; }
+
+	U64 count = allocationCount - frameStart;
+
+	if (count)
+	{
+		++failedFrames;
+		frameAllocations += count;
+	}
+
+	//The arena grows at its next reset, so once warmed up a frame that still overflows it is undersized every frame
+	U64 overflows = FrameArena::GetOverflowCount() - frameOverflowStart;
+
+	if (overflows)
+	{
+		++overflowFrames;
+		frameOverflows += overflows;
+	}
+}
+
+bool Allocations::Report()
+{
+	if (!checking) { return true; }
+
+	U64 checkedFrames = frames > WarmupFrames ? frames - WarmupFrames : 0;
+
+	std::cout << "Allocation check: " << failedFrames << '/' << checkedFrames << " frames allocated (" << frameAllocations <<
+		" allocations), " << failedEvents.load() << '/' << events.load() << " MIDI events allocated (" <<
+		eventAllocations.load() << " allocations), " << overflowFrames << '/' << checkedFrames <<
+		" frames overflowed the frame arena (" << frameOverflows << " overflows)" << std::endl;
+
+	return failedFrames == 0 && failedEvents == 0 && overflowFrames == 0;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <atomic>
+
+/// <summary>
+/// Per-thread heap allocation counters. They only count when built with DV_COUNT_ALLOCATIONS, which replaces the
+/// global operator new, otherwise every count reads 0. The check mode asserts the per-event and per-frame paths
+/// stay allocation free once warmed up. The frame arena's heap fallback bypasses operator new, so frames also fail
+/// the check when the arena overflows.
+/// </summary>
+class Allocations
+{
+public:
+#ifdef DV_COUNT_ALLOCATIONS
+	static constexpr bool Counting = true;
+#else
+	static constexpr bool Counting = false;
+#endif
+
+	static U64 ThreadCount();
+	static U64 ThreadBytes();
+
+	static void StartCheck();
+	static bool IsChecking() { return checking; }
+
+	/// <summary>
+	/// Counts the allocations a thread made since its previous event, so the MIDI backend's own work is included
+	/// </summary>
+	static void CheckEvent();
+	static void BeginFrame();
+	static void EndFrame();
+
+	/// <summary>
+	/// Leaves the current frame out of the check, for one-off work like applying a settings change
+	/// </summary>
+	static void ExcludeFrame() { excludeFrame = true; }
+
+	/// <summary>
+	/// Prints the check results
+	/// </summary>
+	/// <returns>True if no steady-state event or frame allocated or overflowed the frame arena</returns>
+	static bool Report();
+
+	static constexpr U32 WarmupFrames = 120;
+	static constexpr U32 WarmupEvents = 16;
+
+private:
+	static bool checking;
+	static U64 frames;
+	static U64 frameStart;
+	static U64 failedFrames;
+	static U64 frameAllocations;
+	static U64 frameOverflowStart;
+	static U64 overflowFrames;
+	static U64 frameOverflows;
+	static bool excludeFrame;
+	static std::atomic<U64> events;
+	static std::atomic<U64> failedEvents;
+	static std::atomic<U64> eventAllocations;
+
+	STATIC_CLASS(Allocations)
+};
\ No newline at end of file
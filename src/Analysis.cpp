@@ -0,0 +1,383 @@
+#include "Analysis.hpp"
+
+#include "CloneHero.hpp"
+#include "Config.hpp"
+#include "Engine.hpp"
+#include "EventSource.hpp"
+#include "Parser.hpp"
+#include "SettingsWriter.hpp"
+#include "StringTable.hpp"
+#include "Time.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+//Indexed like the note stats
+static constexpr const C8* LaneNames[8] = { "snare", "kick", "cymbal1", "tom1", "cymbal2", "tom2", "cymbal3", "tom3" };
+
+//The loaders report to the console, which would end up in the middle of results written to it
+struct NullBuffer : std::streambuf
+{
+	I32 overflow(I32 c) override { return c; }
+};
+
+I32 Analysis::Run(const AnalysisOptions& options)
+{
+	std::vector<std::string> files = CollectInputs(options.inputs);
+	if (files.empty())
+	{
+		std::cout << "No session logs or MIDI files found to analyze" << std::endl;
+		return -1;
+	}
+
+	//Failures are reported once everything is done, in place of what the loaders would print along the way
+	NullBuffer nullBuffer;
+	std::streambuf* console = std::cout.rdbuf(&nullBuffer);
+
+	Settings settings{};
+	std::vector<Mapping> mappings;
+	LoadSetup(options.midiProfile, settings, mappings);
+
+	U32 dynamicThreshold = settings.dynamicThreshold;
+	U16 channels = settings.midiChannels;
+
+	if (mappings.empty()) { std::cerr << "No MIDI profile loaded, no hits will be matched to lanes" << std::endl; }
+
+	U32 threadCount = options.threads ? options.threads : std::thread::hardware_concurrency();
+	if (!threadCount) { threadCount = 1; }
+	if (threadCount > files.size()) { threadCount = static_cast<U32>(files.size()); }
+
+	U64 start = Time::Now();
+
+	std::vector<SessionAnalysis> sessions(files.size());
+	std::atomic<U64> next{ 0 };
+
+	//Files are handed out one at a time, so a few long sessions don't leave the other threads idle
+	auto work = [&]()
+	{
+		for (U64 i = next++; i < files.size(); i = next++) { AnalyzeFile(files[i], mappings, dynamicThreshold, channels, options.window, sessions[i]); }
+	};
+
+	std::vector<std::thread> pool;
+	pool.reserve(threadCount);
+	for (U32 i = 1; i < threadCount; ++i) { pool.emplace_back(work); }
+	work();
+	for (std::thread& thread : pool) { thread.join(); }
+
+	std::cout.rdbuf(console);
+
+	F64 elapsed = Time::ToSeconds(static_cast<I64>(Time::Now() - start));
+
+	U64 failed = 0;
+	for (const SessionAnalysis& session : sessions)
+	{
+		if (!session.loaded)
+		{
+			std::cerr << "Failed To Read: " << session.path << std::endl;
+			++failed;
+		}
+	}
+
+	if (options.outputPath == "-")
+	{
+		if (options.format == AnalysisFormat::Csv) { WriteCsv(std::cout, sessions); }
+		else { WriteJson(std::cout, sessions); }
+	}
+	else
+	{
+		std::ofstream output(options.outputPath);
+		if (!output.is_open())
+		{
+			std::cout << "Failed To Write Analysis: " << options.outputPath << std::endl;
+			return -1;
+		}
+
+		if (options.format == AnalysisFormat::Csv) { WriteCsv(output, sessions); }
+		else { WriteJson(output, sessions); }
+
+		std::cout << "Analyzed " << files.size() - failed << '/' << files.size() << " file(s) in " << elapsed << "s on " <<
+			threadCount << " thread(s), written to: " << options.outputPath << std::endl;
+	}
+
+	return failed ? 1 : 0;
+}
+
+bool Analysis::ParseArgument(I32 argc, C8** argv, I32& index, AnalysisOptions& options)
+{
+	std::string arg = argv[index];
+	if (index + 1 >= argc) { return false; }
+
+	if (arg == "--analyze") { options.inputs.push_back(argv[++index]); }
+	else if (arg == "--format") { options.format = std::string(argv[++index]) == "csv" ? AnalysisFormat::Csv : AnalysisFormat::Json; }
+	else if (arg == "--output") { options.outputPath = argv[++index]; }
+	else if (arg == "--midi-profile") { options.midiProfile = argv[++index]; }
+	else if (arg == "--threads") { options.threads = static_cast<U32>(std::atoi(argv[++index])); }
+	else if (arg == "--window") { options.window = std::atof(argv[++index]); }
+	else { return false; }
+
+	return true;
+}
+
+void Analysis::LoadSetup(const std::string& midiProfile, Settings& settings, std::vector<Mapping>& mappings)
+{
+	NoteLayout layout{};
+	ConfigFile::Load(ConfigFile::Read(SettingsWriter::Path), settings, layout);
+	if (!midiProfile.empty()) { settings.midiProfileName = midiProfile; }
+
+	std::filesystem::path folder = CloneHero::GetFolder();
+
+	//The Clone Hero player sets the ghost note threshold, as it does in the visualizer
+	std::vector<Profile> profiles;
+	StringTable profileNames;
+	CloneHero::LoadProfiles(folder, profiles, profileNames);
+
+	if (profiles.front().id != U32_MAX)
+	{
+		if (settings.profileId >= profiles.size()) { settings.profileId = 0; }
+		settings.dynamicThreshold = profiles[settings.profileId].dynamicThreshold;
+	}
+
+	if (CloneHero::LoadMidiProfile(CloneHero::MidiProfilePath(folder, settings.midiProfileName), mappings)) { return; }
+
+	StringTable midiProfileNames;
+	CloneHero::LoadMidiProfiles(folder, midiProfileNames);
+
+	for (const C8* profile : midiProfileNames)
+	{
+		if (CloneHero::LoadMidiProfile(CloneHero::MidiProfilePath(folder, profile), mappings)) { return; }
+	}
+}
+
+void Analysis::AnalyzeFile(const std::string& path, std::vector<Mapping> mappings, U32 dynamicThreshold, U16 channels, F64 window,
+	SessionAnalysis& result)
+{
+	result.path = path;
+
+	EventSource* source = EventSource::Create(path);
+	if (!source) { return; }
+
+	const std::vector<MidiEvent>& events = source->GetEvents();
+	const std::vector<SettingEvent>& settings = source->GetSettings();
+
+	result.loaded = true;
+	result.events = events.size();
+	result.duration = Time::ToSeconds(static_cast<I64>(source->GetDuration()));
+
+	std::vector<F64> onsets;
+	onsets.reserve(events.size());
+
+	U64 nextSetting = 0;
+
+	MidiDispatch dispatch;
+	dispatch.SetChannels(channels);
+
+	for (const MidiEvent& event : events)
+	{
+		//Threshold changes made while recording count from the point they were made, like in a replay
+		while (nextSetting < settings.size() && settings[nextSetting].time <= event.time)
+		{
+			const SettingEvent& setting = settings[nextSetting++];
+			if (setting.key == "dynamicThreshold") { dynamicThreshold = static_cast<U32>(Parser::ToI32(setting.value, static_cast<I32>(dynamicThreshold))); }
+			else if (setting.key == "midiChannels") { dispatch.SetChannels(ConfigFile::ParseChannels(setting.value)); }
+		}
+
+		if (dispatch.Classify(event) != MidiMessage::NoteOn) { continue; }
+
+		const Mapping* mapping = Engine::MatchEvent(mappings, event);
+		if (!mapping) { continue; }
+
+		U8 velocity = event.bytes[2];
+
+		LaneAnalysis& lane = result.lanes[static_cast<U32>(mapping->type)];
+		++lane.hits;
+		if (velocity < dynamicThreshold) { ++lane.ghosts; }
+		lane.velocitySum += velocity;
+		++lane.velocities[velocity > 127 ? 15 : velocity >> 3];
+
+		F64 time = Time::ToSeconds(static_cast<I64>(event.time));
+		if (onsets.empty() || time - onsets.back() > OnsetMerge) { onsets.push_back(time); }
+	}
+
+	delete source;
+
+	TempoCurve(onsets, result.duration, window, result.tempo);
+}
+
+void Analysis::TempoCurve(const std::vector<F64>& onsets, F64 duration, F64 window, std::vector<TempoPoint>& tempo)
+{
+	if (window <= 0.0 || duration <= 0.0) { return; }
+
+	std::vector<F64> intervals;
+	U64 first = 0;
+
+	for (U64 index = 0; index * window < duration; ++index)
+	{
+		F64 start = index * window;
+		F64 end = start + window < duration ? start + window : duration;
+
+		while (first < onsets.size() && onsets[first] < start) { ++first; }
+
+		intervals.clear();
+		U64 count = 0;
+
+		for (U64 i = first; i < onsets.size() && onsets[i] < end; ++i)
+		{
+			++count;
+			if (i > first) { intervals.push_back(onsets[i] - onsets[i - 1]); }
+		}
+
+		//The median interval is taken as a beat subdivision, then folded into a readable range by octaves
+		F64 bpm = 0.0;
+		if (intervals.size() >= MinIntervals)
+		{
+			std::nth_element(intervals.begin(), intervals.begin() + intervals.size() / 2, intervals.end());
+			F64 median = intervals[intervals.size() / 2];
+
+			if (median > 0.0)
+			{
+				bpm = 60.0 / median;
+				while (bpm < MinBpm) { bpm *= 2.0; }
+				while (bpm > MaxBpm) { bpm *= 0.5; }
+			}
+		}
+
+		tempo.push_back({ (start + end) * 0.5, bpm, count / (end - start) });
+	}
+}
+
+void Analysis::WriteJson(std::ostream& output, const std::vector<SessionAnalysis>& sessions)
+{
+	output << "{\n\t\"sessions\": [";
+
+	for (U64 i = 0; i < sessions.size(); ++i)
+	{
+		const SessionAnalysis& session = sessions[i];
+
+		output << (i ? ",\n" : "\n") << "\t\t{\n\t\t\t\"path\": \"" << Escape(session.path) << "\",\n\t\t\t\"loaded\": " <<
+			(session.loaded ? "true" : "false") << ",\n\t\t\t\"events\": " << session.events << ",\n\t\t\t\"duration\": " <<
+			session.duration << ",\n\t\t\t\"lanes\": [";
+
+		for (U32 lane = 0; lane < 8; ++lane)
+		{
+			const LaneAnalysis& stats = session.lanes[lane];
+			F64 meanVelocity = stats.hits ? static_cast<F64>(stats.velocitySum) / stats.hits : 0.0;
+
+			output << (lane ? ",\n" : "\n") << "\t\t\t\t{ \"lane\": \"" << LaneNames[lane] << "\", \"hits\": " << stats.hits <<
+				", \"ghosts\": " << stats.ghosts << ", \"mean_velocity\": " << meanVelocity << ", \"velocity_histogram\": [";
+
+			for (U32 bucket = 0; bucket < stats.velocities.size(); ++bucket) { output << (bucket ? ", " : "") << stats.velocities[bucket]; }
+
+			output << "] }";
+		}
+
+		output << "\n\t\t\t],\n\t\t\t\"tempo\": [";
+
+		for (U64 point = 0; point < session.tempo.size(); ++point)
+		{
+			const TempoPoint& tempo = session.tempo[point];
+
+			output << (point ? ",\n" : "\n") << "\t\t\t\t{ \"time\": " << tempo.time << ", \"bpm\": " << tempo.bpm <<
+				", \"hits_per_second\": " << tempo.hitsPerSecond << " }";
+		}
+
+		output << (session.tempo.empty() ? "]\n\t\t}" : "\n\t\t\t]\n\t\t}");
+	}
+
+	output << "\n\t]\n}\n";
+}
+
+void Analysis::WriteCsv(std::ostream& output, const std::vector<SessionAnalysis>& sessions)
+{
+	//Long form, one value per row, so every table of every session fits under one header
+	output << "path,metric,lane,index,value\n";
+
+	for (const SessionAnalysis& session : sessions)
+	{
+		if (!session.loaded) { continue; }
+
+		std::string path = "\"";
+		for (C8 c : session.path)
+		{
+			if (c == '"') { path.push_back('"'); }
+			path.push_back(c);
+		}
+		path.push_back('"');
+
+		output << path << ",events,,," << session.events << '\n';
+		output << path << ",duration,,," << session.duration << '\n';
+
+		for (U32 lane = 0; lane < 8; ++lane)
+		{
+			const LaneAnalysis& stats = session.lanes[lane];
+			F64 meanVelocity = stats.hits ? static_cast<F64>(stats.velocitySum) / stats.hits : 0.0;
+
+			output << path << ",hits," << LaneNames[lane] << ",," << stats.hits << '\n';
+			output << path << ",ghosts," << LaneNames[lane] << ",," << stats.ghosts << '\n';
+			output << path << ",mean_velocity," << LaneNames[lane] << ",," << meanVelocity << '\n';
+
+			for (U32 bucket = 0; bucket < stats.velocities.size(); ++bucket)
+			{
+				output << path << ",velocity_histogram," << LaneNames[lane] << ',' << bucket << ',' << stats.velocities[bucket] << '\n';
+			}
+		}
+
+		for (U64 point = 0; point < session.tempo.size(); ++point)
+		{
+			const TempoPoint& tempo = session.tempo[point];
+
+			output << path << ",time,," << point << ',' << tempo.time << '\n';
+			output << path << ",bpm,," << point << ',' << tempo.bpm << '\n';
+			output << path << ",hits_per_second,," << point << ',' << tempo.hitsPerSecond << '\n';
+		}
+	}
+}
+
+std::vector<std::string> Analysis::CollectInputs(const std::vector<std::string>& inputs)
+{
+	std::vector<std::string> files;
+
+	for (const std::string& input : inputs)
+	{
+		std::error_code error;
+		if (!std::filesystem::is_directory(input, error))
+		{
+			files.push_back(input);
+			continue;
+		}
+
+		U64 first = files.size();
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(input, error))
+		{
+			std::string extension = entry.path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](C8 c) { return static_cast<C8>(std::tolower(static_cast<U8>(c))); });
+
+			if (extension == ".dvs" || extension == ".mid" || extension == ".midi") { files.push_back(entry.path().string()); }
+		}
+
+		//Session names start with their date, so sorting puts a folder's sessions in the order they were played
+		std::sort(files.begin() + first, files.end());
+	}
+
+	return files;
+}
+
+std::string Analysis::Escape(const std::string& text)
+{
+	std::string escaped;
+	escaped.reserve(text.size());
+
+	for (C8 c : text)
+	{
+		if (c == '"' || c == '\\') { escaped.push_back('\\'); }
+		escaped.push_back(c);
+	}
+
+	return escaped;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <array>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+struct Mapping;
+struct Settings;
+
+enum class AnalysisFormat
+{
+	Json,
+	Csv
+};
+
+struct AnalysisOptions
+{
+	std::vector<std::string> inputs{};	//Session logs, .mid files or folders searched for both
+	std::string outputPath{ "-" };		//- writes to the console
+	AnalysisFormat format{ AnalysisFormat::Json };
+	std::string midiProfile{};			//Empty uses the profile saved in settings.cfg
+	U32 threads{ 0 };					//0 uses every core
+	F64 window{ 10.0 };					//Seconds covered by each point of the tempo curve
+};
+
+struct LaneAnalysis
+{
+	U32 hits{ 0 };
+	U32 ghosts{ 0 };
+	U64 velocitySum{ 0 };
+	std::array<U32, 16> velocities{};	//Hits per 8 velocity steps
+};
+
+struct TempoPoint
+{
+	F64 time;			//Seconds from the start of the session to the middle of the window
+	F64 bpm;			//0 when the window has too few hits to tell
+	F64 hitsPerSecond;	//Hits landing together count once
+};
+
+struct SessionAnalysis
+{
+	std::string path;
+	bool loaded{ false };
+	U64 events{ 0 };
+	F64 duration{ 0.0 };
+	std::array<LaneAnalysis, 8> lanes{};	//Indexed like the note stats
+	std::vector<TempoPoint> tempo;
+};
+
+/// <summary>
+/// Headless batch analysis of recorded sessions, runs every file through the same MIDI to lane matching as the
+/// visualizer and reports per-lane stats, velocity histograms and tempo curves. Files are spread over a pool of
+/// threads, each with its own copy of the mappings, so results don't depend on the thread count. Only needs the core
+/// library, settings and mappings are loaded into locals rather than the visualizer's.
+/// </summary>
+class Analysis
+{
+public:
+	/// <summary>
+	/// Runs the --analyze command line mode, never initializes GLFW, GL or ImGui
+	/// </summary>
+	/// <returns>The process exit code</returns>
+	static I32 Run(const AnalysisOptions& options);
+
+	/// <summary>
+	/// Reads an analysis option off the command line
+	/// </summary>
+	/// <param name="index:">The argument to read, moved past any value it takes</param>
+	/// <returns>False if the argument isn't an analysis option</returns>
+	static bool ParseArgument(I32 argc, C8** argv, I32& index, AnalysisOptions& options);
+
+	/// <summary>
+	/// Analyzes one recorded session or MIDI file
+	/// </summary>
+	/// <param name="mappings:">Taken by copy, matching updates each mapping's last hit time</param>
+	/// <param name="dynamicThreshold:">Velocity below which a hit counts as a ghost note, until the session changes it</param>
+	/// <param name="channels:">Channels hits are read on, until the session changes them</param>
+	static void AnalyzeFile(const std::string& path, std::vector<Mapping> mappings, U32 dynamicThreshold, U16 channels, F64 window,
+		SessionAnalysis& result);
+
+	static void WriteJson(std::ostream& output, const std::vector<SessionAnalysis>& sessions);
+	static void WriteCsv(std::ostream& output, const std::vector<SessionAnalysis>& sessions);
+
+	static constexpr F64 MinBpm = 60.0;			//Tempo estimates are folded by octaves into MinBpm to MaxBpm
+	static constexpr F64 MaxBpm = 200.0;
+	static constexpr F64 OnsetMerge = 0.03;		//Seconds within which hits on different lanes count as one onset
+	static constexpr U32 MinIntervals = 4;		//Onset intervals a window needs for a tempo estimate
+
+private:
+	/// <summary>
+	/// Loads settings.cfg and the MIDI profile it names the way the visualizer does, falling back to the first
+	/// profile that loads if it's missing
+	/// </summary>
+	/// <param name="midiProfile:">Overrides the saved MIDI profile when not empty</param>
+	static void LoadSetup(const std::string& midiProfile, Settings& settings, std::vector<Mapping>& mappings);
+
+	static std::vector<std::string> CollectInputs(const std::vector<std::string>& inputs);
+	static void TempoCurve(const std::vector<F64>& onsets, F64 duration, F64 window, std::vector<TempoPoint>& tempo);
+	static std::string Escape(const std::string& text);
+
+	STATIC_CLASS(Analysis)
+};
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "AssetPack.hpp"
+
+#include <iostream>
+
+#ifndef DV_PLATFORM_WINDOWS
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+bool AssetPack::Open(const std::string& path)
+{
+	Close();
+
+#ifdef DV_PLATFORM_WINDOWS
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		file = nullptr;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(PackHeader))
+	{
+		Close();
+		return false;
+	}
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		Close();
+		return false;
+	}
+
+	base = static_cast<const U8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	size = static_cast<U64>(fileSize.QuadPart);
+#else
+	I32 descriptor = open(path.c_str(), O_RDONLY);
+	if (descriptor < 0) { return false; }
+
+	struct stat info;
+	if (fstat(descriptor, &info) != 0 || info.st_size < (off_t)sizeof(PackHeader))
+	{
+		close(descriptor);
+		return false;
+	}
+
+	void* view = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	close(descriptor);
+
+	base = view == MAP_FAILED ? nullptr : static_cast<const U8*>(view);
+	size = static_cast<U64>(info.st_size);
+#endif
+
+	if (!base)
+	{
+		Close();
+		return false;
+	}
+
+	//Everything is validated up front, after this entries and their data are trusted
+	const PackHeader* header = reinterpret_cast<const PackHeader*>(base);
+	U64 indexEnd = sizeof(PackHeader) + static_cast<U64>(header->entryCount) * sizeof(PackEntry);
+
+	if (header->magic != Magic || header->version != Version || header->fileSize != size || indexEnd + header->namesSize > size)
+	{
+		std::cout << "Invalid Asset Pack, Ignoring: " << path << std::endl;
+		Close();
+		return false;
+	}
+
+	entries = reinterpret_cast<const PackEntry*>(base + sizeof(PackHeader));
+	entryCount = header->entryCount;
+
+	const C8* nameData = reinterpret_cast<const C8*>(base + indexEnd);
+
+	for (const PackEntry& entry : *this)
+	{
+		bool valid = static_cast<U64>(entry.nameOffset) + entry.nameLength <= header->namesSize &&
+			entry.offset >= indexEnd + header->namesSize && entry.offset <= size && entry.size <= size - entry.offset;
+
+		if (valid && entry.type == PackEntryType::Texture)
+		{
+			valid = entry.format >= PackFormat::RGBA8 && entry.format <= PackFormat::BC3 && entry.width && entry.height && entry.levels &&
+				entry.levels <= LevelCount(entry.width, entry.height) && entry.size == TextureSize(entry.format, entry.width, entry.height, entry.levels);
+		}
+
+		if (!valid)
+		{
+			std::cout << "Invalid Asset Pack Entry, Ignoring Pack: " << path << std::endl;
+			Close();
+			return false;
+		}
+
+		names.Add(std::string_view(nameData + entry.nameOffset, entry.nameLength));
+	}
+
+	return true;
+}
+
+void AssetPack::Close()
+{
+#ifdef DV_PLATFORM_WINDOWS
+	if (base) { UnmapViewOfFile(base); }
+	if (mapping) { CloseHandle(mapping); }
+	if (file) { CloseHandle(file); }
+
+	mapping = nullptr;
+	file = nullptr;
+#else
+	if (base) { munmap(const_cast<U8*>(base), size); }
+#endif
+
+	base = nullptr;
+	size = 0;
+	entries = nullptr;
+	entryCount = 0;
+	names.Clear();
+}
+
+const PackEntry* AssetPack::Find(std::string_view name) const
+{
+	U32 id = names.Find(name);
+	return id == U32_MAX ? nullptr : entries + id;
+}
+
+U32 AssetPack::LevelCount(U32 width, U32 height)
+{
+	U32 largest = width > height ? width : height;
+	U32 levels = 1;
+	while (largest >>= 1) { ++levels; }
+
+	return levels;
+}
+
+U64 AssetPack::RowBytes(PackFormat format, U32 width)
+{
+	switch (format)
+	{
+	case PackFormat::RGBA8: return static_cast<U64>(width) * 4;
+	case PackFormat::BC1: return static_cast<U64>((width + 3) / 4) * 8;
+	case PackFormat::BC3: return static_cast<U64>((width + 3) / 4) * 16;
+	default: return 0;
+	}
+}
+
+U64 AssetPack::LevelBytes(PackFormat format, U32 width, U32 height, U32 level)
+{
+	U32 rowHeight = RowHeight(format);
+	U32 rows = (LevelSize(height, level) + rowHeight - 1) / rowHeight;
+
+	return RowBytes(format, LevelSize(width, level)) * rows;
+}
+
+U64 AssetPack::TextureSize(PackFormat format, U32 width, U32 height, U32 levels)
+{
+	U64 total = 0;
+	for (U32 level = 0; level < levels; ++level) { total += LevelBytes(format, width, height, level); }
+
+	return total;
+}
+
+void AssetPack::Downsample(const U8* source, U32 width, U32 height, U8* destination)
+{
+	U32 levelWidth = LevelSize(width, 1);
+	U32 levelHeight = LevelSize(height, 1);
+
+	for (U32 y = 0; y < levelHeight; ++y)
+	{
+		//Odd sizes clamp to the last row or column
+		U32 y0 = y * 2 < height ? y * 2 : height - 1;
+		U32 y1 = y * 2 + 1 < height ? y * 2 + 1 : height - 1;
+
+		for (U32 x = 0; x < levelWidth; ++x)
+		{
+			U32 x0 = x * 2 < width ? x * 2 : width - 1;
+			U32 x1 = x * 2 + 1 < width ? x * 2 + 1 : width - 1;
+
+			const U8* a = source + (static_cast<U64>(y0) * width + x0) * 4;
+			const U8* b = source + (static_cast<U64>(y0) * width + x1) * 4;
+			const U8* c = source + (static_cast<U64>(y1) * width + x0) * 4;
+			const U8* d = source + (static_cast<U64>(y1) * width + x1) * 4;
+			U8* out = destination + (static_cast<U64>(y) * levelWidth + x) * 4;
+
+			U32 alpha = a[3] + b[3] + c[3] + d[3];
+			out[3] = static_cast<U8>((alpha + 2) / 4);
+
+			for (U32 channel = 0; channel < 3; ++channel)
+			{
+				if (alpha == 0) { out[channel] = static_cast<U8>((a[channel] + b[channel] + c[channel] + d[channel] + 2) / 4); }
+				else
+				{
+					U32 sum = a[channel] * a[3] + b[channel] * b[3] + c[channel] * c[3] + d[channel] * d[3];
+					out[channel] = static_cast<U8>((sum + alpha / 2) / alpha);
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include "StringTable.hpp"
+
+#include <string>
+#include <string_view>
+
+enum class PackEntryType : U32
+{
+	Texture,	//Pre-decoded pixels, every mip level back to back starting with the largest
+	Text		//Raw file contents, shader sources and the like
+};
+
+enum class PackFormat : U32
+{
+	None,		//Not a texture
+	RGBA8,
+	BC1,		//4x4 blocks of 8 bytes, opaque
+	BC3			//4x4 blocks of 16 bytes, BC1 color plus interpolated alpha
+};
+
+struct PackHeader
+{
+	U32 magic;
+	U32 version;
+	U32 entryCount;
+	U32 namesSize;
+	U64 fileSize;
+};
+
+struct PackEntry
+{
+	PackEntryType type;
+	PackFormat format;
+	U32 nameOffset;
+	U32 nameLength;
+	U32 width;
+	U32 height;
+	U32 levels;
+	U32 reserved;
+	U64 offset;
+	U64 size;
+};
+
+/// <summary>
+/// Read-only view of a prebuilt asset pack. The file is memory mapped and never copied, entry data is handed out
+/// as pointers straight into the mapping. Layout: PackHeader, PackEntry[entryCount], the entry names, then each
+/// entry's data aligned to DataAlignment.
+/// </summary>
+class AssetPack
+{
+public:
+	bool Open(const std::string& path);
+	void Close();
+	bool IsOpen() const { return base != nullptr; }
+
+	/// <summary>
+	/// Looks up an entry by file name, extension included
+	/// </summary>
+	/// <returns>The entry, nullptr if the pack doesn't have it</returns>
+	const PackEntry* Find(std::string_view name) const;
+	const U8* Data(const PackEntry& entry) const { return base + entry.offset; }
+	std::string_view Name(const PackEntry& entry) const { return names[static_cast<U32>(&entry - entries)]; }
+
+	const PackEntry* begin() const { return entries; }
+	const PackEntry* end() const { return entries + entryCount; }
+
+	static U32 LevelCount(U32 width, U32 height);
+	static U32 LevelSize(U32 size, U32 level) { return size >> level ? size >> level : 1; }
+
+	/// <summary>
+	/// Gets the pixel rows covered by one row of data, 4 for block compressed formats
+	/// </summary>
+	static U32 RowHeight(PackFormat format) { return format == PackFormat::RGBA8 ? 1 : 4; }
+
+	/// <summary>
+	/// Gets the bytes in one row of data, a row of blocks for block compressed formats
+	/// </summary>
+	static U64 RowBytes(PackFormat format, U32 width);
+	static U64 LevelBytes(PackFormat format, U32 width, U32 height, U32 level);
+
+	/// <summary>
+	/// Gets the bytes of every level of a texture together
+	/// </summary>
+	static U64 TextureSize(PackFormat format, U32 width, U32 height, U32 levels);
+
+	/// <summary>
+	/// Box filters an RGBA8 image down to the next mip level, weighting color by alpha so transparent texels
+	/// don't darken the edges
+	/// </summary>
+	static void Downsample(const U8* source, U32 width, U32 height, U8* destination);
+
+	static constexpr const C8* DefaultPath = "assets.dvpack";
+	static constexpr U32 Magic = 'D' | ('V' << 8) | ('P' << 16) | ('K' << 24);
+	static constexpr U32 Version = 1;
+	static constexpr U64 DataAlignment = 64;
+	static constexpr U32 MaxLevels = 16;
+
+private:
+	const U8* base{ nullptr };
+	U64 size{ 0 };
+	const PackEntry* entries{ nullptr };
+	U32 entryCount{ 0 };
+	StringTable names;		//Ids match entry indices
+#ifdef DV_PLATFORM_WINDOWS
+	void* file{ nullptr };
+	void* mapping{ nullptr };
+#endif
+};
\ No newline at end of file
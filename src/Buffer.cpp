@@ -2,11 +2,25 @@
 
 #include "GraphicsInclude.hpp"
 
+static void AttributePointer(U32 location, DataType type, U64 offset)
+{
+	const void* pointer = reinterpret_cast<const void*>(offset);
+
+	switch (type)
+	{
+	case DataType::INT: { glVertexAttribIPointer(location, 1, GL_INT, 0, pointer); } break;
+	case DataType::UINT: { glVertexAttribIPointer(location, 1, GL_UNSIGNED_INT, 0, pointer); } break;
+	case DataType::FLOAT: { glVertexAttribPointer(location, 1, GL_FLOAT, GL_FALSE, 0, pointer); } break;
+	case DataType::VECTOR2: { glVertexAttribPointer(location, 2, GL_FLOAT, GL_FALSE, 0, pointer); } break;
+	case DataType::VECTOR3: { glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, 0, pointer); } break;
+	case DataType::VECTOR4: { glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, 0, pointer); } break;
+	}
+}
+
 void Buffer::Create(U32 location, DataType type, void* data, U64 size, bool instance)
 {
 	this->location = location;
 	this->type = type;
-	this->data = data;
 	this->size = size;
 	this->instance = instance;
 
@@ -15,15 +29,17 @@ void Buffer::Create(U32 location, DataType type, void* data, U64 size, bool inst
 	glBufferData(GL_ARRAY_BUFFER, size, data, instance ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
 	glEnableVertexAttribArray(location);
 
-	switch (type)
-	{
-	case DataType::INT: { glVertexAttribIPointer(location, 1, GL_INT, 0, 0); } break;
-	case DataType::UINT: { glVertexAttribIPointer(location, 1, GL_UNSIGNED_INT, 0, 0); } break;
-	case DataType::FLOAT: { glVertexAttribPointer(location, 1, GL_FLOAT, GL_FALSE, 0, 0); } break;
-	case DataType::VECTOR2: { glVertexAttribPointer(location, 2, GL_FLOAT, GL_FALSE, 0, 0); } break;
-	case DataType::VECTOR3: { glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, 0, 0); } break;
-	case DataType::VECTOR4: { glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, 0, 0); } break;
-	}
+	AttributePointer(location, type, 0);
+
+	glVertexAttribDivisor(location, instance);
+}
+
+void Buffer::AddAttribute(U32 location, DataType type, U64 offset)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, id);
+	glEnableVertexAttribArray(location);
+
+	AttributePointer(location, type, offset);
 
 	glVertexAttribDivisor(location, instance);
 }
@@ -35,7 +51,6 @@ void Buffer::Destroy()
 
 void Buffer::Flush(void* data, U64 size)
 {
-	this->data = data;
 	this->size = size;
 
 	glBindBuffer(GL_ARRAY_BUFFER, id);
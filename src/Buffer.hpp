@@ -15,15 +15,25 @@ enum class DataType
 struct Buffer
 {
 	void Create(U32 location, DataType type, void* data, U64 size, bool instance);
+
+	/// <summary>
+	/// Binds another attribute to this buffer, for attributes packed back to back into one buffer
+	/// </summary>
+	/// <param name="location:">The shader location of the attribute</param>
+	/// <param name="type:">The type of the attribute</param>
+	/// <param name="offset:">The byte offset of the attribute's first element</param>
+	void AddAttribute(U32 location, DataType type, U64 offset);
 	void Destroy();
 
+	/// <summary>
+	/// Replaces the buffer's contents, glBufferData copies them before returning so data can be freed right after
+	/// </summary>
 	void Flush(void* data, U64 size);
 
 private:
 	U32 id{ U32_MAX };
 	U32 location;
 	DataType type;
-	void* data;
 	U64 size;
 	bool instance;
 };
\ No newline at end of file
@@ -0,0 +1,327 @@
+#include "CloneHero.hpp"
+
+#include "Parser.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+#ifdef DV_PLATFORM_WINDOWS
+#include "shlobj_core.h"
+#include <objbase.h>
+
+#include <codecvt>
+#include <locale>
+#else
+#include <dirent.h>
+#endif
+
+std::filesystem::path CloneHero::GetFolder()
+{
+#ifdef DV_PLATFORM_WINDOWS
+	PWSTR path = nullptr;
+	SHGetKnownFolderPath(FOLDERID_Documents, 0, nullptr, &path);
+
+	std::filesystem::path folder = std::filesystem::path(path) / "Clone Hero";
+	CoTaskMemFree(path);
+#else
+	//The shell expands ~, paths handed to the filesystem have to spell out the home folder
+	const C8* home = std::getenv("HOME");
+	std::filesystem::path folder(home ? home : ".");
+
+#ifdef DV_PLATFORM_MAC
+	folder /= "Clone Hero";
+#else
+	folder /= ".clonehero";
+#endif
+#endif
+
+#ifdef DV_DEBUG
+	std::cout << "Found Clone Hero path: '" << ToUtf8(folder) << "'" << std::endl;
+#endif
+
+	return folder;
+}
+
+std::filesystem::path CloneHero::ColorProfilePath(const std::filesystem::path& folder, std::string_view name)
+{
+	std::filesystem::path path = folder / "Custom" / "Colors" / FromUtf8(name);
+	path += ".ini";
+	return path;
+}
+
+std::filesystem::path CloneHero::MidiProfilePath(const std::filesystem::path& folder, std::string_view name)
+{
+	std::filesystem::path path = folder / "MIDI Profiles" / FromUtf8(name);
+	path += ".yaml";
+	return path;
+}
+
+std::filesystem::path CloneHero::FromUtf8(std::string_view name)
+{
+#ifdef DV_PLATFORM_WINDOWS
+	//Narrow paths are read in the ANSI code page on Windows
+	std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+	return std::filesystem::path(converter.from_bytes(name.data(), name.data() + name.size()));
+#else
+	return std::filesystem::path(std::string(name));
+#endif
+}
+
+std::string CloneHero::ToUtf8(const std::filesystem::path& path)
+{
+#ifdef DV_PLATFORM_WINDOWS
+	std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+	return converter.to_bytes(path.native());
+#else
+	return path.native();
+#endif
+}
+
+void CloneHero::LoadProfiles(const std::filesystem::path& folder, std::vector<Profile>& loaded, StringTable& names)
+{
+#ifdef DV_DEBUG
+	std::cout << "Loading Profiles..." << std::endl;
+#endif
+	loaded.clear();
+	names.Clear();
+
+	std::string data = ConfigFile::Read(folder / "profiles.ini");
+
+	if (data.empty())
+	{
+		std::cout << "Failed to open profiles.ini, using default profile" << std::endl;
+		loaded.push_back({ U32_MAX, "Guest", "DefaultColors", 100, false });
+		return;
+	}
+
+	//One profile per section, counting them is a memchr-speed scan next to parsing
+	loaded.reserve(std::count(data.begin(), data.end(), '['));
+
+	IniReader reader(data);
+	IniLine line;
+
+	//Every section is a profile, keys can come in any order
+	while (reader.Next(line))
+	{
+		if (line.type == IniLineType::Section)
+		{
+			Profile profile{};
+			profile.id = (U32)loaded.size();
+			loaded.push_back(profile);
+			continue;
+		}
+
+		if (loaded.empty()) { continue; }
+
+		Profile& profile = loaded.back();
+
+		switch (Hash(line.name.data(), line.name.size()))
+		{
+		case "player_name"_Hash: { profile.name = line.value; } break;
+		case "color_profile_name"_Hash: { profile.colorProfile = line.value; } break;
+		case "dynamics_threshold"_Hash: { profile.dynamicThreshold = Parser::ToI32(line.value, 100); } break;
+		case "lefty_flip"_Hash: { profile.leftyFlip = line.value == "1"; } break;
+		default: break;
+		}
+	}
+
+	if (loaded.empty())
+	{
+		std::cout << "No profiles in profiles.ini, using default profile" << std::endl;
+		loaded.push_back({ U32_MAX, "Guest", "DefaultColors", 100, false });
+		return;
+	}
+
+	//Ids double as indices into profiles, so players sharing a name each get their own
+	for (const Profile& profile : loaded) { names.Add(profile.name); }
+}
+
+void CloneHero::LoadColorProfiles(const std::filesystem::path& folder, StringTable& names)
+{
+	names.Clear();
+
+	ListStems(folder / "Custom" / "Colors", ".ini", names);
+}
+
+void CloneHero::LoadMidiProfiles(const std::filesystem::path& folder, StringTable& names)
+{
+	names.Clear();
+
+	ListStems(folder / "MIDI Profiles", ".yaml", names);
+}
+
+void CloneHero::ListStems(const std::filesystem::path& folder, std::string_view extension, StringTable& names)
+{
+#ifdef DV_PLATFORM_WINDOWS
+	std::error_code error;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(folder, error))
+	{
+		const std::filesystem::path& path = entry.path();
+
+		if (path.extension() == extension)
+		{
+			names.Intern(path.stem().string());
+		}
+	}
+#else
+	//directory_iterator builds a path per entry, several allocations each, readdir hands back the name in place
+	DIR* directory = opendir(folder.c_str());
+	if (directory == nullptr) { return; }
+
+	while (dirent* entry = readdir(directory))
+	{
+		std::string_view name = entry->d_name;
+
+		//A file named just the extension is hidden, not one with the extension
+		if (name.size() > extension.size() && name.ends_with(extension))
+		{
+			names.Intern(name.substr(0, name.size() - extension.size()));
+		}
+	}
+
+	closedir(directory);
+#endif
+}
+
+bool CloneHero::LoadColors(const std::filesystem::path& path, ColorProfile& colors)
+{
+#ifdef DV_DEBUG
+	std::cout << "Loading Profile Colors..." << std::endl;
+#endif
+	std::string data = ConfigFile::Read(path);
+
+	if (data.empty())
+	{
+		std::cout << "Failed to open profile colors, using default colors" << std::endl;
+		return false;
+	}
+
+	IniReader reader(data);
+	IniLine line;
+	bool drums = false;
+
+	while (reader.Next(line))
+	{
+		if (line.type == IniLineType::Section)
+		{
+			drums = line.name == "drums";
+			continue;
+		}
+
+		if (!drums) { continue; }
+
+		switch (Hash(line.name.data(), line.name.size()))
+		{
+		case "note_kick"_Hash: { colors.kickColor = HexToRBG(line.value); } break;
+		case "cym_yellow"_Hash: { colors.cymbal1Color = HexToRBG(line.value); } break;
+		case "cym_blue"_Hash: { colors.cymbal2Color = HexToRBG(line.value); } break;
+		case "cym_green"_Hash: { colors.cymbal3Color = HexToRBG(line.value); } break;
+		case "tom_red"_Hash: { colors.snareColor = HexToRBG(line.value); } break;
+		case "tom_yellow"_Hash: { colors.tom1Color = HexToRBG(line.value); } break;
+		case "tom_blue"_Hash: { colors.tom2Color = HexToRBG(line.value); } break;
+		case "tom_green"_Hash: { colors.tom3Color = HexToRBG(line.value); } break;
+		default: break;
+		}
+	}
+
+	return true;
+}
+
+Vector3 CloneHero::HexToRBG(std::string_view hex)
+{
+	static constexpr U64 RMask = 0xFF0000;
+	static constexpr U64 GMask = 0x00FF00;
+	static constexpr U64 BMask = 0x0000FF;
+
+	if (!hex.empty() && hex[0] == '#') { hex.remove_prefix(1); }
+
+	U64 rgb = Parser::ToU64(hex, 16, 0);
+
+	return { ((rgb & RMask) >> 16) / 255.0f, ((rgb & GMask) >> 8) / 255.0f,
+			(rgb & BMask) / 255.0f };
+}
+
+bool CloneHero::LoadMidiProfile(const std::filesystem::path& path, std::vector<Mapping>& loaded)
+{
+	std::string data = ConfigFile::Read(path);
+
+	if (data.empty())
+	{
+		std::cout << "Failed to open MIDI profile " << ToUtf8(path) << std::endl;
+		return false;
+	}
+
+	ParseMidiProfile(data, loaded);
+
+	std::cout << "Succesfully opened MIDI profile " << ToUtf8(path) << std::endl;
+
+	return true;
+}
+
+void CloneHero::ParseMidiProfile(std::string_view data, std::vector<Mapping>& loaded)
+{
+	loaded.clear();
+
+	YamlReader reader(data);
+	YamlLine line;
+
+	bool inPad = false;
+	NoteType type = NoteType::Snare;
+	Mapping* mapping = nullptr;
+	U32 mappingIndent = 0;
+	U32 field = 0;
+
+	while (reader.Next(line))
+	{
+		if (line.item)
+		{
+			if (!inPad) { continue; }
+
+			loaded.push_back({ type, 0, 0, 0.0 });
+			mapping = &loaded.back();
+			mappingIndent = line.indent;
+			field = 0;
+		}
+		else if (line.value.empty())
+		{
+			//Pads can come in any order, any other block like Start: ends the current one
+			mapping = nullptr;
+			inPad = true;
+
+			switch (HashCI(line.key.data(), line.key.size()))
+			{
+			case "red pad"_Hash: { type = NoteType::Snare; } break;
+			case "yellow pad"_Hash: { type = NoteType::Tom1; } break;
+			case "blue pad"_Hash: { type = NoteType::Tom2; } break;
+			case "green pad"_Hash: { type = NoteType::Tom3; } break;
+			case "kick pad"_Hash: { type = NoteType::Kick; } break;
+			case "yellow cymbal"_Hash: { type = NoteType::Cymbal1; } break;
+			case "blue cymbal"_Hash: { type = NoteType::Cymbal2; } break;
+			case "green cymbal"_Hash: { type = NoteType::Cymbal3; } break;
+			default: { inPad = false; } break;
+			}
+
+			continue;
+		}
+		else if (!mapping || line.indent != mappingIndent)
+		{
+			mapping = nullptr;
+			continue;
+		}
+
+		//Fields are matched by name, unknown names fall back to the note, velocity, overhit order
+		U32 index = field++;
+		if (Parser::ContainsCI(line.key, "note")) { index = 0; }
+		else if (Parser::ContainsCI(line.key, "velocity")) { index = 1; }
+		else if (Parser::ContainsCI(line.key, "overhit")) { index = 2; }
+
+		switch (index)
+		{
+		case 0: { mapping->midiValue = Parser::ToI32(line.value, 0); } break;
+		case 1: { mapping->velocityThreshold = Parser::ToI32(line.value, 0); } break;
+		case 2: { mapping->overhitThreshold = Parser::ToF64(line.value, 0.0); } break;
+		default: break;
+		}
+	}
+}
\ No newline at end of file
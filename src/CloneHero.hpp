@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include "Config.hpp"
+#include "StringTable.hpp"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// Loaders for the files Clone Hero keeps in its folder: profiles.ini, the color profiles and the MIDI profiles.
+/// Everything is loaded into the tables passed in, so a caller can load aside and swap the results in whole.
+/// </summary>
+class CloneHero
+{
+public:
+	/// <summary>
+	/// Finds Clone Hero's folder, in the user's documents on Windows and in their home folder elsewhere
+	/// </summary>
+	static std::filesystem::path GetFolder();
+
+	/// <summary>
+	/// Builds the path of a profile from its UTF-8 name, the names in settings.cfg are UTF-8 on every platform
+	/// </summary>
+	static std::filesystem::path ColorProfilePath(const std::filesystem::path& folder, std::string_view name);
+	static std::filesystem::path MidiProfilePath(const std::filesystem::path& folder, std::string_view name);
+
+	/// <summary>
+	/// Loads every player in profiles.ini, a missing or empty file leaves a single guest profile
+	/// </summary>
+	static void LoadProfiles(const std::filesystem::path& folder, std::vector<Profile>& loaded, StringTable& names);
+	static void LoadColorProfiles(const std::filesystem::path& folder, StringTable& names);
+	static void LoadMidiProfiles(const std::filesystem::path& folder, StringTable& names);
+
+	/// <summary>
+	/// Loads the drum colors of a color profile, colors it doesn't set are left alone
+	/// </summary>
+	/// <returns>False if the file couldn't be read</returns>
+	static bool LoadColors(const std::filesystem::path& path, ColorProfile& colors);
+	static Vector3 HexToRBG(std::string_view hex);
+
+	/// <summary>
+	/// Loads the mappings of a MIDI profile, replacing whatever loaded held
+	/// </summary>
+	/// <returns>False if the file couldn't be read, loaded is left untouched</returns>
+	static bool LoadMidiProfile(const std::filesystem::path& path, std::vector<Mapping>& loaded);
+	static void ParseMidiProfile(std::string_view data, std::vector<Mapping>& loaded);
+
+private:
+	static std::filesystem::path FromUtf8(std::string_view name);
+	static std::string ToUtf8(const std::filesystem::path& path);
+
+	/// <summary>
+	/// Interns the name of every file in a folder with the extension, without the extension. A missing folder adds
+	/// nothing.
+	/// </summary>
+	static void ListStems(const std::filesystem::path& folder, std::string_view extension, StringTable& names);
+
+	STATIC_CLASS(CloneHero)
+};
\ No newline at end of file
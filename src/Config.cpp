@@ -0,0 +1,326 @@
+#include "Config.hpp"
+
+#include "Parser.hpp"
+
+#include <fstream>
+#include <sstream>
+
+std::string ConfigFile::Read(const std::filesystem::path& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open()) { return {}; }
+
+	//Sized once up front, growing a string a character at a time copies a large file over and over
+	std::error_code error;
+	U64 size = std::filesystem::file_size(path, error);
+	if (error) { return {}; }
+
+	std::string data(size, '\0');
+	file.read(data.data(), static_cast<std::streamsize>(size));
+
+	//Text mode drops the \r of every \r\n on Windows, so fewer characters than bytes can come back
+	data.resize(static_cast<U64>(file.gcount()));
+
+	return data;
+}
+
+bool ConfigFile::Load(std::string_view data, Settings& settings, NoteLayout& layout)
+{
+	if (data.empty()) { return false; }
+
+	IniReader reader(data);
+	IniLine line;
+
+	while (reader.Next(line))
+	{
+		if (line.type == IniLineType::Value) { Apply(line.name, line.value, settings, layout); }
+	}
+
+	Clamp(settings);
+
+	return true;
+}
+
+void ConfigFile::Apply(std::string_view name, std::string_view value, Settings& settings, NoteLayout& layout)
+{
+	switch (Hash(name.data(), name.size()))
+	{
+	case "settingWindowX"_Hash: {
+		settings.settingWindowX = Parser::ToI32(value, settings.settingWindowX);
+	} break;
+	case "settingWindowY"_Hash: {
+		settings.settingWindowY = Parser::ToI32(value, settings.settingWindowY);
+	} break;
+	case "settingWindowWidth"_Hash: {
+		settings.settingWindowWidth =
+			Parser::ToI32(value, settings.settingWindowWidth);
+	} break;
+	case "settingWindowHeight"_Hash: {
+		settings.settingWindowHeight =
+			Parser::ToI32(value, settings.settingWindowHeight);
+	} break;
+	case "visualizerWindowX"_Hash: {
+		settings.visualizerWindowX = Parser::ToI32(value, settings.visualizerWindowX);
+	} break;
+	case "visualizerWindowY"_Hash: {
+		settings.visualizerWindowY = Parser::ToI32(value, settings.visualizerWindowY);
+	} break;
+	case "visualizerWindowWidth"_Hash: {
+		settings.visualizerWindowWidth =
+			Parser::ToI32(value, settings.visualizerWindowWidth);
+	} break;
+	case "visualizerWindowHeight"_Hash: {
+		settings.visualizerWindowHeight =
+			Parser::ToI32(value, settings.visualizerWindowHeight);
+	} break;
+	case "profileId"_Hash: {
+		settings.profileId = (U32)Parser::ToI32(value, (I32)settings.profileId);
+	} break;
+	case "dynamicThreshold"_Hash: {
+		settings.dynamicThreshold = (U32)Parser::ToI32(value, (I32)settings.dynamicThreshold);
+	} break;
+	case "leftyFlip"_Hash: {
+		settings.leftyFlip = Parser::ToI32(value, settings.leftyFlip);
+	} break;
+	case "showDynamics"_Hash: {
+		settings.showDynamics = Parser::ToI32(value, settings.showDynamics);
+	} break;
+	case "showStats"_Hash: {
+		settings.showStats = Parser::ToI32(value, settings.showStats);
+	} break;
+	case "longKicks"_Hash: {
+		settings.longKicks = Parser::ToI32(value, settings.longKicks);
+	} break;
+	case "showLatency"_Hash: {
+		settings.showLatency = Parser::ToI32(value, settings.showLatency);
+	} break;
+	case "recordSessions"_Hash: {
+		settings.recordSessions = Parser::ToI32(value, settings.recordSessions);
+	} break;
+	case "chokeOnNoteOff"_Hash: {
+		settings.chokeOnNoteOff = Parser::ToI32(value, settings.chokeOnNoteOff);
+	} break;
+	case "sessionFolder"_Hash: {
+		settings.sessionFolder = value;
+	} break;
+	case "scrollSpeed"_Hash: {
+		settings.scrollSpeed = Parser::ToF32(value, settings.scrollSpeed);
+	} break;
+	case "scrollDirection"_Hash: {
+		settings.scrollDirection =
+			(ScrollDirection)Parser::ToI32(value, (I32)settings.scrollDirection);
+	} break;
+	case "noteWidth"_Hash: {
+		settings.noteWidth = Parser::ToF32(value, settings.noteWidth);
+	} break;
+	case "noteHeight"_Hash: {
+		settings.noteHeight = Parser::ToF32(value, settings.noteHeight);
+	} break;
+	case "noteGap"_Hash: {
+		settings.noteGap = Parser::ToF32(value, settings.noteGap);
+	} break;
+	case "noteSeparationMode"_Hash: {
+		settings.noteSeparationMode =
+			(NoteSeparationMode)Parser::ToI32(value, (I32)settings.noteSeparationMode);
+	} break;
+	case "tomTextureName"_Hash: {
+		settings.tomTextureName = value;
+	} break;
+	case "cymbalTextureName"_Hash: {
+		settings.cymbalTextureName = value;
+	} break;
+	case "kickTextureName"_Hash: {
+		settings.kickTextureName = value;
+	} break;
+	case "backgroundColor"_Hash: {
+		U64 vStart = 0;
+		U64 vEnd = value.find(',', vStart);
+		settings.backgroundColor.x = Parser::ToF32(value.substr(vStart, vEnd - vStart), settings.backgroundColor.x);
+		vStart = vEnd + 1;
+		vEnd = value.find(',', vStart);
+		settings.backgroundColor.y = Parser::ToF32(value.substr(vStart, vEnd - vStart), settings.backgroundColor.y);
+		vStart = vEnd + 1;
+		vEnd = value.find(',', vStart);
+		settings.backgroundColor.z = Parser::ToF32(value.substr(vStart, vEnd - vStart), settings.backgroundColor.z);
+		vStart = vEnd + 1;
+		settings.backgroundColor.w = Parser::ToF32(value.substr(vStart), settings.backgroundColor.w);
+	} break;
+	case "portName"_Hash: {
+		settings.portName = value;
+	} break;
+	case "colorProfileName"_Hash: {
+		settings.colorProfileName = value;
+	} break;
+	case "midiProfileName"_Hash: {
+		settings.midiProfileName = value;
+	} break;
+	case "midiChannels"_Hash: {
+		settings.midiChannels = ParseChannels(value);
+	} break;
+	case "laneControllers"_Hash: {
+		U64 start = 0;
+
+		for (I32& controller : settings.laneControllers)
+		{
+			U64 end = value.find(',', start);
+			controller = Parser::ToI32(value.substr(start, end - start), controller);
+
+			if (end == std::string_view::npos) { break; }
+			start = end + 1;
+		}
+	} break;
+	case "inputScheduling"_Hash: {
+		settings.inputThread.scheduling =
+			(SchedulingPolicy)Parser::ToI32(value, (I32)settings.inputThread.scheduling);
+	} break;
+	case "inputPriority"_Hash: {
+		settings.inputThread.priority = Parser::ToI32(value, settings.inputThread.priority);
+	} break;
+	case "inputCpu"_Hash: {
+		settings.inputThread.cpu = Parser::ToI32(value, settings.inputThread.cpu);
+	} break;
+	case "renderScheduling"_Hash: {
+		settings.renderThread.scheduling =
+			(SchedulingPolicy)Parser::ToI32(value, (I32)settings.renderThread.scheduling);
+	} break;
+	case "renderPriority"_Hash: {
+		settings.renderThread.priority = Parser::ToI32(value, settings.renderThread.priority);
+	} break;
+	case "renderCpu"_Hash: {
+		settings.renderThread.cpu = Parser::ToI32(value, settings.renderThread.cpu);
+	} break;
+	case "lockMemory"_Hash: {
+		settings.lockMemory = Parser::ToI32(value, settings.lockMemory);
+	} break;
+	case "noteLayout"_Hash: {
+		NoteLayout defaults = DefaultLayout();
+
+		U32 i = 0;
+		for (C8 c : value)
+		{
+			if (i == layout.size()) { break; }
+
+			U32 index = c - '0';
+			if (index < defaults.size()) { layout[i] = defaults[index]; }
+
+			++i;
+		}
+	} break;
+	default: break;
+	}
+}
+
+void ConfigFile::Clamp(Settings& settings)
+{
+	settings.settingWindowX = settings.settingWindowX > 0 ? settings.settingWindowX : 0;
+	settings.settingWindowY = settings.settingWindowY > 0 ? settings.settingWindowY : 0;
+	settings.settingWindowWidth = settings.settingWindowWidth > 100 ? settings.settingWindowWidth : 100;
+	settings.settingWindowHeight = settings.settingWindowHeight > 100 ? settings.settingWindowHeight : 100;
+	settings.visualizerWindowX = settings.visualizerWindowX > 0 ? settings.visualizerWindowX : 0;
+	settings.visualizerWindowY = settings.visualizerWindowY > 0 ? settings.visualizerWindowY : 0;
+	settings.visualizerWindowWidth = settings.visualizerWindowWidth > 100 ? settings.visualizerWindowWidth : 100;
+	settings.visualizerWindowHeight = settings.visualizerWindowHeight > 100 ? settings.visualizerWindowHeight : 100;
+
+	for (I32& controller : settings.laneControllers) { controller = controller < -1 || controller > 127 ? -1 : controller; }
+
+	for (ThreadPolicy* policy : { &settings.inputThread, &settings.renderThread })
+	{
+		if ((U32)policy->scheduling > (U32)SchedulingPolicy::Fifo) { policy->scheduling = SchedulingPolicy::Normal; }
+		policy->cpu = policy->cpu > -1 ? policy->cpu : -1;
+	}
+}
+
+std::string ConfigFile::Serialize(const Settings& settings, const NoteLayout& layout)
+{
+	std::ostringstream output;
+	output << "settingWindowX=" << settings.settingWindowX << '\n';
+	output << "settingWindowY=" << settings.settingWindowY << '\n';
+	output << "settingWindowWidth=" << settings.settingWindowWidth << '\n';
+	output << "settingWindowHeight=" << settings.settingWindowHeight << '\n';
+	output << "visualizerWindowX=" << settings.visualizerWindowX << '\n';
+	output << "visualizerWindowY=" << settings.visualizerWindowY << '\n';
+	output << "visualizerWindowWidth=" << settings.visualizerWindowWidth << '\n';
+	output << "visualizerWindowHeight=" << settings.visualizerWindowHeight << '\n';
+	output << "profileId=" << settings.profileId << '\n';
+	output << "dynamicThreshold=" << settings.dynamicThreshold << '\n';
+	output << "leftyFlip=" << settings.leftyFlip << '\n';
+	output << "showDynamics=" << settings.showDynamics << '\n';
+	output << "showStats=" << settings.showStats << '\n';
+	output << "longKicks=" << settings.longKicks << '\n';
+	output << "showLatency=" << settings.showLatency << '\n';
+	output << "recordSessions=" << settings.recordSessions << '\n';
+	output << "chokeOnNoteOff=" << settings.chokeOnNoteOff << '\n';
+	output << "sessionFolder=" << settings.sessionFolder << '\n';
+	output << "scrollSpeed=" << settings.scrollSpeed << '\n';
+	output << "scrollDirection=" << static_cast<U32>(settings.scrollDirection) << '\n';
+	output << "noteWidth=" << settings.noteWidth << '\n';
+	output << "noteHeight=" << settings.noteHeight << '\n';
+	output << "noteGap=" << settings.noteGap << '\n';
+	output << "noteSeparationMode=" << static_cast<U32>(settings.noteSeparationMode) << '\n';
+	output << "tomTextureName=" << settings.tomTextureName << '\n';
+	output << "cymbalTextureName=" << settings.cymbalTextureName << '\n';
+	output << "kickTextureName=" << settings.kickTextureName << '\n';
+	output << "backgroundColor=" << settings.backgroundColor.x << ',' <<
+		settings.backgroundColor.y << ',' << settings.backgroundColor.z <<
+		',' << settings.backgroundColor.w << '\n';
+	output << "portName=" << settings.portName << '\n';
+	output << "colorProfileName=" << settings.colorProfileName << '\n';
+	output << "midiProfileName=" << settings.midiProfileName << '\n';
+
+	output << "midiChannels=";
+	for (U32 channel = 0, count = 0; channel < 16; ++channel)
+	{
+		if (settings.midiChannels & (1 << channel)) { output << (count++ ? "," : "") << channel + 1; }
+	}
+	output << '\n';
+
+	output << "laneControllers=";
+	for (U32 i = 0; i < settings.laneControllers.size(); ++i) { output << (i ? "," : "") << settings.laneControllers[i]; }
+	output << '\n';
+
+	output << "inputScheduling=" << static_cast<U32>(settings.inputThread.scheduling) << '\n';
+	output << "inputPriority=" << settings.inputThread.priority << '\n';
+	output << "inputCpu=" << settings.inputThread.cpu << '\n';
+	output << "renderScheduling=" << static_cast<U32>(settings.renderThread.scheduling) << '\n';
+	output << "renderPriority=" << settings.renderThread.priority << '\n';
+	output << "renderCpu=" << settings.renderThread.cpu << '\n';
+	output << "lockMemory=" << settings.lockMemory << '\n';
+
+	output << "noteLayout=";
+	for (const NoteInfo& info : layout) { output << info.index; }
+	output << '\n';
+
+	return output.str();
+}
+
+NoteLayout ConfigFile::DefaultLayout()
+{
+	return {
+		NoteInfo{ "Snare", 0 },
+		NoteInfo{ "Kick", 1 },
+		NoteInfo{ "Cymbal 1", 2 },
+		NoteInfo{ "Tom 1", 3 },
+		NoteInfo{ "Cymbal 2", 4 },
+		NoteInfo{ "Tom 2", 5 },
+		NoteInfo{ "Cymbal 3", 6 },
+		NoteInfo{ "Tom 3", 7 }
+	};
+}
+
+U16 ConfigFile::ParseChannels(std::string_view value)
+{
+	U16 channels = 0;
+	U64 start = 0;
+
+	while (start <= value.size())
+	{
+		U64 end = value.find(',', start);
+		I32 channel = Parser::ToI32(value.substr(start, end - start), 0);
+		if (channel >= 1 && channel <= 16) { channels |= 1 << (channel - 1); }
+
+		if (end == std::string_view::npos) { break; }
+		start = end + 1;
+	}
+
+	return channels;
+}
\ No newline at end of file
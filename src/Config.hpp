@@ -0,0 +1,205 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <array>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+enum class ScrollDirection
+{
+	Up,
+	Down,
+	Left,
+	Right
+};
+
+enum class NoteSeparationMode
+{
+	None,
+	Cutoff,
+	Squish
+};
+
+enum class SchedulingPolicy
+{
+	Normal,
+	Nice,
+	RoundRobin,
+	Fifo
+};
+
+enum class NoteType
+{
+	Snare,
+	Kick,
+	Cymbal1,
+	Tom1,
+	Cymbal2,
+	Tom2,
+	Cymbal3,
+	Tom3
+};
+
+struct Texture
+{
+	std::string name{};
+	U32 id;
+	U32 width;
+	U32 height;
+};
+
+struct Mapping
+{
+	NoteType type;
+	I32 midiValue;
+	I32 velocityThreshold;
+	F64 overhitThreshold;
+	F64 lastHit{ -1.0 };
+};
+
+struct Profile
+{
+	U32 id;
+	std::string name;
+	std::string colorProfile;
+	U32 dynamicThreshold{ 100 };
+	bool leftyFlip;
+};
+
+struct ColorProfile
+{
+	Vector3 snareColor{ 1.0f, 0.0f, 0.0f };
+	Vector3 tom1Color{ 1.0f, 1.0f, 0.0f };
+	Vector3 tom2Color{ 0.0f, 0.537254930f, 1.0f };
+	Vector3 tom3Color{ 0.0f, 1.0f, 0.0f };
+	Vector3 cymbal1Color{ 1.0f, 0.898039222f, 0.192156866f };
+	Vector3 cymbal2Color{ 0.113725491f, 0.388235301f, 1.0f };
+	Vector3 cymbal3Color{ 0.0470588244f, 1.0f, 0.0470588244f };
+	Vector3 kickColor{ 1.0f, 0.274509817f, 0.0f };
+};
+
+struct ThreadPolicy
+{
+	SchedulingPolicy scheduling{ SchedulingPolicy::Normal };
+	I32 priority{ 0 };	//1 to 99 for RoundRobin and Fifo, the nice value from -20 to 19 for Nice
+	I32 cpu{ -1 };		//Core the thread is pinned to, -1 lets it run anywhere
+};
+
+struct Settings
+{
+	I32 settingWindowX{ 100 };
+	I32 settingWindowY{ 100 };
+	I32 settingWindowWidth{ 630 };
+	I32 settingWindowHeight{ 800 };
+
+	I32 visualizerWindowX{ 730 };
+	I32 visualizerWindowY{ 100 };
+	I32 visualizerWindowWidth{ 350 };
+	I32 visualizerWindowHeight{ 800 };
+
+	std::string portName{ "loopMIDI Visualizer" };
+	std::string colorProfileName{};
+	std::string midiProfileName{ "loopMIDI CH" };
+	U16 midiChannels{ 0x0201 };		//Bit n reads channel n + 1, 0 reads them all, 1 and 10 by default
+	std::array<I32, 8> laneControllers{ -1, -1, 4, -1, -1, -1, -1, -1 };	//CC shown on each lane in NoteType order, -1 for none, the hi-hat pedal on Cymbal 1
+	U32 profileId{ U32_MAX };
+	U32 dynamicThreshold{ 100 };
+	bool leftyFlip{ false };
+	bool showDynamics{ true };
+	bool showStats{ true };
+	bool longKicks{ false };
+	bool showLatency{ false };
+	bool recordSessions{ false };
+	bool chokeOnNoteOff{ false };	//Most kits send note-offs right after every hit, so only aftertouch chokes by default
+	std::string sessionFolder{ "sessions" };
+
+	F32 scrollSpeed{ 1.0f };
+	ScrollDirection scrollDirection{ ScrollDirection::Down };
+	F32 noteWidth{ 0.1f };
+	F32 noteHeight{ 0.025f };
+	F32 noteGap{ 0.005f };
+	NoteSeparationMode noteSeparationMode{ NoteSeparationMode::Cutoff };
+
+	std::string tomTextureName{ "square" };
+	std::string cymbalTextureName{ "triangle" };
+	std::string kickTextureName{ "square" };
+	Vector4 backgroundColor{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+	//Applied when each thread starts, so changes take a restart
+	ThreadPolicy inputThread{};
+	ThreadPolicy renderThread{};
+	bool lockMemory{ false };
+
+	Texture* tomTexture{ nullptr };
+	Texture* cymbalTexture{ nullptr };
+	Texture* kickTexture{ nullptr };
+};
+
+struct NoteInfo
+{
+	std::string name;
+	U32 index;
+};
+
+using NoteLayout = std::array<NoteInfo, 8>;
+
+struct Stats
+{
+	Vector3 spawn{ 0.0f, 0.0f, 0.0f };
+	F32 scale{ 1.0f };
+	U32 lastIndex{ U32_MAX };
+	U32 openIndex{ U32_MAX };	//The lane's last note while it can still be choked
+	U32 hitCount{ 0 };
+	U32 ghostCount{ 0 };
+};
+
+/// <summary>
+/// Reads and writes settings.cfg. Works on whatever settings and layout it's given, so tools can load a config
+/// without touching the visualizer's.
+/// </summary>
+class ConfigFile
+{
+public:
+	/// <summary>
+	/// Reads a whole text file
+	/// </summary>
+	/// <returns>The file's contents, empty if it couldn't be opened</returns>
+	static std::string Read(const std::filesystem::path& path);
+
+	/// <summary>
+	/// Applies every setting in a config, then clamps the window placement
+	/// </summary>
+	/// <returns>False if the config is empty</returns>
+	static bool Load(std::string_view data, Settings& settings, NoteLayout& layout);
+
+	/// <summary>
+	/// Applies one setting, unknown names and unparsable values leave the settings as they are
+	/// </summary>
+	static void Apply(std::string_view name, std::string_view value, Settings& settings, NoteLayout& layout);
+
+	/// <summary>
+	/// Keeps the windows on screen and large enough to grab
+	/// </summary>
+	static void Clamp(Settings& settings);
+
+	/// <summary>
+	/// Writes settings in settings.cfg format
+	/// </summary>
+	static std::string Serialize(const Settings& settings, const NoteLayout& layout);
+
+	/// <summary>
+	/// The lanes in their default order, left to right
+	/// </summary>
+	static NoteLayout DefaultLayout();
+
+	/// <summary>
+	/// Reads a list of channel numbers like 1,10 into a mask, anything outside 1 to 16 is skipped
+	/// </summary>
+	/// <returns>Bit n set for channel n + 1, 0 for an empty list, which reads every channel</returns>
+	static U16 ParseChannels(std::string_view value);
+
+private:
+	STATIC_CLASS(ConfigFile)
+};
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "Controllers.hpp"
+
+#include "Time.hpp"
+
+#include <cmath>
+#include <cstring>
+
+Controllers::Controllers()
+{
+	controllers.fill(-1);
+	memset(lanes, NoLane, sizeof(lanes));
+	Reset();
+}
+
+void Controllers::SetLanes(const std::array<I32, LaneCount>& laneControllers)
+{
+	if (laneControllers == controllers) { return; }
+
+	memset(lanes, NoLane, sizeof(lanes));
+
+	for (U32 i = 0; i < LaneCount; ++i)
+	{
+		I32 controller = laneControllers[i];
+		if (controller != controllers[i]) { state[i] = {}; }
+
+		//A controller shared by several lanes drives the first of them
+		if (controller >= 0 && controller < 128 && lanes[controller] == NoLane) { lanes[controller] = static_cast<U8>(i); }
+	}
+
+	controllers = laneControllers;
+}
+
+bool Controllers::Feed(const MidiEvent& event)
+{
+	U8 index = lanes[event.bytes[1] & 0x7F];
+	if (index == NoLane) { return false; }
+
+	Lane& lane = state[index];
+	F32 raw = (event.bytes[2] & 0x7F) / 127.0f;
+
+	//A controller already closed when it's first heard from hasn't closed while we were listening
+	if (!lane.active)
+	{
+		lane = { raw, raw, event.time, 0, raw >= CloseLevel, true };
+		return true;
+	}
+
+	if (!lane.closed && raw >= CloseLevel)
+	{
+		lane.closed = true;
+		++lane.closes;
+	}
+	else if (lane.closed && raw <= OpenLevel) { lane.closed = false; }
+
+	//Between steps the newest message just replaces the target, it's treated as arriving with the last step
+	if (event.time < lane.updated + DecimationInterval)
+	{
+		lane.target = raw;
+		return true;
+	}
+
+	lane.value = Approach(lane, event.time);
+	lane.target = raw;
+	lane.updated = event.time;
+
+	return true;
+}
+
+void Controllers::Sample(U64 now, std::array<F32, LaneCount>& levels, std::array<U32, LaneCount>& closes)
+{
+	for (U32 i = 0; i < LaneCount; ++i)
+	{
+		levels[i] = state[i].active ? Approach(state[i], now) : -1.0f;
+		closes[i] = state[i].closes;
+		state[i].closes = 0;
+	}
+}
+
+void Controllers::Reset()
+{
+	for (Lane& lane : state) { lane = {}; }
+}
+
+F32 Controllers::Approach(const Lane& lane, U64 time)
+{
+	if (time <= lane.updated) { return lane.value; }
+
+	F64 elapsed = Time::ToSeconds(static_cast<I64>(time - lane.updated));
+	return lane.target + (lane.value - lane.target) * static_cast<F32>(std::exp(-elapsed / SmoothingTime));
+}
\ No newline at end of file
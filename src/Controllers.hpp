@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include "EventSource.hpp"
+
+#include <array>
+
+/// <summary>
+/// Turns continuous controller streams, like a hi-hat pedal's CC4 or a pad's positional sensing, into one smoothed
+/// level per lane. Messages are decimated as they're fed: within DecimationInterval of the last step only the target
+/// moves, so a kit streaming hundreds of messages a second costs a compare and a store per message. The level eases
+/// towards the target over SmoothingTime and can be sampled at any time, so a stream that stops still settles. Every
+/// message is checked for the controller closing, like a hi-hat pedal pressed down, so quick closes between two
+/// samples are still counted. Not thread safe, live input feeds it and the frame samples it under the same lock.
+/// </summary>
+class Controllers
+{
+public:
+	static constexpr U64 DecimationInterval = 2000000;	//Nanoseconds between smoothing steps, 500 a second
+	static constexpr F64 SmoothingTime = 0.02;			//Seconds for the level to cover 63% of a jump
+	static constexpr F32 CloseLevel = 0.9f;				//A controller reaching this counts as a close
+	static constexpr F32 OpenLevel = 0.6f;				//and has to fall back to this before it can close again
+
+	/// <summary>
+	/// Lane count, indexed in NoteType order
+	/// </summary>
+	static constexpr U32 LaneCount = 8;
+
+	Controllers();
+
+	/// <summary>
+	/// Assigns controllers to lanes, lanes whose controller changed start over
+	/// </summary>
+	/// <param name="laneControllers:">The controller number driving each lane, -1 for none</param>
+	void SetLanes(const std::array<I32, LaneCount>& laneControllers);
+
+	/// <summary>
+	/// Feeds a control change
+	/// </summary>
+	/// <returns>True if the controller drives a lane</returns>
+	bool Feed(const MidiEvent& event);
+
+	/// <summary>
+	/// Gets every lane's level at a point in time, and the closes since the last sample
+	/// </summary>
+	/// <param name="now:">On the same clock as the events fed</param>
+	/// <param name="levels:">Gets 0 to 1 for lanes that have had a message, -1 for the rest</param>
+	/// <param name="closes:">Gets how many times each lane's controller closed since the last sample</param>
+	void Sample(U64 now, std::array<F32, LaneCount>& levels, std::array<U32, LaneCount>& closes);
+
+	void Reset();
+
+private:
+	struct Lane
+	{
+		F32 value;		//The level at updated
+		F32 target;		//The latest message, the level has been easing towards it since updated
+		U64 updated;
+		U32 closes;		//Since the last sample
+		bool closed;
+		bool active;
+	};
+
+	static F32 Approach(const Lane& lane, U64 time);
+
+	std::array<I32, LaneCount> controllers;
+	U8 lanes[128];		//Controller number to lane, NoLane for controllers no lane uses
+	Lane state[LaneCount];
+
+	static constexpr U8 NoLane = 0xFF;
+};
\ No newline at end of file
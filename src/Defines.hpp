@@ -20,7 +20,7 @@ typedef char16_t C16;			//16-bit unicode character
 typedef wchar_t CW;				//Platform defined wide character, WINDOWS: 16-bit, OTHER: 32-bit
 typedef char32_t C32;			//32-bit unicode character
 
-typedef decltype(__nullptr) NullPointer; //Nullptr type
+typedef decltype(nullptr) NullPointer; //Nullptr type
 
 static inline constexpr unsigned long long U64_MAX = U64(0xFFFFFFFFFFFFFFFF);	//Maximum value of an unsigned 64-bit integer
 static inline constexpr unsigned long long U64_MIN = U64(0x0000000000000000);	//Minimum value of an unsigned 64-bit integer
@@ -156,7 +156,8 @@ static constexpr U64 HashCI(const C8* str, U64 length)
 	return hash;
 }
 
-constexpr inline U64 operator""_Hash(const C8 * str, U64 length) { return Hash(str, length); }
+//Literal operators take the length as size_t, which is unsigned long rather than U64 on 64-bit Linux
+constexpr inline U64 operator""_Hash(const C8 * str, decltype(sizeof(0)) length) { return Hash(str, length); }
 
 struct Vector2
 {
@@ -0,0 +1,513 @@
+#include "Engine.hpp"
+
+#include "EventSource.hpp"
+#include "Time.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+Engine::Engine(const Settings& settings, const ColorProfile& colors) : settings{ settings }, colors{ colors }
+{
+	offsets.resize(MaxNotes, { -100.0f, -100.0f, 0.0f });
+	scales.resize(MaxNotes, { 1.0f, 1.0f });
+	texCoordOffsets.resize(MaxNotes, { 0.0f, 0.0f });
+	texCoordScales.resize(MaxNotes, { 1.0f, 1.0f });
+	noteColors.resize(MaxNotes, { 0.0f, 0.0f, 0.0f });
+	textureIds.resize(MaxNotes, 0);
+	controllerLevels.fill(-1.0f);
+}
+
+Mapping* Engine::MatchEvent(std::vector<Mapping>& candidates, const MidiEvent& event)
+{
+	F64 time = Time::ToSeconds(static_cast<I64>(event.time));
+
+	for (Mapping& mapping : candidates)
+	{
+		if (event.bytes[1] != mapping.midiValue) { continue; }
+
+		if (event.bytes[2] >= mapping.velocityThreshold && (time - mapping.lastHit) >= mapping.overhitThreshold)
+		{
+			mapping.lastHit = time;
+			return &mapping;
+		}
+
+		return nullptr;
+	}
+
+	return nullptr;
+}
+
+bool Engine::ProcessEvent(const MidiEvent& event)
+{
+	//Settings can change between any two events, a rebuild only happens when the channels did
+	dispatch.SetChannels(settings.midiChannels);
+
+	switch (dispatch.Classify(event))
+	{
+	case MidiMessage::NoteOn: break;
+	case MidiMessage::Clock: { TrackClock(event.time); } return false;
+	case MidiMessage::ControlChange: {
+		controllers.SetLanes(settings.laneControllers);
+		controllers.Feed(event);
+	} return false;
+	case MidiMessage::NoteOff: {
+		if (settings.chokeOnNoteOff) { Choke(event); }
+	} return false;
+	case MidiMessage::PolyAftertouch: {
+		//Grabbing a cymbal sends pressure, letting go sends 0
+		if (event.bytes[2] > 0) { Choke(event); }
+	} return false;
+	default: return false;
+	}
+
+	Mapping* mapping = MatchEvent(mappings, event);
+	if (!mapping) { return false; }
+
+	bool ghost = event.bytes[2] < settings.dynamicThreshold;
+
+	F32 dynamicMod = (ghost && settings.showDynamics) ? 0.5f : 1.0f;
+
+	Vector3 color;
+	const Texture* texture;
+
+	switch (mapping->type)
+	{
+	case NoteType::Snare: { color = colors.snareColor; texture = settings.tomTexture; } break;
+	case NoteType::Kick: { color = colors.kickColor; texture = settings.kickTexture; } break;
+	case NoteType::Cymbal1: { color = colors.cymbal1Color; texture = settings.cymbalTexture; } break;
+	case NoteType::Tom1: { color = colors.tom1Color; texture = settings.tomTexture; } break;
+	case NoteType::Cymbal2: { color = colors.cymbal2Color; texture = settings.cymbalTexture; } break;
+	case NoteType::Tom2: { color = colors.tom2Color; texture = settings.tomTexture; } break;
+	case NoteType::Cymbal3: { color = colors.cymbal3Color; texture = settings.cymbalTexture; } break;
+	case NoteType::Tom3: { color = colors.tom3Color; texture = settings.tomTexture; } break;
+	default: return false;
+	}
+
+	//Lanes are indexed in NoteType order
+	Stats& lane = stats[static_cast<U32>(mapping->type)];
+	SpawnNote(lane, color * dynamicMod, texture);
+	++lane.hitCount;
+	if (ghost) { ++lane.ghostCount; }
+
+	return true;
+}
+
+void Engine::Choke(const MidiEvent& event)
+{
+	for (const Mapping& mapping : mappings)
+	{
+		if (event.bytes[1] != mapping.midiValue) { continue; }
+
+		switch (mapping.type)
+		{
+		case NoteType::Cymbal1:
+		case NoteType::Cymbal2:
+		case NoteType::Cymbal3: {
+			ChokeLane(stats[static_cast<U32>(mapping.type)], ChokeKeep);
+		} return;
+		default: break;
+		}
+	}
+}
+
+void Engine::TrackClock(U64 time)
+{
+	F64 interval = lastClock && time > lastClock ? Time::ToSeconds(static_cast<I64>(time - lastClock)) : 0.0;
+	lastClock = time;
+
+	//A gap longer than MaxClockInterval means the clock stopped, the tempo starts over with the next one
+	if (interval <= 0.0 || interval > MaxClockInterval)
+	{
+		clockTempo = 0.0;
+		return;
+	}
+
+	//Single clocks jitter with the USB polling, smoothing over about a beat steadies the readout
+	F64 tempo = 60.0 / (interval * ClocksPerBeat);
+	clockTempo = clockTempo > 0.0 ? clockTempo + (tempo - clockTempo) / ClocksPerBeat : tempo;
+}
+
+void Engine::Layout(const NoteLayout& layout, I32 width, I32 height, F32 statsSize)
+{
+	F32 spawnPosition = 1.0f - settings.noteHeight;
+
+	F32 layoutPosition = -0.875f;
+	F32 layoutIncrement = 0.25f;
+	F32 x = 0.0f;
+	F32 y = 0.0f;
+	F32 kickX = 0.0f;
+	F32 kickY = 0.0f;
+
+	if (settings.longKicks)
+	{
+		layoutPosition = -0.85714285714f;
+		layoutIncrement = 0.28571428571f;
+	}
+
+	switch (settings.scrollDirection)
+	{
+	case ScrollDirection::Down: {
+		if (settings.showStats) { spawnPosition = (height - statsSize * 2.0f) / height - settings.noteHeight; }
+
+		x = layoutPosition;
+		y = spawnPosition;
+		kickX = 0.0f;
+		kickY = spawnPosition;
+	} break;
+	case ScrollDirection::Right: {
+		if (settings.showStats) { spawnPosition = (width - statsSize * 2.0f) / width - settings.noteHeight; }
+
+		x = -spawnPosition;
+		y = layoutPosition;
+		kickX = -spawnPosition;
+		kickY = 0.0f;
+	} break;
+	case ScrollDirection::Up: {
+		if (settings.showStats) { spawnPosition = (height - statsSize * 2.0f) / height - settings.noteHeight; }
+
+		x = layoutPosition;
+		y = -spawnPosition;
+		kickX = 0.0f;
+		kickY = -spawnPosition;
+	} break;
+	case ScrollDirection::Left: {
+		if (settings.showStats) { spawnPosition = (width - statsSize * 2.0f) / width - settings.noteHeight; }
+
+		x = spawnPosition;
+		y = layoutPosition;
+		kickX = spawnPosition;
+		kickY = 0.0f;
+	} break;
+	default:
+		break;
+	}
+
+	for (const NoteInfo& info : layout)
+	{
+		Stats& lane = stats[info.index];
+
+		if (settings.longKicks && info.name == "Kick")
+		{
+			lane.scale = 100.0f;
+			lane.spawn = { kickX, kickY, 0.5f };
+		}
+		else
+		{
+			lane.scale = 1.0f;
+			lane.spawn = { x, y, 0.0f };
+			if (settings.scrollDirection == ScrollDirection::Left || settings.scrollDirection == ScrollDirection::Right) { y += layoutIncrement; }
+			if (settings.scrollDirection == ScrollDirection::Up || settings.scrollDirection == ScrollDirection::Down) { x += layoutIncrement; }
+		}
+	}
+
+	ClearNotes();
+}
+
+Vector2 Engine::ScrollVelocity(F64 deltaTime) const
+{
+	switch (settings.scrollDirection)
+	{
+	case ScrollDirection::Up: {
+		return Vector2{ 0.0f, 1.0f } *
+			static_cast<F32>(deltaTime * settings.scrollSpeed);
+	}
+	case ScrollDirection::Down: {
+		return Vector2{ 0.0f, -1.0f } *
+			static_cast<F32>(deltaTime * settings.scrollSpeed);
+	}
+	case ScrollDirection::Left: {
+		return Vector2{ -1.0f, 0.0f } *
+			static_cast<F32>(deltaTime * settings.scrollSpeed);
+	}
+	case ScrollDirection::Right: {
+		return Vector2{ 1.0f, 0.0f } *
+			static_cast<F32>(deltaTime * settings.scrollSpeed);
+	}
+	}
+
+	return { 0.0f, 0.0f };
+}
+
+void Engine::Simulate(Vector2 velocity)
+{
+	for (Vector3& offset : offsets)
+	{
+		offset += velocity;
+	}
+}
+
+void Engine::SpawnNote(Stats& lane, const Vector3& color, const Texture* texture)
+{
+	if (texture == nullptr) { texture = defaultTexture; }
+
+	Vector2 scale = { 1.0f, 1.0f };
+	Vector2 texCoordOffset = { 0.0f, 0.0f };
+	Vector2 texCoordScale = { 1.0f, 1.0f };
+
+	if (settings.noteSeparationMode != NoteSeparationMode::None && lane.lastIndex != U32_MAX)
+	{
+		Vector3 prevOffset = offsets[lane.lastIndex];
+
+		F32 allowedDistance = settings.noteHeight * 2 + settings.noteGap;
+		F32 distance = allowedDistance;
+
+		switch (settings.scrollDirection)
+		{
+		case ScrollDirection::Up: { distance = prevOffset.y - lane.spawn.y; } break;
+		case ScrollDirection::Down: { distance = lane.spawn.y - prevOffset.y; } break;
+		case ScrollDirection::Left: { distance = lane.spawn.x - prevOffset.x; } break;
+		case ScrollDirection::Right: { distance = prevOffset.x - lane.spawn.x; } break;
+		}
+
+		if (distance < allowedDistance)
+		{
+			TrimNote(lane.lastIndex, allowedDistance - distance, settings.noteSeparationMode == NoteSeparationMode::Cutoff);
+		}
+	}
+
+	switch (settings.scrollDirection)
+	{
+	case ScrollDirection::Up: { scale.x = lane.scale; } break;
+	case ScrollDirection::Down: { scale.x = lane.scale; } break;
+	case ScrollDirection::Left: { scale.y = lane.scale; } break;
+	case ScrollDirection::Right: { scale.y = lane.scale; } break;
+	}
+
+	//The slot is reused, a lane whose open note lived there has nothing left to choke
+	for (Stats& other : stats)
+	{
+		if (other.openIndex == nextIndex) { other.openIndex = U32_MAX; }
+	}
+
+	offsets[nextIndex] = lane.spawn;
+	scales[nextIndex] = scale;
+	noteColors[nextIndex] = color;
+	texCoordOffsets[nextIndex] = texCoordOffset;
+	texCoordScales[nextIndex] = texCoordScale;
+	textureIds[nextIndex] = texture ? texture->id : 0;
+
+	lane.lastIndex = nextIndex;
+	lane.openIndex = nextIndex;
+
+	++nextIndex %= MaxNotes;
+}
+
+void Engine::TrimNote(U32 index, F32 adjustment, bool cutTexture)
+{
+	//Cuts the trailing end, the one nearest the spawn point, so the note's leading edge stays where it was hit
+	F32 percent = adjustment / (settings.noteHeight * 2.0f);
+
+	switch (settings.scrollDirection)
+	{
+	case ScrollDirection::Up: {
+		offsets[index].y += adjustment / 2.0f;
+		scales[index].y -= percent;
+		if (cutTexture)
+		{
+			texCoordOffsets[index].y += percent;
+			texCoordScales[index].y -= percent;
+		}
+	} break;
+	case ScrollDirection::Down: {
+		offsets[index].y -= adjustment / 2.0f;
+		scales[index].y -= percent;
+		if (cutTexture) { texCoordScales[index].y -= percent; }
+	} break;
+	case ScrollDirection::Left: {
+		offsets[index].x -= adjustment / 2.0f;
+		scales[index].x -= percent;
+		if (cutTexture) { texCoordScales[index].x -= percent; }
+	} break;
+	case ScrollDirection::Right: {
+		offsets[index].x += adjustment / 2.0f;
+		scales[index].x -= percent;
+		if (cutTexture)
+		{
+			texCoordOffsets[index].x += percent;
+			texCoordScales[index].x -= percent;
+		}
+	} break;
+	}
+}
+
+void Engine::ChokeLane(Stats& lane, F32 keep)
+{
+	if (lane.openIndex == U32_MAX) { return; }
+
+	bool vertical = settings.scrollDirection == ScrollDirection::Up || settings.scrollDirection == ScrollDirection::Down;
+	const Vector2& scale = scales[lane.openIndex];
+	F32 length = settings.noteHeight * 2.0f * (vertical ? scale.y : scale.x);
+
+	TrimNote(lane.openIndex, length * (1.0f - keep), true);
+	lane.openIndex = U32_MAX;
+}
+
+void Engine::ClearNotes()
+{
+	for (Vector3& offset : offsets)
+	{
+		offset = { -100.0f, -100.0f, 0.0f };
+	}
+
+	for (Stats& lane : stats) { lane.openIndex = U32_MAX; }
+}
+
+void Engine::Reset()
+{
+	for (Stats& lane : stats)
+	{
+		lane.lastIndex = U32_MAX;
+		lane.openIndex = U32_MAX;
+		lane.hitCount = 0;
+		lane.ghostCount = 0;
+	}
+
+	for (Mapping& mapping : mappings) { mapping.lastHit = -1.0; }
+
+	lastClock = 0;
+	clockTempo = 0.0;
+	controllers.Reset();
+	controllerLevels.fill(-1.0f);
+
+	std::fill(offsets.begin(), offsets.end(), Vector3{ -100.0f, -100.0f, 0.0f });
+	std::fill(scales.begin(), scales.end(), Vector2{ 1.0f, 1.0f });
+	std::fill(texCoordOffsets.begin(), texCoordOffsets.end(), Vector2{ 0.0f, 0.0f });
+	std::fill(texCoordScales.begin(), texCoordScales.end(), Vector2{ 1.0f, 1.0f });
+	std::fill(noteColors.begin(), noteColors.end(), Vector3{ 0.0f, 0.0f, 0.0f });
+	std::fill(textureIds.begin(), textureIds.end(), 0);
+
+	nextIndex = 0;
+}
+
+U64 Engine::StateHash() const
+{
+	U64 hash = 14695981039346656037ull;
+
+	auto hashBytes = [&hash](const void* data, U64 size)
+	{
+		const U8* bytes = static_cast<const U8*>(data);
+		for (U64 i = 0; i < size; ++i) { hash = (hash ^ bytes[i]) * 1099511628211ull; }
+	};
+
+	hashBytes(offsets.data(), offsets.size() * sizeof(Vector3));
+	hashBytes(scales.data(), scales.size() * sizeof(Vector2));
+	hashBytes(texCoordOffsets.data(), texCoordOffsets.size() * sizeof(Vector2));
+	hashBytes(texCoordScales.data(), texCoordScales.size() * sizeof(Vector2));
+	hashBytes(noteColors.data(), noteColors.size() * sizeof(Vector3));
+	hashBytes(textureIds.data(), textureIds.size() * sizeof(U32));
+	hashBytes(&nextIndex, sizeof(nextIndex));
+
+	for (const Stats& lane : stats)
+	{
+		const U32 values[] = { lane.lastIndex, lane.hitCount, lane.ghostCount };
+		for (U32 value : values) { hash = (hash ^ value) * 1099511628211ull; }
+	}
+
+	return hash;
+}
+
+void Engine::PackInstances(U8* destination) const
+{
+	memcpy(destination, offsets.data(), MaxNotes * sizeof(Vector3));
+	memcpy(destination + ScalesOffset, scales.data(), MaxNotes * sizeof(Vector2));
+	memcpy(destination + TexCoordOffsetsOffset, texCoordOffsets.data(), MaxNotes * sizeof(Vector2));
+	memcpy(destination + TexCoordScalesOffset, texCoordScales.data(), MaxNotes * sizeof(Vector2));
+	memcpy(destination + ColorsOffset, noteColors.data(), MaxNotes * sizeof(Vector3));
+	memcpy(destination + TextureIdsOffset, textureIds.data(), MaxNotes * sizeof(U32));
+}
+
+void Engine::SampleControllers(U64 now)
+{
+	std::array<U32, Controllers::LaneCount> closes;
+
+	controllers.SetLanes(settings.laneControllers);
+	controllers.Sample(now, controllerLevels, closes);
+
+	//A close cuts the lane's ringing note like a hand on the cymbal, then leaves a short mark of its own
+	for (U32 i = 0; i < Controllers::LaneCount; ++i)
+	{
+		for (U32 close = 0; close < closes[i]; ++close)
+		{
+			Stats& lane = stats[i];
+			ChokeLane(lane, ChokeKeep);
+
+			SpawnNote(lane, LaneColor(i) * 0.5f, settings.kickTexture);
+			ChokeLane(lane, PedalKeep);
+		}
+	}
+}
+
+void Engine::PackIndicators(Vector4* bounds, Vector4* barColors) const
+{
+	bool vertical = settings.scrollDirection == ScrollDirection::Up || settings.scrollDirection == ScrollDirection::Down;
+
+	for (U32 i = 0; i < Controllers::LaneCount; ++i)
+	{
+		F32 level = controllerLevels[i];
+		const Stats& lane = stats[i];
+		const Vector3& color = LaneColor(i);
+
+		//Thinner than a note so notes spawning over it stay readable
+		F32 length = level > 0.0f ? settings.noteWidth * lane.scale * level : 0.0f;
+		F32 thickness = settings.noteHeight * 0.4f;
+
+		bounds[i] = vertical ? Vector4{ lane.spawn.x, lane.spawn.y, length, thickness } :
+			Vector4{ lane.spawn.x, lane.spawn.y, thickness, length };
+		barColors[i] = { color.x, color.y, color.z, 0.8f };
+	}
+}
+
+const Vector3& Engine::LaneColor(U32 lane) const
+{
+	//NoteType order, like the stats
+	const Vector3* laneColors[Controllers::LaneCount] = { &colors.snareColor, &colors.kickColor, &colors.cymbal1Color,
+		&colors.tom1Color, &colors.cymbal2Color, &colors.tom2Color, &colors.cymbal3Color, &colors.tom3Color };
+
+	return *laneColors[lane];
+}
+
+void Engine::SetDefaultTexture(const Texture* texture)
+{
+	defaultTexture = texture;
+}
+
+F64 Engine::GetClockTempo(U64 now) const
+{
+	bool stopped = now > lastClock && Time::ToSeconds(static_cast<I64>(now - lastClock)) > MaxClockInterval;
+	return stopped ? 0.0 : clockTempo;
+}
+
+const Settings& Engine::GetSettings() const
+{
+	return settings;
+}
+
+Controllers& Engine::GetControllers()
+{
+	return controllers;
+}
+
+std::vector<Mapping>& Engine::GetMappings()
+{
+	return mappings;
+}
+
+const std::vector<Mapping>& Engine::GetMappings() const
+{
+	return mappings;
+}
+
+std::array<Stats, 8>& Engine::GetStats()
+{
+	return stats;
+}
+
+const std::vector<Vector3>& Engine::GetOffsets() const
+{
+	return offsets;
+}
+
+const std::vector<U32>& Engine::GetTextureIds() const
+{
+	return textureIds;
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include "Config.hpp"
+#include "Controllers.hpp"
+#include "MidiDispatch.hpp"
+
+#include <array>
+#include <vector>
+
+struct MidiEvent;
+
+/// <summary>
+/// The visualizer's simulation without any GL: matches MIDI to lanes, keeps the per-lane stats and spawns and
+/// scrolls the notes. Reads the settings and colors it's given but never writes them, so any number of engines can
+/// run side by side, each with its own mappings and notes.
+/// </summary>
+class Engine
+{
+public:
+	static constexpr U32 MaxNotes = 200;
+
+	//How much of a note is left after a choke, and of the mark a controller close leaves
+	static constexpr F32 ChokeKeep = 0.35f;
+	static constexpr F32 PedalKeep = 0.3f;
+
+	//MIDI clock runs at 24 clocks to the beat, anything slower than 20 BPM counts as stopped
+	static constexpr F64 ClocksPerBeat = 24.0;
+	static constexpr F64 MaxClockInterval = 60.0 / (20.0 * ClocksPerBeat);
+
+	//Instance attributes are packed as one block, each attribute is a block of MaxNotes elements
+	static constexpr U64 ScalesOffset = MaxNotes * sizeof(Vector3);
+	static constexpr U64 TexCoordOffsetsOffset = ScalesOffset + MaxNotes * sizeof(Vector2);
+	static constexpr U64 TexCoordScalesOffset = TexCoordOffsetsOffset + MaxNotes * sizeof(Vector2);
+	static constexpr U64 ColorsOffset = TexCoordScalesOffset + MaxNotes * sizeof(Vector2);
+	static constexpr U64 TextureIdsOffset = ColorsOffset + MaxNotes * sizeof(Vector3);
+	static constexpr U64 InstanceSize = TextureIdsOffset + MaxNotes * sizeof(U32);
+
+	Engine(const Settings& settings, const ColorProfile& colors);
+
+	Engine(const Engine&) = delete;
+	Engine& operator=(const Engine&) = delete;
+
+	/// <summary>
+	/// Finds the mapping a note-on hits, applying its velocity and overhit thresholds
+	/// </summary>
+	/// <param name="candidates:">The mappings to match against, the hit one has its last hit time updated</param>
+	/// <param name="event:">A message MidiDispatch sorted as NoteOn</param>
+	/// <returns>The mapping hit, nullptr if the note is filtered out</returns>
+	static Mapping* MatchEvent(std::vector<Mapping>& candidates, const MidiEvent& event);
+
+	/// <summary>
+	/// Sorts an event on the channels in the settings, spawning a note for a note-on that hits one of the mappings,
+	/// choking a cymbal lane on aftertouch, or note-off if the settings ask, and feeding control changes to the lane
+	/// controllers
+	/// </summary>
+	/// <returns>True if a note was spawned</returns>
+	bool ProcessEvent(const MidiEvent& event);
+
+	/// <summary>
+	/// Places every lane's spawn point for the current scroll direction and clears the notes on screen
+	/// </summary>
+	/// <param name="width:">Framebuffer width of the visualizer, in pixels</param>
+	/// <param name="height:">Framebuffer height of the visualizer, in pixels</param>
+	/// <param name="statsSize:">Pixels the stats bar takes up when it's shown</param>
+	void Layout(const NoteLayout& layout, I32 width, I32 height, F32 statsSize);
+
+	Vector2 ScrollVelocity(F64 deltaTime) const;
+	void Simulate(Vector2 velocity);
+	void SpawnNote(Stats& lane, const Vector3& color, const Texture* texture);
+	void ClearNotes();
+
+	/// <summary>
+	/// Clears the notes, stats and last hit times, for replays to start from the same state every time
+	/// </summary>
+	void Reset();
+	U64 StateHash() const;
+
+	/// <summary>
+	/// Copies every instance attribute back to back into one block of InstanceSize bytes
+	/// </summary>
+	void PackInstances(U8* destination) const;
+
+	/// <summary>
+	/// Samples the lane controllers for this frame and marks every close on its lane, live input feeds them from its
+	/// own thread so the caller holds whatever lock that takes
+	/// </summary>
+	/// <param name="now:">Current time on the events' clock</param>
+	void SampleControllers(U64 now);
+
+	/// <summary>
+	/// Places a bar at the spawn point of every lane with a controller, as long across the lane as its level
+	/// </summary>
+	/// <param name="bounds:">Gets Controllers::LaneCount centers and half sizes, zero sized for lanes without a level</param>
+	/// <param name="barColors:">Gets Controllers::LaneCount lane colors</param>
+	void PackIndicators(Vector4* bounds, Vector4* barColors) const;
+
+	/// <summary>
+	/// Sets the texture notes get when their lane's texture isn't loaded
+	/// </summary>
+	void SetDefaultTexture(const Texture* texture);
+
+	/// <summary>
+	/// Tempo of the MIDI clock coming in
+	/// </summary>
+	/// <param name="now:">Current time on the events' clock</param>
+	/// <returns>The tempo in BPM, 0 if no clock is running</returns>
+	F64 GetClockTempo(U64 now) const;
+
+	const Settings& GetSettings() const;
+	Controllers& GetControllers();
+	std::vector<Mapping>& GetMappings();
+	const std::vector<Mapping>& GetMappings() const;
+	std::array<Stats, 8>& GetStats();
+	const std::vector<Vector3>& GetOffsets() const;
+	const std::vector<U32>& GetTextureIds() const;
+
+private:
+	void TrackClock(U64 time);
+
+	/// <summary>
+	/// Chokes the cymbal lane a note-off or aftertouch's note is mapped to
+	/// </summary>
+	void Choke(const MidiEvent& event);
+
+	/// <summary>
+	/// Shortens the lane's open note to a fraction of its length, after which it can't be choked again
+	/// </summary>
+	void ChokeLane(Stats& lane, F32 keep);
+
+	/// <summary>
+	/// Cuts a note's trailing end
+	/// </summary>
+	/// <param name="adjustment:">How much shorter the note gets, in clip space</param>
+	/// <param name="cutTexture:">Cuts the texture with the note instead of squashing it</param>
+	void TrimNote(U32 index, F32 adjustment, bool cutTexture);
+
+	const Vector3& LaneColor(U32 lane) const;
+
+	const Settings& settings;
+	const ColorProfile& colors;
+	const Texture* defaultTexture{ nullptr };
+	MidiDispatch dispatch;
+	Controllers controllers;
+	std::array<F32, Controllers::LaneCount> controllerLevels;
+
+	U64 lastClock{ 0 };
+	F64 clockTempo{ 0.0 };
+
+	std::vector<Mapping> mappings;
+	std::array<Stats, 8> stats;
+
+	U32 nextIndex{ 0 };
+	std::vector<Vector3> offsets;
+	std::vector<Vector2> scales;
+	std::vector<Vector2> texCoordOffsets;
+	std::vector<Vector2> texCoordScales;
+	std::vector<Vector3> noteColors;
+	std::vector<U32> textureIds;
+};
\ No newline at end of file
@@ -0,0 +1,349 @@
+#include "EventSource.hpp"
+
+#include "Recorder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+EventSource* EventSource::Create(const std::string& path)
+{
+	std::string ext = path.substr(path.find_last_of('.') + 1);
+
+	EventSource* source = nullptr;
+
+	switch (HashCI(ext.c_str(), ext.length()))
+	{
+	case "mid"_Hash:
+	case "midi"_Hash: { source = new MidiFileSource(); } break;
+	default: { source = new SessionSource(); } break;
+	}
+
+	if (!source->Open(path))
+	{
+		delete source;
+		return nullptr;
+	}
+
+	return source;
+}
+
+const std::vector<MidiEvent>& EventSource::GetEvents() const
+{
+	return events;
+}
+
+const std::vector<SettingEvent>& EventSource::GetSettings() const
+{
+	return settings;
+}
+
+U64 EventSource::GetDuration() const
+{
+	U64 duration = 0;
+	if (!events.empty()) { duration = events.back().time; }
+	if (!settings.empty() && settings.back().time > duration) { duration = settings.back().time; }
+
+	return duration;
+}
+
+std::vector<U8> EventSource::ReadBinary(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<U8>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+static bool ReadVarint(const std::vector<U8>& data, U64& i, U64& value)
+{
+	value = 0;
+
+	for (U32 shift = 0; shift < 64 && i < data.size(); shift += 7)
+	{
+		U8 byte = data[i++];
+		value |= static_cast<U64>(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) { return true; }
+	}
+
+	return false;
+}
+
+static U64 ReadFixed(const std::vector<U8>& data, U64 i, U32 size)
+{
+	U64 value = 0;
+	for (U32 b = 0; b < size; ++b) { value |= static_cast<U64>(data[i + b]) << (b * 8); }
+
+	return value;
+}
+
+bool SessionSource::Open(const std::string& path)
+{
+	std::vector<U8> data = ReadBinary(path);
+
+	if (data.size() < SessionLog::HeaderSize || ReadFixed(data, 0, 4) != SessionLog::Magic)
+	{
+		std::cout << "Not A Session Log: " << path << std::endl;
+		return false;
+	}
+
+	if (ReadFixed(data, 4, 4) > SessionLog::Version)
+	{
+		std::cout << "Session Log Version Not Supported: " << path << std::endl;
+		return false;
+	}
+
+	U64 startTime = ReadFixed(data, 8, 8);
+	U64 lastTime = startTime;
+	U64 i = SessionLog::HeaderSize;
+	U64 syncStart = i;
+
+	//Records are only kept once a sync record with a matching checksum confirms them
+	U64 validEvents = 0;
+	U64 validSettings = 0;
+
+	auto relative = [startTime](U64 time) { return time > startTime ? time - startTime : 0; };
+
+	while (i < data.size())
+	{
+		U64 recordStart = i;
+		U8 tag = data[i++];
+		bool valid = true;
+
+		switch (tag)
+		{
+		case SessionLog::Midi: {
+			U64 delta, size;
+			valid = ReadVarint(data, i, delta) && ReadVarint(data, i, size) && i + size <= data.size();
+			if (!valid) { break; }
+
+			U64 zigzag = (delta >> 1) ^ (~(delta & 1) + 1);
+			lastTime += zigzag;
+
+			//Only channel messages drive the visualizer, long messages are skipped
+			if (size > 0 && size <= 3)
+			{
+				MidiEvent event{};
+				event.time = relative(lastTime);
+				event.size = static_cast<U8>(size);
+				memcpy(event.bytes, data.data() + i, size);
+				events.push_back(event);
+			}
+
+			i += size;
+		} break;
+		case SessionLog::Setting: {
+			U64 delta, keySize, valueSize;
+			valid = ReadVarint(data, i, delta) && ReadVarint(data, i, keySize) && i + keySize <= data.size();
+			if (!valid) { break; }
+
+			SettingEvent setting{};
+			setting.key.assign(reinterpret_cast<const C8*>(data.data() + i), keySize);
+			i += keySize;
+
+			valid = ReadVarint(data, i, valueSize) && i + valueSize <= data.size();
+			if (!valid) { break; }
+
+			setting.value.assign(reinterpret_cast<const C8*>(data.data() + i), valueSize);
+			i += valueSize;
+
+			U64 zigzag = (delta >> 1) ^ (~(delta & 1) + 1);
+			lastTime += zigzag;
+			setting.time = relative(lastTime);
+			settings.push_back(std::move(setting));
+		} break;
+		case SessionLog::Sync: {
+			valid = recordStart + SessionLog::SyncSize <= data.size() && ReadFixed(data, i, 4) == SessionLog::SyncMagic;
+			if (!valid) { break; }
+
+			U32 checksum = 2166136261u;
+			for (U64 b = syncStart; b < recordStart; ++b) { checksum = (checksum ^ data[b]) * 16777619u; }
+
+			valid = checksum == static_cast<U32>(ReadFixed(data, i + 20, 4));
+			if (!valid) { break; }
+
+			lastTime = ReadFixed(data, i + 4, 8);
+			i = recordStart + SessionLog::SyncSize;
+			syncStart = i;
+			validEvents = events.size();
+			validSettings = settings.size();
+		} break;
+		default: { valid = false; } break;
+		}
+
+		if (!valid || tag == SessionLog::Index) { break; }
+	}
+
+	if (validEvents < events.size() || validSettings < settings.size())
+	{
+		std::cout << "Session log was not closed cleanly, dropped " << events.size() - validEvents << " unconfirmed event(s)" << std::endl;
+		events.resize(validEvents);
+		settings.resize(validSettings);
+	}
+
+	//Records from the callback and the UI are interleaved by the writer, replay expects them ordered
+	std::stable_sort(events.begin(), events.end(), [](const MidiEvent& a, const MidiEvent& b) { return a.time < b.time; });
+	std::stable_sort(settings.begin(), settings.end(), [](const SettingEvent& a, const SettingEvent& b) { return a.time < b.time; });
+
+	return true;
+}
+
+static U32 ReadBigEndian(const std::vector<U8>& data, U64 i, U32 size)
+{
+	U32 value = 0;
+	for (U32 b = 0; b < size; ++b) { value = (value << 8) | data[i + b]; }
+
+	return value;
+}
+
+static bool ReadVariableLength(const std::vector<U8>& data, U64& i, U64 end, U32& value)
+{
+	value = 0;
+
+	for (U32 b = 0; b < 4 && i < end; ++b)
+	{
+		U8 byte = data[i++];
+		value = (value << 7) | (byte & 0x7F);
+		if (!(byte & 0x80)) { return true; }
+	}
+
+	return false;
+}
+
+bool MidiFileSource::Open(const std::string& path)
+{
+	std::vector<U8> data = ReadBinary(path);
+
+	if (data.size() < 14 || memcmp(data.data(), "MThd", 4) != 0)
+	{
+		std::cout << "Not A MIDI File: " << path << std::endl;
+		return false;
+	}
+
+	U32 headerSize = ReadBigEndian(data, 4, 4);
+	U32 trackCount = ReadBigEndian(data, 10, 2);
+	U32 division = ReadBigEndian(data, 12, 2);
+
+	struct TimedEvent
+	{
+		U64 tick;
+		MidiEvent event;
+	};
+
+	struct Tempo
+	{
+		U64 tick;
+		U32 microsecondsPerQuarter;
+	};
+
+	std::vector<TimedEvent> timedEvents;
+	std::vector<Tempo> tempos;
+
+	U64 i = 8 + static_cast<U64>(headerSize);
+
+	for (U32 track = 0; track < trackCount && i + 8 <= data.size(); ++track)
+	{
+		U64 chunkSize = ReadBigEndian(data, i + 4, 4);
+		bool isTrack = memcmp(data.data() + i, "MTrk", 4) == 0;
+		i += 8;
+
+		U64 end = i + chunkSize < data.size() ? i + chunkSize : data.size();
+		if (!isTrack) { i = end; --track; continue; }
+
+		U64 tick = 0;
+		U8 runningStatus = 0;
+
+		while (i < end)
+		{
+			U32 delta;
+			if (!ReadVariableLength(data, i, end, delta) || i >= end) { break; }
+			tick += delta;
+
+			U8 status = data[i];
+			if (status & 0x80) { ++i; }
+			else if (runningStatus) { status = runningStatus; }
+			else { break; }
+
+			if (status == 0xFF)
+			{
+				if (i >= end) { break; }
+				U8 type = data[i++];
+				U32 length;
+				if (!ReadVariableLength(data, i, end, length) || i + length > end) { break; }
+
+				if (type == 0x51 && length == 3) { tempos.push_back({ tick, ReadBigEndian(data, i, 3) }); }
+				i += length;
+
+				if (type == 0x2F) { break; }
+			}
+			else if (status == 0xF0 || status == 0xF7)
+			{
+				U32 length;
+				if (!ReadVariableLength(data, i, end, length) || i + length > end) { break; }
+				i += length;
+			}
+			else if (status < 0xF0)
+			{
+				runningStatus = status;
+
+				U8 type = status & 0xF0;
+				U8 size = (type == 0xC0 || type == 0xD0) ? 2 : 3;
+				if (i + size - 1 > end) { break; }
+
+				TimedEvent timed{};
+				timed.tick = tick;
+				timed.event.size = size;
+				timed.event.bytes[0] = status;
+				for (U8 b = 1; b < size; ++b) { timed.event.bytes[b] = data[i++]; }
+
+				timedEvents.push_back(timed);
+			}
+			else { break; }
+		}
+
+		i = end;
+	}
+
+	//Format 1 tracks are merged, stable so events on the same tick keep their track order
+	std::stable_sort(timedEvents.begin(), timedEvents.end(), [](const TimedEvent& a, const TimedEvent& b) { return a.tick < b.tick; });
+	std::stable_sort(tempos.begin(), tempos.end(), [](const Tempo& a, const Tempo& b) { return a.tick < b.tick; });
+
+	events.reserve(timedEvents.size());
+
+	if (division & 0x8000)
+	{
+		//SMPTE division, negative frames per second in the high byte and ticks per frame in the low byte
+		U64 ticksPerSecond = static_cast<U64>(-static_cast<I8>(division >> 8)) * (division & 0xFF);
+		if (ticksPerSecond == 0) { return false; }
+
+		for (TimedEvent& timed : timedEvents)
+		{
+			timed.event.time = timed.tick * 1000000000ull / ticksPerSecond;
+			events.push_back(timed.event);
+		}
+	}
+	else
+	{
+		if (division == 0) { return false; }
+
+		U64 tempoIndex = 0;
+		U64 segmentTick = 0;
+		U64 segmentTime = 0;
+		U64 microsecondsPerQuarter = 500000;
+
+		for (TimedEvent& timed : timedEvents)
+		{
+			while (tempoIndex < tempos.size() && tempos[tempoIndex].tick <= timed.tick)
+			{
+				segmentTime += (tempos[tempoIndex].tick - segmentTick) * microsecondsPerQuarter * 1000ull / division;
+				segmentTick = tempos[tempoIndex].tick;
+				microsecondsPerQuarter = tempos[tempoIndex].microsecondsPerQuarter;
+				++tempoIndex;
+			}
+
+			timed.event.time = segmentTime + (timed.tick - segmentTick) * microsecondsPerQuarter * 1000ull / division;
+			events.push_back(timed.event);
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
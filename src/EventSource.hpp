@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <string>
+#include <vector>
+
+struct MidiEvent
+{
+	U64 time;		//Nanoseconds, host clock for live input, time since the start for recorded sources
+	U8 size;
+	U8 bytes[3];
+};
+
+struct SettingEvent
+{
+	U64 time;
+	std::string key;
+	std::string value;
+};
+
+/// <summary>
+/// A recorded stream of input that can drive the visualizer in place of a MIDI port
+/// </summary>
+class EventSource
+{
+public:
+	virtual ~EventSource() = default;
+
+	/// <summary>
+	/// Creates the source matching a file's extension, .mid/.midi are Standard MIDI Files, anything else a session log
+	/// </summary>
+	/// <param name="path:">The path to the file</param>
+	/// <returns>The opened source, nullptr if the file couldn't be read</returns>
+	static EventSource* Create(const std::string& path);
+
+	virtual bool Open(const std::string& path) = 0;
+
+	const std::vector<MidiEvent>& GetEvents() const;
+	const std::vector<SettingEvent>& GetSettings() const;
+	U64 GetDuration() const;
+
+protected:
+	static std::vector<U8> ReadBinary(const std::string& path);
+
+	std::vector<MidiEvent> events;
+	std::vector<SettingEvent> settings;
+};
+
+/// <summary>
+/// Reads a session log written by Recorder, a log cut short by a crash is read up to its last valid sync record
+/// </summary>
+class SessionSource : public EventSource
+{
+public:
+	bool Open(const std::string& path) override;
+};
+
+/// <summary>
+/// Reads the channel messages of a format 0 or 1 Standard MIDI File, honoring tempo changes
+/// </summary>
+class MidiFileSource : public EventSource
+{
+public:
+	bool Open(const std::string& path) override;
+};
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "FileWatcher.hpp"
+
+#include <chrono>
+#include <thread>
+
+#ifdef DV_PLATFORM_LINUX
+#	include <poll.h>
+#	include <sys/inotify.h>
+#	include <unistd.h>
+#endif
+
+#ifdef DV_PLATFORM_WINDOWS
+struct FileWatcher::Folder
+{
+	static constexpr DWORD Filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+	HANDLE handle{ INVALID_HANDLE_VALUE };
+	OVERLAPPED overlapped{};
+	alignas(DWORD) U8 buffer[BufferSize];
+
+	bool Read()
+	{
+		ResetEvent(overlapped.hEvent);
+		return ReadDirectoryChangesW(handle, buffer, BufferSize, FALSE, Filter, nullptr, &overlapped, nullptr);
+	}
+};
+#else
+struct FileWatcher::Folder
+{
+	I32 watch{ -1 };
+};
+#endif
+
+FileWatcher::FileWatcher() {}
+
+FileWatcher::~FileWatcher()
+{
+	Close();
+}
+
+bool FileWatcher::Add(const std::filesystem::path& path)
+{
+	folders.push_back(std::make_unique<Folder>());
+	Folder& folder = *folders.back();
+
+	std::error_code error;
+	if (!std::filesystem::is_directory(path, error)) { return false; }
+
+#ifdef DV_PLATFORM_WINDOWS
+	folder.handle = CreateFileW(path.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+	if (folder.handle == INVALID_HANDLE_VALUE) { return false; }
+
+	folder.overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+	if (!folder.overlapped.hEvent || !folder.Read())
+	{
+		if (folder.overlapped.hEvent) { CloseHandle(folder.overlapped.hEvent); }
+		CloseHandle(folder.handle);
+		folder.overlapped.hEvent = nullptr;
+		folder.handle = INVALID_HANDLE_VALUE;
+		return false;
+	}
+
+	return true;
+#elif defined DV_PLATFORM_LINUX
+	if (descriptor < 0) { descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC); }
+	if (descriptor < 0) { return false; }
+
+	//Close-write rather than modify, so a file is only reported once it's been written out
+	folder.watch = inotify_add_watch(descriptor, path.c_str(), IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO);
+	return folder.watch >= 0;
+#else
+	return false;
+#endif
+}
+
+bool FileWatcher::Wait(std::vector<FileChange>& changes, U32 timeout)
+{
+	U64 start = changes.size();
+
+#ifdef DV_PLATFORM_WINDOWS
+	HANDLE events[MAXIMUM_WAIT_OBJECTS];
+	DWORD eventCount = 0;
+
+	for (const std::unique_ptr<Folder>& folder : folders)
+	{
+		if (folder->handle != INVALID_HANDLE_VALUE && eventCount < MAXIMUM_WAIT_OBJECTS) { events[eventCount++] = folder->overlapped.hEvent; }
+	}
+
+	if (!eventCount)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+		return false;
+	}
+
+	DWORD result = WaitForMultipleObjects(eventCount, events, FALSE, timeout);
+	if (result == WAIT_TIMEOUT || result == WAIT_FAILED) { return false; }
+
+	//More than one folder can be signaled, so all of them are drained rather than just the one that woke the wait
+	for (U32 i = 0; i < (U32)folders.size(); ++i)
+	{
+		Folder& folder = *folders[i];
+		if (folder.handle == INVALID_HANDLE_VALUE || WaitForSingleObject(folder.overlapped.hEvent, 0) != WAIT_OBJECT_0) { continue; }
+
+		DWORD bytes = 0;
+		if (!GetOverlappedResult(folder.handle, &folder.overlapped, &bytes, FALSE)) { bytes = 0; }
+
+		//Zero bytes means the buffer overflowed and the changes were dropped
+		if (!bytes) { changes.push_back({ i, {} }); }
+
+		U64 offset = 0;
+		while (bytes)
+		{
+			const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(folder.buffer + offset);
+
+			I32 wideLength = (I32)(info->FileNameLength / sizeof(WCHAR));
+			I32 length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, wideLength, nullptr, 0, nullptr, nullptr);
+
+			FileChange change{ i, std::string(length, '\0') };
+			WideCharToMultiByte(CP_UTF8, 0, info->FileName, wideLength, change.name.data(), length, nullptr, nullptr);
+			changes.push_back(std::move(change));
+
+			if (!info->NextEntryOffset) { break; }
+			offset += info->NextEntryOffset;
+		}
+
+		if (!folder.Read())
+		{
+			CloseHandle(folder.overlapped.hEvent);
+			CloseHandle(folder.handle);
+			folder.overlapped.hEvent = nullptr;
+			folder.handle = INVALID_HANDLE_VALUE;
+		}
+	}
+#elif defined DV_PLATFORM_LINUX
+	if (descriptor < 0)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+		return false;
+	}
+
+	pollfd poller{ descriptor, POLLIN, 0 };
+	if (poll(&poller, 1, (I32)timeout) <= 0) { return false; }
+
+	alignas(inotify_event) C8 buffer[BufferSize];
+
+	ssize_t length;
+	while ((length = read(descriptor, buffer, sizeof(buffer))) > 0)
+	{
+		for (ssize_t offset = 0; offset < length;)
+		{
+			const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				for (U32 i = 0; i < (U32)folders.size(); ++i) { changes.push_back({ i, {} }); }
+				continue;
+			}
+
+			for (U32 i = 0; i < (U32)folders.size(); ++i)
+			{
+				if (folders[i]->watch == event->wd)
+				{
+					changes.push_back({ i, event->len ? std::string(event->name) : std::string() });
+					break;
+				}
+			}
+		}
+	}
+#else
+	std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+#endif
+
+	return changes.size() > start;
+}
+
+void FileWatcher::Close()
+{
+#ifdef DV_PLATFORM_WINDOWS
+	for (const std::unique_ptr<Folder>& folder : folders)
+	{
+		if (folder->handle == INVALID_HANDLE_VALUE) { continue; }
+
+		//The pending read writes into the folder's buffer, it has to finish before the buffer goes away
+		DWORD bytes;
+		CancelIoEx(folder->handle, &folder->overlapped);
+		GetOverlappedResult(folder->handle, &folder->overlapped, &bytes, TRUE);
+
+		CloseHandle(folder->overlapped.hEvent);
+		CloseHandle(folder->handle);
+	}
+#elif defined DV_PLATFORM_LINUX
+	if (descriptor >= 0) { close(descriptor); }
+	descriptor = -1;
+#endif
+
+	folders.clear();
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct FileChange
+{
+	U32 folder;			//Index of the folder in the order it was added
+	std::string name;	//File name inside the folder, empty when changes were lost and the whole folder has to be rescanned
+};
+
+/// <summary>
+/// Watches folders for files being written, created, renamed or deleted. Uses ReadDirectoryChangesW on Windows
+/// and inotify on Linux, folders aren't watched recursively so every folder of interest is added on its own.
+/// </summary>
+class FileWatcher
+{
+public:
+	FileWatcher();
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	/// <summary>
+	/// Starts watching a folder, it keeps its index even if it can't be watched
+	/// </summary>
+	/// <returns>False if the folder doesn't exist or the platform has no way to watch it</returns>
+	bool Add(const std::filesystem::path& folder);
+
+	/// <summary>
+	/// Blocks until a watched folder changes or the timeout passes
+	/// </summary>
+	/// <param name="changes:">Gets every change that came in appended, the same file can show up more than once</param>
+	/// <param name="timeout:">Milliseconds to wait</param>
+	/// <returns>True if anything changed</returns>
+	bool Wait(std::vector<FileChange>& changes, U32 timeout);
+	void Close();
+
+private:
+	static constexpr U32 BufferSize = 16384;
+
+	struct Folder;
+
+	std::vector<std::unique_ptr<Folder>> folders;
+#ifdef DV_PLATFORM_LINUX
+	I32 descriptor{ -1 };
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "FrameArena.hpp"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+FrameArena::Block FrameArena::blocks[2];
+U32 FrameArena::current = 0;
+U64 FrameArena::overflowCount = 0;
+
+bool FrameArena::Initialize(U64 capacity)
+{
+	for (Block& block : blocks)
+	{
+		block.memory = static_cast<U8*>(std::malloc(capacity));
+		if (block.memory == nullptr)
+		{
+			std::cout << "Failed To Allocate Frame Arena!" << std::endl;
+			return false;
+		}
+
+		block.capacity = capacity;
+		block.overflow.reserve(16);
+	}
+
+	return true;
+}
+
+void FrameArena::Shutdown()
+{
+	for (Block& block : blocks)
+	{
+		for (void* memory : block.overflow) { std::free(memory); }
+		block.overflow.clear();
+
+		std::free(block.memory);
+		block.memory = nullptr;
+		block.capacity = 0;
+		block.offset = 0;
+		block.requested = 0;
+	}
+}
+
+void FrameArena::BeginFrame()
+{
+	current ^= 1;
+	Block& block = blocks[current];
+
+	for (void* memory : block.overflow) { std::free(memory); }
+	block.overflow.clear();
+
+	if (block.requested > block.capacity)
+	{
+		U64 capacity = block.capacity ? block.capacity : DefaultCapacity;
+		while (capacity < block.requested) { capacity *= 2; }
+
+		if (U8* memory = static_cast<U8*>(std::realloc(block.memory, capacity)))
+		{
+			block.memory = memory;
+			block.capacity = capacity;
+		}
+	}
+
+	block.offset = 0;
+	block.requested = 0;
+}
+
+void* FrameArena::Allocate(U64 size, U64 alignment)
+{
+	Block& block = blocks[current];
+
+	U64 start = (block.offset + alignment - 1) & ~(alignment - 1);
+
+	if (start + size <= block.capacity)
+	{
+		block.requested += start + size - block.offset;
+		block.offset = start + size;
+		return block.memory + start;
+	}
+
+	block.requested += size + alignment;
+
+	//Keeps the arena usable when it's undersized, alignment is covered as malloc aligns for any standard type
+	++overflowCount;
+	void* memory = std::malloc(size ? size : 1);
+	if (memory == nullptr) { throw std::bad_alloc(); }
+
+	block.overflow.push_back(memory);
+	return memory;
+}
+
+const C8* FrameArena::Format(const C8* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	va_list copy;
+	va_copy(copy, args);
+
+	Block& block = blocks[current];
+	U64 available = block.capacity > block.offset ? block.capacity - block.offset : 0;
+	C8* text = reinterpret_cast<C8*>(block.memory + block.offset);
+
+	I32 length = vsnprintf(text, available, format, args);
+	va_end(args);
+
+	if (length < 0)
+	{
+		va_end(copy);
+		return "";
+	}
+
+	if (static_cast<U64>(length) < available) { text = static_cast<C8*>(Allocate(length + 1, 1)); }
+	else
+	{
+		text = static_cast<C8*>(Allocate(length + 1, 1));
+		vsnprintf(text, length + 1, format, copy);
+	}
+
+	va_end(copy);
+	return text;
+}
+
+U64 FrameArena::GetUsed()
+{
+	return blocks[current].offset;
+}
+
+U64 FrameArena::GetCapacity()
+{
+	return blocks[current].capacity;
+}
+
+U64 FrameArena::GetOverflowCount()
+{
+	return overflowCount;
+}
\ No newline at end of file
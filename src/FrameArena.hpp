@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/// <summary>
+/// Per-frame bump allocator for transient memory, reset at the start of every main loop iteration. It's double
+/// buffered, memory handed out during a frame stays valid until the end of the next one, so anything the GPU
+/// still reads after the frame is submitted can live here too.
+/// </summary>
+class FrameArena
+{
+public:
+	static bool Initialize(U64 capacity = DefaultCapacity);
+	static void Shutdown();
+
+	/// <summary>
+	/// Switches to the other block and releases everything allocated from it two frames ago
+	/// </summary>
+	static void BeginFrame();
+
+	/// <summary>
+	/// Bumps memory off the current block, falling back to the heap when it's full. The block grows to fit at
+	/// its next reset, so the fallback only happens while warming up.
+	/// </summary>
+	static void* Allocate(U64 size, U64 alignment = alignof(std::max_align_t));
+
+	template<class Type>
+	static Type* Allocate(U64 count = 1)
+	{
+		static_assert(std::is_trivially_destructible_v<Type>, "Frame arena memory is never destructed");
+
+		Type* memory = static_cast<Type*>(Allocate(count * sizeof(Type), alignof(Type)));
+		for (U64 i = 0; i < count; ++i) { new (memory + i) Type; }
+		return memory;
+	}
+
+	/// <summary>
+	/// printf into frame memory, for ImGui labels and the like
+	/// </summary>
+	static const C8* Format(const C8* format, ...);
+
+	static U64 GetUsed();
+	static U64 GetCapacity();
+	static U64 GetOverflowCount();
+
+	static constexpr U64 DefaultCapacity = 64 * 1024;
+
+private:
+	struct Block
+	{
+		U8* memory{ nullptr };
+		U64 capacity{ 0 };
+		U64 offset{ 0 };
+		U64 requested{ 0 };
+		std::vector<void*> overflow;
+	};
+
+	static Block blocks[2];
+	static U32 current;
+	static U64 overflowCount;
+
+	STATIC_CLASS(FrameArena)
+};
\ No newline at end of file
@@ -1,8 +1,8 @@
 #pragma once
 
-#include "imgui\imgui.h"
-#include "imgui\imgui_impl_glfw.h"
-#include "imgui\imgui_impl_opengl3.h"
+#include "imgui/imgui.h"
+#include "imgui/imgui_impl_glfw.h"
+#include "imgui/imgui_impl_opengl3.h"
 
-#include "glad\glad.h"
-#include "glfw\glfw3.h"
\ No newline at end of file
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Defines.hpp"
+
+/// <summary>
+/// Log-linear histogram in the style of HdrHistogram, every power of two range is split into 16 linear
+/// buckets, so any recorded value is reported within 1/16th of itself. Recording never allocates.
+/// </summary>
+struct Histogram
+{
+	void Record(U64 value)
+	{
+		++counts[BucketIndex(value)];
+		++total;
+		if (value < minimum) { minimum = value; }
+		if (value > maximum) { maximum = value; }
+	}
+
+	void Reset()
+	{
+		for (U64& count : counts) { count = 0; }
+		total = 0;
+		minimum = U64_MAX;
+		maximum = 0;
+	}
+
+	/// <summary>
+	/// Gets the value below which a percentage of the recorded values fall
+	/// </summary>
+	/// <param name="percentile:">The percentile, 0.0 to 100.0</param>
+	/// <returns>The highest value equivalent to the percentile's bucket</returns>
+	U64 Percentile(F64 percentile) const
+	{
+		if (total == 0) { return 0; }
+
+		U64 target = static_cast<U64>(percentile / 100.0 * total + 0.5);
+		if (target < 1) { target = 1; }
+		if (target > total) { target = total; }
+
+		U64 count = 0;
+		for (U32 i = 0; i < BucketCount; ++i)
+		{
+			count += counts[i];
+			if (count >= target)
+			{
+				U64 value = BucketMax(i);
+				return value < maximum ? value : maximum;
+			}
+		}
+
+		return maximum;
+	}
+
+	U64 Total() const { return total; }
+	U64 Min() const { return total ? minimum : 0; }
+	U64 Max() const { return maximum; }
+
+	static constexpr U32 SubBucketBits = 4;
+	static constexpr U32 SubBucketCount = 1 << SubBucketBits;
+	static constexpr U32 BucketCount = (64 - SubBucketBits + 1) * SubBucketCount;
+
+private:
+	static U32 BucketIndex(U64 value)
+	{
+		if (value < SubBucketCount) { return static_cast<U32>(value); }
+
+		U32 exponent = SubBucketBits;
+		while (value >> (exponent + 1)) { ++exponent; }
+
+		U32 sub = static_cast<U32>(value >> (exponent - SubBucketBits)) & (SubBucketCount - 1);
+		return (exponent - SubBucketBits + 1) * SubBucketCount + sub;
+	}
+
+	static U64 BucketMax(U32 index)
+	{
+		if (index < SubBucketCount) { return index; }
+
+		U32 exponent = index / SubBucketCount + SubBucketBits - 1;
+		U64 sub = index % SubBucketCount;
+		return ((SubBucketCount + sub + 1) << (exponent - SubBucketBits)) - 1;
+	}
+
+	U64 counts[BucketCount]{};
+	U64 total{ 0 };
+	U64 minimum{ U64_MAX };
+	U64 maximum{ 0 };
+};
\ No newline at end of file
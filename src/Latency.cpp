@@ -0,0 +1,187 @@
+#include "Latency.hpp"
+
+#include "Time.hpp"
+
+#include "GraphicsInclude.hpp"
+
+#include <fstream>
+#include <iostream>
+
+Histogram Latency::histograms[(U32)LatencyStage::Count];
+U64 Latency::callbackTimes[MaxFrameEvents];
+U32 Latency::eventCount = 0;
+U64 Latency::uploadTime = 0;
+Latency::GpuFrame Latency::gpuFrames[QueryFrames];
+U32 Latency::nextGpuFrame = 0;
+I64 Latency::gpuOffset = 0;
+U64 Latency::lastCalibration = 0;
+bool Latency::gpuTimestamps = false;
+
+static const C8* stageNames[] = { "Drain", "Upload", "Swap", "GPU" };
+
+bool Latency::Initialize()
+{
+	//Query objects aren't shared between contexts, everything here runs with the visualizer window's context current
+	gpuTimestamps = glQueryCounter && glGetQueryObjectui64v && glGetInteger64v;
+
+	if (gpuTimestamps)
+	{
+		for (GpuFrame& frame : gpuFrames)
+		{
+			glGenQueries(1, &frame.query);
+			frame.eventCount = 0;
+		}
+
+		Calibrate();
+	}
+#ifdef DV_DEBUG
+	else
+	{
+		std::cout << "GL_TIMESTAMP queries unavailable, GPU latency will not be measured" << std::endl;
+	}
+#endif
+
+	return true;
+}
+
+void Latency::Shutdown()
+{
+	if (gpuTimestamps)
+	{
+		for (GpuFrame& frame : gpuFrames) { glDeleteQueries(1, &frame.query); }
+	}
+}
+
+void Latency::AddEvent(U64 callbackTime, U64 drainTime)
+{
+	histograms[(U32)LatencyStage::Drain].Record(drainTime - callbackTime);
+
+	if (eventCount < MaxFrameEvents) { callbackTimes[eventCount++] = callbackTime; }
+}
+
+void Latency::MarkUpload()
+{
+	if (eventCount == 0) { return; }
+
+	uploadTime = Time::Now();
+
+	Histogram& histogram = histograms[(U32)LatencyStage::Upload];
+	for (U32 i = 0; i < eventCount; ++i) { histogram.Record(uploadTime - callbackTimes[i]); }
+}
+
+void Latency::MarkDraw()
+{
+	if (eventCount == 0 || !gpuTimestamps) { return; }
+
+	//If the GPU is more than QueryFrames behind this frame's samples are skipped rather than stalling on a query
+	GpuFrame& frame = gpuFrames[nextGpuFrame];
+	if (frame.eventCount != 0) { return; }
+
+	glQueryCounter(frame.query, GL_TIMESTAMP);
+
+	frame.eventCount = eventCount;
+	for (U32 i = 0; i < eventCount; ++i) { frame.callbackTimes[i] = callbackTimes[i]; }
+
+	nextGpuFrame = (nextGpuFrame + 1) % QueryFrames;
+}
+
+void Latency::MarkPresent()
+{
+	if (gpuTimestamps) { ResolveQueries(); }
+
+	if (eventCount == 0) { return; }
+
+	U64 now = Time::Now();
+
+	Histogram& histogram = histograms[(U32)LatencyStage::Swap];
+	for (U32 i = 0; i < eventCount; ++i) { histogram.Record(now - callbackTimes[i]); }
+
+	eventCount = 0;
+}
+
+void Latency::Reset()
+{
+	for (Histogram& histogram : histograms) { histogram.Reset(); }
+}
+
+bool Latency::ExportReport(const std::string& path)
+{
+	std::ofstream output(path);
+	if (!output.is_open())
+	{
+		std::cout << "Failed To Write Latency Report: " << path << std::endl;
+		return false;
+	}
+
+	output << "stage,count,min_ms,p50_ms,p90_ms,p99_ms,p99.9_ms,max_ms\n";
+
+	for (U32 i = 0; i < (U32)LatencyStage::Count; ++i)
+	{
+		const Histogram& histogram = histograms[i];
+
+		output << stageNames[i] << ',' << histogram.Total() << ',' <<
+			Time::ToMilliseconds(histogram.Min()) << ',' <<
+			Time::ToMilliseconds(histogram.Percentile(50.0)) << ',' <<
+			Time::ToMilliseconds(histogram.Percentile(90.0)) << ',' <<
+			Time::ToMilliseconds(histogram.Percentile(99.0)) << ',' <<
+			Time::ToMilliseconds(histogram.Percentile(99.9)) << ',' <<
+			Time::ToMilliseconds(histogram.Max()) << '\n';
+	}
+
+	output.flush();
+	output.close();
+
+#ifdef DV_DEBUG
+	std::cout << "Latency report written to: " << path << std::endl;
+#endif
+
+	return true;
+}
+
+const Histogram& Latency::GetHistogram(LatencyStage stage)
+{
+	return histograms[(U32)stage];
+}
+
+const C8* Latency::GetStageName(LatencyStage stage)
+{
+	return stageNames[(U32)stage];
+}
+
+void Latency::ResolveQueries()
+{
+	Histogram& histogram = histograms[(U32)LatencyStage::Gpu];
+
+	for (GpuFrame& frame : gpuFrames)
+	{
+		if (frame.eventCount == 0) { continue; }
+
+		I32 available = 0;
+		glGetQueryObjectiv(frame.query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) { continue; }
+
+		GLuint64 gpuTime = 0;
+		glGetQueryObjectui64v(frame.query, GL_QUERY_RESULT, &gpuTime);
+
+		//The GPU clock drifts from the host clock, keep the mapping between them fresh
+		if (Time::Now() - lastCalibration > 1000000000) { Calibrate(); }
+
+		U64 cpuTime = static_cast<U64>(static_cast<I64>(gpuTime) + gpuOffset);
+
+		for (U32 i = 0; i < frame.eventCount; ++i)
+		{
+			histogram.Record(cpuTime > frame.callbackTimes[i] ? cpuTime - frame.callbackTimes[i] : 0);
+		}
+
+		frame.eventCount = 0;
+	}
+}
+
+void Latency::Calibrate()
+{
+	GLint64 gpuNow = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+
+	lastCalibration = Time::Now();
+	gpuOffset = static_cast<I64>(lastCalibration) - static_cast<I64>(gpuNow);
+}
\ No newline at end of file
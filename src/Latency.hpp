@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include "Histogram.hpp"
+
+#include <string>
+
+enum class LatencyStage
+{
+	Drain,		//Callback entry to the main loop taking the event off the queue
+	Upload,		//Callback entry to the instance buffers being uploaded in Renderer::Update
+	Swap,		//Callback entry to glfwSwapBuffers returning for the visualizer window
+	Gpu,		//Callback entry to the GPU finishing the note draw, from a GL_TIMESTAMP query
+
+	Count
+};
+
+/// <summary>
+/// Measures how long a hit takes to reach the screen, everything runs on the render thread
+/// </summary>
+class Latency
+{
+public:
+	static bool Initialize();
+	static void Shutdown();
+
+	/// <summary>
+	/// Tracks an event that spawned a note this frame
+	/// </summary>
+	/// <param name="callbackTime:">Host time the MIDI callback received the event</param>
+	/// <param name="drainTime:">Host time the event was taken off the input queue</param>
+	static void AddEvent(U64 callbackTime, U64 drainTime);
+	static void MarkUpload();
+	static void MarkDraw();
+	static void MarkPresent();
+
+	static void Reset();
+	static bool ExportReport(const std::string& path);
+
+	static const Histogram& GetHistogram(LatencyStage stage);
+	static const C8* GetStageName(LatencyStage stage);
+
+private:
+	static void ResolveQueries();
+	static void Calibrate();
+
+	static constexpr U32 MaxFrameEvents = 64;
+	static constexpr U32 QueryFrames = 4;
+
+	struct GpuFrame
+	{
+		U32 query;
+		U32 eventCount;
+		U64 callbackTimes[MaxFrameEvents];
+	};
+
+	static Histogram histograms[(U32)LatencyStage::Count];
+	static U64 callbackTimes[MaxFrameEvents];
+	static U32 eventCount;
+	static U64 uploadTime;
+	static GpuFrame gpuFrames[QueryFrames];
+	static U32 nextGpuFrame;
+	static I64 gpuOffset;
+	static U64 lastCalibration;
+	static bool gpuTimestamps;
+
+	STATIC_CLASS(Latency)
+};
\ No newline at end of file
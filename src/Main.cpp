@@ -1,17 +1,46 @@
 #include "Defines.hpp"
 
 #include "Visualizer.hpp"
+#include "Analysis.hpp"
+
+#include <cstdlib>
+#include <string>
 
 //#ifdef DV_RELEASE
 //int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
 //#else
-int main()
+int main(int argc, char** argv)
 //#endif
 {
-	if (!Visualizer::Initialize())
+	LaunchOptions options{};
+	AnalysisOptions analysis{};
+
+	for (I32 i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--replay" && i + 1 < argc) { options.replayPath = argv[++i]; }
+		else if (arg == "--speed" && i + 1 < argc)
+		{
+			std::string speed = argv[++i];
+			options.replaySpeed = speed == "max" ? 0.0 : std::atof(speed.c_str());
+		}
+		else if (arg == "--exit-after-replay") { options.exitAfterReplay = true; }
+		else if (arg == "--trace" && i + 1 < argc) { options.tracePath = argv[++i]; }
+		else if (arg == "--stress" && i + 1 < argc) { options.stressRate = static_cast<F32>(std::atof(argv[++i])); }
+		else if (arg == "--stress-duration" && i + 1 < argc) { options.stressDuration = static_cast<F32>(std::atof(argv[++i])); }
+		else if (arg == "--check-allocations") { options.checkAllocations = true; }
+		else if (arg == "--raw-midi" && i + 1 < argc) { options.rawMidiDevice = argv[++i]; }
+		else { Analysis::ParseArgument(argc, argv, i, analysis); }
+	}
+
+	//Batch analysis never opens a window, it runs and exits
+	if (!analysis.inputs.empty()) { return Analysis::Run(analysis); }
+
+	if (!Visualizer::Initialize(options))
 	{
 		return -1;
 	}
 
 	return 0;
-}
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "MidiDispatch.hpp"
+
+MidiDispatch::MidiDispatch() : channels{ 0 }
+{
+	//Starts from a mask no setting can have, so the first SetChannels always builds the table
+	for (std::atomic<MidiMessage>& entry : table) { entry.store(MidiMessage::Ignored, std::memory_order_relaxed); }
+	channels.store(static_cast<U16>(~DefaultChannels), std::memory_order_relaxed);
+	SetChannels(DefaultChannels);
+}
+
+void MidiDispatch::SetChannels(U16 mask)
+{
+	if (mask == channels.load(std::memory_order_relaxed)) { return; }
+
+	U16 read = mask ? mask : 0xFFFF;
+
+	for (U32 status = 0x80; status < 0xF0; ++status)
+	{
+		MidiMessage message = MidiMessage::Ignored;
+
+		if (read & (1 << (status & 0x0F)))
+		{
+			switch (status & 0xF0)
+			{
+			case 0x80: { message = MidiMessage::NoteOff; } break;
+			case 0x90: { message = MidiMessage::NoteOn; } break;
+			case 0xA0: { message = MidiMessage::PolyAftertouch; } break;
+			case 0xB0: { message = MidiMessage::ControlChange; } break;
+			default: break;
+			}
+		}
+
+		table[status].store(message, std::memory_order_relaxed);
+	}
+
+	table[0xF8].store(MidiMessage::Clock, std::memory_order_relaxed);
+	channels.store(mask, std::memory_order_relaxed);
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include "EventSource.hpp"
+
+#include <atomic>
+
+/// <summary>
+/// What a MIDI message is to the visualizer, anything it has no use for is Ignored
+/// </summary>
+enum class MidiMessage : U8
+{
+	Ignored,
+	NoteOn,
+	NoteOff,
+	PolyAftertouch,
+	ControlChange,
+	Clock
+};
+
+/// <summary>
+/// Sorts messages by their status byte with a single lookup into a 256 entry table, built from the channels notes are
+/// read on. Channel messages on other channels, system messages other than clock and stray data bytes all land on
+/// Ignored, so the traffic a kit streams that the visualizer doesn't use costs a load and a compare. The entries are
+/// atomic so the table can be rebuilt while an input thread is reading it, a message racing a rebuild is sorted by
+/// either the old channels or the new ones.
+/// </summary>
+class MidiDispatch
+{
+public:
+	/// <summary>
+	/// Channels 1 and 10, the General MIDI drum channel
+	/// </summary>
+	static constexpr U16 DefaultChannels = 0x0201;
+
+	MidiDispatch();
+
+	MidiDispatch(const MidiDispatch&) = delete;
+	MidiDispatch& operator=(const MidiDispatch&) = delete;
+
+	/// <summary>
+	/// Rebuilds the table, does nothing if the channels haven't changed
+	/// </summary>
+	/// <param name="channels:">Bit n set reads channel n + 1, 0 reads every channel</param>
+	void SetChannels(U16 channels);
+	U16 GetChannels() const { return channels.load(std::memory_order_relaxed); }
+
+	MidiMessage Classify(U8 status) const { return table[status].load(std::memory_order_relaxed); }
+
+	/// <summary>
+	/// Sorts a whole message, a note-on with no velocity is a note-off and channel messages missing data are Ignored
+	/// </summary>
+	MidiMessage Classify(const MidiEvent& event) const
+	{
+		MidiMessage message = Classify(event.bytes[0]);
+
+		if (message == MidiMessage::Clock || message == MidiMessage::Ignored) { return message; }
+		if (event.size < 3) { return MidiMessage::Ignored; }
+
+		return message == MidiMessage::NoteOn && event.bytes[2] == 0 ? MidiMessage::NoteOff : message;
+	}
+
+private:
+	std::atomic<MidiMessage> table[256];
+	std::atomic<U16> channels;
+};
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "Parser.hpp"
+
+#include <charconv>
+
+bool IniReader::Next(IniLine& line)
+{
+	while (position < data.size())
+	{
+		std::string_view text = Parser::Trim(Parser::NextLine(data, position));
+
+		if (text.empty() || text[0] == ';' || text[0] == '#') { continue; }
+
+		if (text[0] == '[')
+		{
+			U64 end = text.find(']');
+			if (end == std::string_view::npos) { continue; }
+
+			line.type = IniLineType::Section;
+			line.name = Parser::Trim(text.substr(1, end - 1));
+			line.value = {};
+			return true;
+		}
+
+		U64 equals = text.find('=');
+		if (equals == std::string_view::npos) { continue; }
+
+		line.type = IniLineType::Value;
+		line.name = Parser::Trim(text.substr(0, equals));
+		line.value = Parser::Trim(text.substr(equals + 1));
+		return true;
+	}
+
+	return false;
+}
+
+bool YamlReader::Next(YamlLine& line)
+{
+	while (position < data.size())
+	{
+		std::string_view text = Parser::NextLine(data, position);
+
+		U32 indent = 0;
+		while (indent < text.size() && (text[indent] == ' ' || text[indent] == '\t')) { ++indent; }
+
+		text = Parser::Trim(text.substr(indent));
+		if (text.empty() || text[0] == '#' || text == "---") { continue; }
+
+		line.item = text[0] == '-' && (text.size() == 1 || text[1] == ' ');
+		if (line.item)
+		{
+			std::string_view rest = text.substr(1);
+			U64 spaces = rest.find_first_not_of(' ');
+			indent += static_cast<U32>(spaces == std::string_view::npos ? rest.size() + 1 : spaces + 1);
+			text = Parser::Trim(rest);
+		}
+
+		line.indent = indent;
+
+		//A key ends at a colon followed by a space or the line end, so times like 1:30 stay values
+		U64 colon = 0;
+		while ((colon = text.find(':', colon)) != std::string_view::npos && colon + 1 < text.size() && text[colon + 1] != ' ') { ++colon; }
+
+		if (colon == std::string_view::npos)
+		{
+			if (!line.item) { continue; }
+
+			line.key = {};
+			line.value = text;
+		}
+		else
+		{
+			line.key = Parser::Trim(text.substr(0, colon));
+			line.value = Parser::Trim(text.substr(colon + 1));
+		}
+
+		if (line.value.size() >= 2 && (line.value[0] == '"' || line.value[0] == '\'') && line.value.back() == line.value[0])
+		{
+			line.value = line.value.substr(1, line.value.size() - 2);
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+I32 Parser::ToI32(std::string_view text, I32 defaultValue)
+{
+	text = NumberStart(text);
+
+	I32 value;
+	std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+
+	return result.ec == std::errc() ? value : defaultValue;
+}
+
+U64 Parser::ToU64(std::string_view text, I32 base, U64 defaultValue)
+{
+	text = NumberStart(text);
+	if (base == 16 && text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) { text.remove_prefix(2); }
+
+	U64 value;
+	std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value, base);
+
+	return result.ec == std::errc() ? value : defaultValue;
+}
+
+F32 Parser::ToF32(std::string_view text, F32 defaultValue)
+{
+	text = NumberStart(text);
+
+	F32 value;
+	std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+
+	return result.ec == std::errc() ? value : defaultValue;
+}
+
+F64 Parser::ToF64(std::string_view text, F64 defaultValue)
+{
+	text = NumberStart(text);
+
+	F64 value;
+	std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+
+	return result.ec == std::errc() ? value : defaultValue;
+}
+
+std::string_view Parser::Trim(std::string_view text)
+{
+	U64 start = 0;
+	U64 end = text.size();
+
+	while (start < end && (text[start] == ' ' || text[start] == '\t')) { ++start; }
+	while (end > start && (text[end - 1] == ' ' || text[end - 1] == '\t' || text[end - 1] == '\r')) { --end; }
+
+	return text.substr(start, end - start);
+}
+
+bool Parser::ContainsCI(std::string_view text, std::string_view word)
+{
+	if (word.size() > text.size()) { return false; }
+
+	for (U64 i = 0; i + word.size() <= text.size(); ++i)
+	{
+		U64 j = 0;
+		for (; j < word.size(); ++j)
+		{
+			C8 a = text[i + j];
+			C8 b = word[j];
+			if (a > 64 && a < 91) { a += 32; }
+			if (b > 64 && b < 91) { b += 32; }
+			if (a != b) { break; }
+		}
+
+		if (j == word.size()) { return true; }
+	}
+
+	return false;
+}
+
+std::string_view Parser::NextLine(std::string_view data, U64& position)
+{
+	U64 start = position;
+	U64 end = data.find('\n', start);
+
+	if (end == std::string_view::npos) { end = data.size(); }
+
+	position = end + 1;
+
+	if (end > start && data[end - 1] == '\r') { --end; }
+
+	return data.substr(start, end - start);
+}
+
+std::string_view Parser::NumberStart(std::string_view text)
+{
+	text = Trim(text);
+	if (!text.empty() && text[0] == '+') { text.remove_prefix(1); }
+
+	return text;
+}
\ No newline at end of file
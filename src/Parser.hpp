@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <string_view>
+
+enum class IniLineType
+{
+	Section,
+	Value
+};
+
+struct IniLine
+{
+	IniLineType type;
+	std::string_view name;		//The section name or key
+	std::string_view value;		//Empty for sections
+};
+
+/// <summary>
+/// Single pass reader for the INI subset Clone Hero and settings.cfg use, [section] headers and key = value lines.
+/// Blank lines, ; and # comments and lines without '=' are skipped, names and values come back trimmed. Lines are
+/// views into the data, nothing is copied.
+/// </summary>
+class IniReader
+{
+public:
+	IniReader(std::string_view data) : data{ data } {}
+
+	/// <summary>
+	/// Reads the next section header or value
+	/// </summary>
+	/// <returns>False once the data runs out</returns>
+	bool Next(IniLine& line);
+
+private:
+	std::string_view data;
+	U64 position{ 0 };
+};
+
+struct YamlLine
+{
+	U32 indent;					//Column of the key, past any "- "
+	bool item;					//The line starts a list item
+	std::string_view key;		//Empty for a plain scalar list item
+	std::string_view value;		//Empty for a key opening a block
+};
+
+/// <summary>
+/// Single pass reader for the block YAML subset of Clone Hero's MIDI profiles, one key: value per line with
+/// "- " list items. Flow collections and multi-line scalars aren't supported. Lines are views into the data,
+/// nothing is copied.
+/// </summary>
+class YamlReader
+{
+public:
+	YamlReader(std::string_view data) : data{ data } {}
+
+	/// <summary>
+	/// Reads the next non-empty, non-comment line
+	/// </summary>
+	/// <returns>False once the data runs out</returns>
+	bool Next(YamlLine& line);
+
+private:
+	std::string_view data;
+	U64 position{ 0 };
+};
+
+/// <summary>
+/// Allocation and exception free conversions for the readers' views, malformed or out of range text gives the
+/// default value. Leading whitespace and a '+' are accepted and trailing text is ignored, like std::stoi.
+/// </summary>
+class Parser
+{
+public:
+	static I32 ToI32(std::string_view text, I32 defaultValue);
+	static U64 ToU64(std::string_view text, I32 base, U64 defaultValue);
+	static F32 ToF32(std::string_view text, F32 defaultValue);
+	static F64 ToF64(std::string_view text, F64 defaultValue);
+
+	static std::string_view Trim(std::string_view text);
+
+	/// <summary>
+	/// Case insensitive substring search, for matching keys that vary between versions
+	/// </summary>
+	static bool ContainsCI(std::string_view text, std::string_view word);
+
+	/// <summary>
+	/// Gets the line starting at position without its line ending and moves position past it
+	/// </summary>
+	static std::string_view NextLine(std::string_view data, U64& position);
+
+private:
+	static std::string_view NumberStart(std::string_view text);
+
+	STATIC_CLASS(Parser);
+};
\ No newline at end of file
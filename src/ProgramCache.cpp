@@ -0,0 +1,176 @@
+#include "ProgramCache.hpp"
+
+#include "GraphicsInclude.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+U32 ProgramCache::Load(const std::string& name, const std::string& vertexSource, const std::string& fragmentSource)
+{
+	I32 formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+	//Drivers without binary formats can't cache anything
+	if (formats == 0) { return Compile(vertexSource, fragmentSource); }
+
+	std::string key = vertexSource;
+	key += '\0';
+	key += fragmentSource;
+	key += '\0';
+	key += reinterpret_cast<const C8*>(glGetString(GL_VENDOR));
+	key += '\0';
+	key += reinterpret_cast<const C8*>(glGetString(GL_RENDERER));
+	key += '\0';
+	key += reinterpret_cast<const C8*>(glGetString(GL_VERSION));
+
+	U64 hash = Hash(key.c_str(), key.length());
+	std::string path = std::string(CacheFolder) + "/" + name + ".bin";
+
+	U32 program = LoadBinary(path, hash, key.length());
+	if (program) { return program; }
+
+	program = Compile(vertexSource, fragmentSource);
+	if (program) { SaveBinary(path, hash, key.length(), program); }
+
+	return program;
+}
+
+U32 ProgramCache::Compile(const std::string& vertexSource, const std::string& fragmentSource)
+{
+	U32 vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+	if (!vertexShader) { return 0; }
+
+	U32 fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+	if (!fragmentShader)
+	{
+		glDeleteShader(vertexShader);
+		return 0;
+	}
+
+	U32 program = glCreateProgram();
+	glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glAttachShader(program, vertexShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
+
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	I32 success;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		C8 infoLog[512];
+		glGetProgramInfoLog(program, 512, NULL, infoLog);
+		std::cout << "Shader program linking failed: " << infoLog << std::endl;
+		glDeleteProgram(program);
+		return 0;
+	}
+
+	return program;
+}
+
+U32 ProgramCache::CompileShader(U32 type, const std::string& source)
+{
+	const C8* sourceString = source.c_str();
+	U32 shader = glCreateShader(type);
+	glShaderSource(shader, 1, &sourceString, NULL);
+	glCompileShader(shader);
+
+	I32 success;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		C8 infoLog[512];
+		glGetShaderInfoLog(shader, 512, NULL, infoLog);
+		std::cout << (type == GL_VERTEX_SHADER ? "Vertex" : "Fragment") << " shader compilation failed: " << infoLog << std::endl;
+		glDeleteShader(shader);
+		return 0;
+	}
+
+	return shader;
+}
+
+U32 ProgramCache::LoadBinary(const std::string& path, U64 key, U64 keyLength)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) { return 0; }
+
+	CacheHeader header{};
+	file.read(reinterpret_cast<C8*>(&header), sizeof(header));
+
+	if (!file || header.magic != Magic || header.version != Version || header.key != key || header.keyLength != keyLength) { return 0; }
+
+	//The size comes off disk, a corrupt one mustn't turn into a huge allocation
+	std::streampos start = file.tellg();
+	file.seekg(0, std::ios::end);
+	U64 remaining = static_cast<U64>(file.tellg() - start);
+	file.seekg(start);
+
+	if (!file || header.size == 0 || header.size > remaining) { return 0; }
+
+	std::vector<U8> binary(header.size);
+	file.read(reinterpret_cast<C8*>(binary.data()), header.size);
+	if (!file) { return 0; }
+
+	U32 program = glCreateProgram();
+	glProgramBinary(program, header.format, binary.data(), static_cast<I32>(header.size));
+
+	//The driver can still reject a binary whose strings matched, compiling replaces it
+	I32 success;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+#ifdef DV_DEBUG
+		std::cout << "Cached shader program rejected, recompiling: " << path << std::endl;
+#endif
+		glDeleteProgram(program);
+		return 0;
+	}
+
+	return program;
+}
+
+void ProgramCache::SaveBinary(const std::string& path, U64 key, U64 keyLength, U32 program)
+{
+	I32 length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) { return; }
+
+	std::vector<U8> binary(length);
+	U32 format = 0;
+	glGetProgramBinary(program, length, &length, &format, binary.data());
+
+	CacheHeader header{};
+	header.magic = Magic;
+	header.version = Version;
+	header.key = key;
+	header.keyLength = keyLength;
+	header.format = format;
+	header.size = static_cast<U32>(length);
+
+	std::error_code error;
+	std::filesystem::create_directories(CacheFolder, error);
+
+	//Renamed into place so an interrupted write never leaves a truncated binary behind
+	std::string temporary = path + ".tmp";
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		std::cout << "Failed To Write Shader Cache: " << path << std::endl;
+		return;
+	}
+
+	file.write(reinterpret_cast<const C8*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const C8*>(binary.data()), header.size);
+	file.close();
+
+	if (file) { std::filesystem::rename(temporary, path, error); }
+	if (!file || error)
+	{
+		std::cout << "Failed To Write Shader Cache: " << path << std::endl;
+		std::filesystem::remove(temporary, error);
+	}
+}
\ No newline at end of file
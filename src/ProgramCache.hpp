@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <string>
+
+/// <summary>
+/// Builds shader programs, keeping their driver binaries on disk so later launches skip compiling and linking.
+/// A binary is only reused when both the sources and the driver's vendor, renderer and version strings match,
+/// anything else falls back to compiling and replaces the cached binary.
+/// </summary>
+class ProgramCache
+{
+public:
+	/// <summary>
+	/// Gets a linked program, needs the GL context
+	/// </summary>
+	/// <param name="name:">The cache entry's name, unique per shader variant</param>
+	/// <returns>The program, 0 if compiling or linking failed</returns>
+	static U32 Load(const std::string& name, const std::string& vertexSource, const std::string& fragmentSource);
+
+	static constexpr const C8* CacheFolder = "shadercache";
+
+private:
+	struct CacheHeader
+	{
+		U32 magic;
+		U32 version;
+		U64 key;
+		U64 keyLength;
+		U32 format;
+		U32 size;
+	};
+
+	static U32 Compile(const std::string& vertexSource, const std::string& fragmentSource);
+	static U32 CompileShader(U32 type, const std::string& source);
+	static U32 LoadBinary(const std::string& path, U64 key, U64 keyLength);
+	static void SaveBinary(const std::string& path, U64 key, U64 keyLength, U32 program);
+
+	static constexpr U32 Magic = 'D' | ('V' << 8) | ('P' << 16) | ('C' << 24);
+	static constexpr U32 Version = 1;
+
+	STATIC_CLASS(ProgramCache);
+};
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "RawMidi.hpp"
+
+#include "Scheduling.hpp"
+#include "Time.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#ifdef DV_PLATFORM_LINUX
+#	include <fcntl.h>
+#	include <sound/asound.h>
+#	include <sys/epoll.h>
+#	include <sys/eventfd.h>
+#	include <sys/ioctl.h>
+#	include <unistd.h>
+#endif
+
+U8 MidiStream::DataLength(U8 status)
+{
+	switch (status & 0xF0)
+	{
+	case 0xC0: case 0xD0: return 1;
+	case 0xF0: break;
+	default: return 2;
+	}
+
+	switch (status)
+	{
+	case 0xF1: case 0xF3: return 1;
+	case 0xF2: return 2;
+	default: return 0;
+	}
+}
+
+bool MidiStream::Feed(U8 byte, MidiEvent& event)
+{
+	//Real-time bytes can land anywhere, even inside SysEx, and leave the message around them alone
+	if (byte >= 0xF8)
+	{
+		if (byte == 0xF9 || byte == 0xFD) { return false; }
+
+		event.size = 1;
+		event.bytes[0] = byte;
+		return true;
+	}
+
+	if (byte & 0x80)
+	{
+		count = 0;
+
+		//Any status ends SysEx, an EOX that doesn't is stray and dropped
+		if (byte == 0xF0 || byte == 0xF7)
+		{
+			sysex = byte == 0xF0;
+			status = 0;
+			return false;
+		}
+
+		sysex = false;
+
+		//System common messages cancel running status, tune request and the undefined ones have no data
+		expected = DataLength(byte);
+		if (expected == 0)
+		{
+			status = 0;
+			if (byte != 0xF6) { return false; }
+
+			event.size = 1;
+			event.bytes[0] = byte;
+			return true;
+		}
+
+		status = byte;
+		return false;
+	}
+
+	//Data without a status to belong to is from a message whose start was lost
+	if (sysex || status == 0) { return false; }
+
+	data[count++] = byte;
+	if (count < expected) { return false; }
+
+	count = 0;
+	event.size = expected + 1;
+	event.bytes[0] = status;
+	event.bytes[1] = data[0];
+	event.bytes[2] = expected > 1 ? data[1] : 0;
+
+	if (status >= 0xF0) { status = 0; }
+
+	return true;
+}
+
+void MidiStream::Reset()
+{
+	status = 0;
+	count = 0;
+	sysex = false;
+}
+
+RawMidiReader::~RawMidiReader()
+{
+	Close();
+}
+
+std::vector<std::string> RawMidiReader::ListDevices()
+{
+	std::vector<std::string> devices;
+
+#ifdef DV_PLATFORM_LINUX
+	std::error_code error;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator("/dev/snd", error))
+	{
+		std::string name = entry.path().filename().string();
+		if (name.rfind("midiC", 0) == 0) { devices.push_back(entry.path().string()); }
+	}
+
+	std::sort(devices.begin(), devices.end());
+#endif
+
+	return devices;
+}
+
+bool RawMidiReader::Open(const std::string& path, Sink eventSink, void* data, const ThreadPolicy& threadPolicy)
+{
+	Close();
+
+#ifdef DV_PLATFORM_LINUX
+	device = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	if (device < 0) { return false; }
+
+	//Framing puts the kernel's timestamp on every read, added in protocol 2.0.2 and ignored by older kernels
+	I32 version = 0;
+	framed = false;
+	if (ioctl(device, SNDRV_RAWMIDI_IOCTL_PVERSION, &version) == 0 && version >= SNDRV_PROTOCOL_VERSION(2, 0, 2))
+	{
+		snd_rawmidi_params params{};
+		params.stream = SNDRV_RAWMIDI_STREAM_INPUT;
+		params.buffer_size = BufferSize * sizeof(snd_rawmidi_framing_tstamp);
+		params.avail_min = 1;
+		params.mode = SNDRV_RAWMIDI_MODE_FRAMING_TSTAMP | SNDRV_RAWMIDI_MODE_CLOCK_MONOTONIC;
+
+		framed = ioctl(device, SNDRV_RAWMIDI_IOCTL_PARAMS, &params) == 0;
+	}
+
+	poller = epoll_create1(EPOLL_CLOEXEC);
+	wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	epoll_event deviceEvent{};
+	deviceEvent.events = EPOLLIN;
+	deviceEvent.data.fd = device;
+
+	epoll_event wakeEvent{};
+	wakeEvent.events = EPOLLIN;
+	wakeEvent.data.fd = wake;
+
+	if (poller < 0 || wake < 0 || epoll_ctl(poller, EPOLL_CTL_ADD, device, &deviceEvent) != 0 ||
+		epoll_ctl(poller, EPOLL_CTL_ADD, wake, &wakeEvent) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	sink = eventSink;
+	userData = data;
+	policy = threadPolicy;
+	stream.Reset();
+
+	running = true;
+	reader = std::thread(&RawMidiReader::Run, this);
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+void RawMidiReader::Close()
+{
+#ifdef DV_PLATFORM_LINUX
+	if (reader.joinable())
+	{
+		running = false;
+
+		eventfd_write(wake, 1);
+
+		reader.join();
+	}
+
+	if (device >= 0) { close(device); }
+	if (poller >= 0) { close(poller); }
+	if (wake >= 0) { close(wake); }
+#endif
+
+	device = -1;
+	poller = -1;
+	wake = -1;
+	framed = false;
+}
+
+void RawMidiReader::Run()
+{
+#ifdef DV_PLATFORM_LINUX
+	Trace::SetThreadName("Raw MIDI");
+	Scheduling::Apply("Input", policy);
+
+	//Frames are read whole, the plain buffer is the same size so either mode drains a burst in one read
+	alignas(8) U8 buffer[BufferSize * sizeof(snd_rawmidi_framing_tstamp)];
+	U64 frameSize = framed ? sizeof(snd_rawmidi_framing_tstamp) : 1;
+	U64 readSize = sizeof(buffer) - sizeof(buffer) % frameSize;
+
+	while (running.load(std::memory_order_relaxed))
+	{
+		epoll_event ready[2];
+		I32 count = epoll_wait(poller, ready, 2, -1);
+		if (count <= 0) { continue; }
+
+		U64 wakeTime = Time::Now();
+
+		for (I32 i = 0; i < count; ++i)
+		{
+			if (ready[i].data.fd != device) { continue; }
+
+			//A device that's unplugged or a FIFO whose writer left reports errors forever, the reader stops
+			if (ready[i].events & (EPOLLERR | EPOLLHUP) && !(ready[i].events & EPOLLIN))
+			{
+				running = false;
+				break;
+			}
+
+			TRACE_ZONE("Raw MIDI Read");
+
+			ssize_t length;
+			while ((length = read(device, buffer, readSize)) > 0)
+			{
+				if (!framed)
+				{
+					Dispatch(buffer, (U64)length, wakeTime);
+					continue;
+				}
+
+				for (ssize_t offset = 0; offset + (ssize_t)frameSize <= length; offset += frameSize)
+				{
+					snd_rawmidi_framing_tstamp frame;
+					memcpy(&frame, buffer + offset, sizeof(frame));
+
+					//Unknown frame types are skipped, as the kernel asks
+					if (frame.frame_type != 0) { continue; }
+
+					//steady_clock is CLOCK_MONOTONIC on Linux, so the kernel's stamps are already on the host clock
+					U64 time = frame.tv_sec * 1000000000ull + frame.tv_nsec;
+					U64 size = frame.length < SNDRV_RAWMIDI_FRAMING_DATA_LENGTH ? frame.length : SNDRV_RAWMIDI_FRAMING_DATA_LENGTH;
+					Dispatch(frame.data, size, time);
+				}
+			}
+		}
+	}
+#endif
+}
+
+void RawMidiReader::Dispatch(const U8* bytes, U64 length, U64 time)
+{
+	MidiEvent event{};
+	event.time = time;
+
+	for (U64 i = 0; i < length; ++i)
+	{
+		if (stream.Feed(bytes[i], event)) { sink(event, userData); }
+	}
+}
\ No newline at end of file
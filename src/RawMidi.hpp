@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include "Config.hpp"
+#include "EventSource.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// Turns a raw MIDI byte stream back into messages one byte at a time, keeping running status across reads.
+/// Real-time bytes come out as they arrive, even in the middle of another message, and SysEx is skipped as the
+/// events it would make don't fit in a MidiEvent.
+/// </summary>
+class MidiStream
+{
+public:
+	/// <summary>
+	/// Feeds the next byte of the stream
+	/// </summary>
+	/// <param name="byte:">The byte read from the device</param>
+	/// <param name="event:">Gets the message's size and bytes when it's completed, its time is left alone</param>
+	/// <returns>True if the byte completed a message</returns>
+	bool Feed(U8 byte, MidiEvent& event);
+
+	/// <summary>
+	/// Forgets the running status and any partial message, for when bytes were lost
+	/// </summary>
+	void Reset();
+
+	static U8 DataLength(U8 status);
+
+private:
+	U8 status{ 0 };
+	U8 data[2]{};
+	U8 count{ 0 };
+	U8 expected{ 0 };
+	bool sysex{ false };
+};
+
+/// <summary>
+/// Reads an ALSA rawmidi device (/dev/snd/midiC*D*) on its own thread, bypassing RtMidi and the sequencer. The thread
+/// sleeps in epoll and hands every message to the sink as soon as it's parsed. Where the kernel supports framing, each
+/// read carries the kernel's monotonic timestamp, otherwise messages are stamped when the read wakes up. Anything
+/// that can be polled and read works as a device, a FIFO stands in for one in the benchmarks.
+/// </summary>
+class RawMidiReader
+{
+public:
+	/// <summary>
+	/// Called on the reader's thread for every message, must not block
+	/// </summary>
+	using Sink = void(*)(const MidiEvent& event, void* userData);
+
+	RawMidiReader() = default;
+	~RawMidiReader();
+
+	RawMidiReader(const RawMidiReader&) = delete;
+	RawMidiReader& operator=(const RawMidiReader&) = delete;
+
+	/// <summary>
+	/// Lists the rawmidi devices in /dev/snd
+	/// </summary>
+	static std::vector<std::string> ListDevices();
+
+	/// <summary>
+	/// Opens a device and starts reading it
+	/// </summary>
+	/// <param name="path:">The device, e.g. /dev/snd/midiC1D0</param>
+	/// <param name="sink:">Gets every message read</param>
+	/// <param name="policy:">Applied to the reader's thread before it reads anything</param>
+	/// <returns>False if the device couldn't be opened or the platform has no rawmidi</returns>
+	bool Open(const std::string& path, Sink sink, void* userData, const ThreadPolicy& policy = {});
+
+	/// <summary>
+	/// Wakes the reader and joins it, the sink isn't called once this returns
+	/// </summary>
+	void Close();
+
+	bool IsOpen() const { return device >= 0; }
+
+	/// <summary>
+	/// True if the kernel timestamps reads, false if messages are stamped on wakeup
+	/// </summary>
+	bool HasKernelTimestamps() const { return framed; }
+
+private:
+	static constexpr U32 BufferSize = 1024;
+
+	void Run();
+	void Dispatch(const U8* bytes, U64 length, U64 time);
+
+	I32 device{ -1 };
+	I32 poller{ -1 };
+	I32 wake{ -1 };
+	bool framed{ false };
+	std::atomic<bool> running{ false };
+	std::thread reader;
+	Sink sink{ nullptr };
+	void* userData{ nullptr };
+	ThreadPolicy policy{};
+	MidiStream stream;
+};
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include "Recorder.hpp"
+
+#include "Time.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+RingBuffer<Recorder::Slot, Recorder::SlotCapacity> Recorder::queue;
+std::atomic<bool> Recorder::recording{ false };
+std::atomic<U64> Recorder::dropped{ 0 };
+std::thread Recorder::writer;
+std::mutex Recorder::settingsMutex;
+std::vector<Recorder::Setting> Recorder::pendingSettings;
+std::vector<std::string> Recorder::recordedConfig;
+std::string Recorder::path;
+
+std::vector<U8> Recorder::buffer;
+std::vector<std::pair<U64, U64>> Recorder::syncPoints;
+U64 Recorder::fileOffset = 0;
+U64 Recorder::lastTime = 0;
+U64 Recorder::recordCount = 0;
+U32 Recorder::checksum = 0;
+
+static std::ofstream file;
+
+bool Recorder::Start(const std::string& folder)
+{
+	if (recording) { return true; }
+
+	std::error_code error;
+	std::filesystem::create_directories(folder, error);
+
+	std::time_t now = std::time(nullptr);
+	std::tm local{};
+#ifdef DV_PLATFORM_WINDOWS
+	localtime_s(&local, &now);
+#else
+	localtime_r(&now, &local);
+#endif
+
+	C8 name[64];
+	std::strftime(name, sizeof(name), "session_%Y%m%d_%H%M%S.dvs", &local);
+	path = (std::filesystem::path(folder) / name).string();
+
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		std::cout << "Failed To Create Session Log: " << path << std::endl;
+		return false;
+	}
+
+#ifdef DV_DEBUG
+	std::cout << "Recording Session To: " << path << std::endl;
+#endif
+
+	U64 startTime = Time::Now();
+	U64 wallClock = static_cast<U64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count());
+
+	buffer.clear();
+	buffer.reserve(65536);
+	syncPoints.clear();
+	fileOffset = 0;
+	recordCount = 0;
+	checksum = 0;
+	dropped = 0;
+	lastTime = startTime;
+
+	WriteFixed(SessionLog::Magic, 4);
+	WriteFixed(SessionLog::Version, 4);
+	WriteFixed(startTime, 8);
+	WriteFixed(wallClock, 8);
+	Flush();
+
+	{
+		std::lock_guard<std::mutex> lock(settingsMutex);
+		pendingSettings.clear();
+		recordedConfig.clear();
+	}
+
+	queue.Clear();
+	recording = true;
+	writer = std::thread(WriterThread);
+
+	return true;
+}
+
+void Recorder::Stop()
+{
+	if (!recording) { return; }
+
+	recording = false;
+	if (writer.joinable()) { writer.join(); }
+
+#ifdef DV_DEBUG
+	std::cout << "Session Log Closed: " << path << ", " << recordCount << " records, " << dropped << " dropped" << std::endl;
+#endif
+}
+
+bool Recorder::IsRecording()
+{
+	return recording.load(std::memory_order_relaxed);
+}
+
+const std::string& Recorder::GetPath()
+{
+	return path;
+}
+
+U64 Recorder::GetDroppedCount()
+{
+	return dropped.load(std::memory_order_relaxed);
+}
+
+void Recorder::RecordMidi(U64 time, const U8* bytes, U32 size)
+{
+	if (!recording.load(std::memory_order_relaxed) || size == 0) { return; }
+
+	static constexpr U32 SlotBytes = sizeof(Slot::bytes);
+	static constexpr U32 MaxSlots = (MaxMessageSize + SlotBytes - 1) / SlotBytes;
+
+	size = size < MaxMessageSize ? size : MaxMessageSize;
+	U32 slotCount = (size + SlotBytes - 1) / SlotBytes;
+
+	Slot slots[MaxSlots];
+	slots[0].time = time;
+	slots[0].size = static_cast<U16>(size);
+
+	for (U32 i = 0, offset = 0; i < slotCount; ++i, offset += SlotBytes)
+	{
+		U32 count = size - offset < SlotBytes ? size - offset : SlotBytes;
+		memcpy(slots[i].bytes, bytes + offset, count);
+	}
+
+	if (!queue.PushRange(slots, slotCount)) { dropped.fetch_add(1, std::memory_order_relaxed); }
+}
+
+void Recorder::RecordConfig(const std::string& config)
+{
+	if (!recording) { return; }
+
+	U64 time = Time::Now();
+	std::vector<std::string> lines;
+
+	U64 i = 0;
+	U64 end = 0;
+	while ((end = config.find('\n', i)) != std::string::npos)
+	{
+		lines.push_back(config.substr(i, end - i));
+		i = end + 1;
+	}
+
+	std::lock_guard<std::mutex> lock(settingsMutex);
+
+	for (U64 line = 0; line < lines.size(); ++line)
+	{
+		if (line < recordedConfig.size() && recordedConfig[line] == lines[line]) { continue; }
+
+		U64 split = lines[line].find('=');
+		if (split == std::string::npos) { continue; }
+
+		pendingSettings.push_back({ time, lines[line].substr(0, split), lines[line].substr(split + 1) });
+	}
+
+	recordedConfig = std::move(lines);
+}
+
+void Recorder::WriterThread()
+{
+	U64 lastSync = Time::Now();
+	std::vector<Setting> settings;
+
+	while (true)
+	{
+		bool running = recording.load();
+		bool idle = true;
+
+		Slot slot;
+		while (queue.Pop(slot))
+		{
+			WriteMidi(slot);
+			idle = false;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(settingsMutex);
+			settings.swap(pendingSettings);
+		}
+
+		for (const Setting& setting : settings)
+		{
+			WriteSetting(setting);
+			idle = false;
+		}
+
+		settings.clear();
+
+		U64 now = Time::Now();
+		if (now - lastSync >= SyncInterval || !running)
+		{
+			WriteSync(now);
+			Flush();
+			lastSync = now;
+		}
+
+		if (!running) { break; }
+		if (idle) { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+	}
+
+	WriteIndex();
+	Flush();
+	file.close();
+}
+
+void Recorder::WriteMidi(const Slot& slot)
+{
+	static constexpr U32 SlotBytes = sizeof(Slot::bytes);
+
+	buffer.push_back(SessionLog::Midi);
+	WriteDelta(slot.time);
+	WriteVarint(slot.size);
+
+	U32 count = slot.size < SlotBytes ? slot.size : SlotBytes;
+	buffer.insert(buffer.end(), slot.bytes, slot.bytes + count);
+
+	//Long messages continue in the following slots, PushRange guarantees they are already visible
+	Slot next;
+	for (U32 remaining = slot.size - count; remaining > 0 && queue.Pop(next); remaining -= count)
+	{
+		count = remaining < SlotBytes ? remaining : SlotBytes;
+		buffer.insert(buffer.end(), next.bytes, next.bytes + count);
+	}
+
+	++recordCount;
+}
+
+void Recorder::WriteSetting(const Setting& setting)
+{
+	buffer.push_back(SessionLog::Setting);
+	WriteDelta(setting.time);
+	WriteVarint(setting.key.size());
+	buffer.insert(buffer.end(), setting.key.begin(), setting.key.end());
+	WriteVarint(setting.value.size());
+	buffer.insert(buffer.end(), setting.value.begin(), setting.value.end());
+
+	++recordCount;
+}
+
+void Recorder::WriteSync(U64 time)
+{
+	checksum = 2166136261u;
+	for (U8 byte : buffer) { checksum = (checksum ^ byte) * 16777619u; }
+
+	syncPoints.push_back({ time, fileOffset + buffer.size() });
+
+	buffer.push_back(SessionLog::Sync);
+	WriteFixed(SessionLog::SyncMagic, 4);
+	WriteFixed(time, 8);
+	WriteFixed(recordCount, 8);
+	WriteFixed(checksum, 4);
+
+	lastTime = time;
+}
+
+void Recorder::WriteIndex()
+{
+	U64 indexOffset = fileOffset + buffer.size();
+
+	buffer.push_back(SessionLog::Index);
+	WriteVarint(syncPoints.size());
+
+	for (const std::pair<U64, U64>& point : syncPoints)
+	{
+		WriteFixed(point.first, 8);
+		WriteFixed(point.second, 8);
+	}
+
+	WriteFixed(indexOffset, 8);
+	WriteFixed(SessionLog::FooterMagic, 4);
+}
+
+void Recorder::WriteDelta(U64 time)
+{
+	I64 delta = static_cast<I64>(time - lastTime);
+	WriteVarint((static_cast<U64>(delta) << 1) ^ static_cast<U64>(delta >> 63));
+	lastTime = time;
+}
+
+void Recorder::WriteVarint(U64 value)
+{
+	while (value >= 0x80)
+	{
+		buffer.push_back(static_cast<U8>(value | 0x80));
+		value >>= 7;
+	}
+
+	buffer.push_back(static_cast<U8>(value));
+}
+
+void Recorder::WriteFixed(U64 value, U32 size)
+{
+	for (U32 i = 0; i < size; ++i) { buffer.push_back(static_cast<U8>(value >> (i * 8))); }
+}
+
+void Recorder::Flush()
+{
+	if (buffer.empty()) { return; }
+
+	file.write(reinterpret_cast<const C8*>(buffer.data()), buffer.size());
+	file.flush();
+
+	fileOffset += buffer.size();
+	buffer.clear();
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include "RingBuffer.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* Session log layout, all fixed width fields are little endian:
+*
+*	Header:		"DVSL", U32 version, U64 start time (host ns), U64 wall clock (unix ms)
+*	Midi:		U8 tag, varint zigzag delta (ns), varint size, raw bytes
+*	Setting:	U8 tag, varint zigzag delta (ns), varint key size, key, varint value size, value
+*	Sync:		U8 tag, "SYNC", U64 absolute time (host ns), U64 record count, U32 checksum
+*	Index:		U8 tag, varint count, count * (U64 time, U64 offset of a sync record)
+*	Footer:		U64 offset of the index record, "DVSX"
+*
+* Deltas are relative to the previous record, or to the last sync record. Sync records are
+* written about once a second and flushed to disk, the checksum covers every byte since the
+* previous sync. The index and footer are only written on a clean stop, a reader that finds
+* no footer scans for sync records instead and drops anything after the last valid one.
+*/
+namespace SessionLog
+{
+	static constexpr U32 Magic = 0x4C535644;		//"DVSL"
+	static constexpr U32 SyncMagic = 0x434E5953;	//"SYNC"
+	static constexpr U32 FooterMagic = 0x58535644;	//"DVSX"
+	static constexpr U32 Version = 1;
+	static constexpr U32 HeaderSize = 24;
+	static constexpr U32 SyncSize = 25;
+	static constexpr U32 FooterSize = 12;
+
+	enum Tag : U8
+	{
+		Midi = 1,
+		Setting = 2,
+		Sync = 3,
+		Index = 4
+	};
+}
+
+class Recorder
+{
+public:
+	static bool Start(const std::string& folder);
+	static void Stop();
+	static bool IsRecording();
+	static const std::string& GetPath();
+	static U64 GetDroppedCount();
+
+	/// <summary>
+	/// Queues a raw MIDI message, safe to call from the MIDI callback, never blocks or allocates
+	/// </summary>
+	/// <param name="time:">Host timestamp of the message in nanoseconds</param>
+	/// <param name="bytes:">The raw message</param>
+	/// <param name="size:">The size of the message in bytes</param>
+	static void RecordMidi(U64 time, const U8* bytes, U32 size);
+
+	/// <summary>
+	/// Records every key of a serialized config that differs from the last recorded config
+	/// </summary>
+	/// <param name="config:">The config in settings.cfg format</param>
+	static void RecordConfig(const std::string& config);
+
+private:
+	struct Slot
+	{
+		U64 time;
+		U16 size;
+		U8 bytes[22];
+	};
+
+	struct Setting
+	{
+		U64 time;
+		std::string key;
+		std::string value;
+	};
+
+	static void WriterThread();
+	static void WriteMidi(const Slot& slot);
+	static void WriteSetting(const Setting& setting);
+	static void WriteSync(U64 time);
+	static void WriteIndex();
+	static void WriteDelta(U64 time);
+	static void WriteVarint(U64 value);
+	static void WriteFixed(U64 value, U32 size);
+	static void Flush();
+
+	static constexpr U32 SlotCapacity = 8192;
+	static constexpr U32 MaxMessageSize = 4096;
+	static constexpr U64 SyncInterval = 1000000000;
+
+	static RingBuffer<Slot, SlotCapacity> queue;
+	static std::atomic<bool> recording;
+	static std::atomic<U64> dropped;
+	static std::thread writer;
+	static std::mutex settingsMutex;
+	static std::vector<Setting> pendingSettings;
+	static std::vector<std::string> recordedConfig;
+	static std::string path;
+
+	static std::vector<U8> buffer;
+	static std::vector<std::pair<U64, U64>> syncPoints;
+	static U64 fileOffset;
+	static U64 lastTime;
+	static U64 recordCount;
+	static U32 checksum;
+
+	STATIC_CLASS(Recorder)
+};
\ No newline at end of file
@@ -2,50 +2,47 @@
 
 #include "Defines.hpp"
 
-#include "Resources.hpp"
 #include "Buffer.hpp"
-#include "Window.hpp"
+#include "Controllers.hpp"
 
-#include <vector>
-
-struct Stats;
+class Engine;
 
+/// <summary>
+/// Draws an engine's notes as one instanced draw, and the lane controller bars as another. Only uploads and draws, the
+/// windows and UI around it are the frontend's to drive.
+/// </summary>
 class Renderer
 {
 public:
 	static bool Initialize();
 	static void Shutdown();
 
-	static void Update(Vector2 velocity, Window& settingsWindow, Window& visualizerWindow);
-	static void SpawnNote(Stats& stats, const Vector3& color, Texture* texture);
-	static void ClearNotes();
+	/// <summary>
+	/// Uploads the note quad and every note's instance attributes, keeps the textures of notes on screen resident.
+	/// Controller bars go up as uniforms when they're drawn, a few floats a frame.
+	/// </summary>
+	static void Upload(const Engine& engine);
+
+	/// <summary>
+	/// Draws the notes and bars uploaded last into the current window
+	/// </summary>
+	static void Draw();
 
 private:
 	static U32 vao;
-	static U32 textureBuffer;
 	static U32 shaderProgram;
+	static U32 indicatorProgram;
 	static Buffer positionBuffer;
 	static Buffer texCoordsBuffer;
-	static Buffer offsetsBuffer;
-	static Buffer scalesBuffer;
-	static Buffer texCoordOffsetsBuffer;
-	static Buffer texCoordScalesBuffer;
-	static Buffer colorsBuffer;
-	static Buffer textureIdsBuffer;
-	static Texture* defaultTexture;
-
-	static constexpr U32 MaxNotes = 200;
-	static U32 nextIndex;
-	static std::vector<Vector3> offsets;
-	static std::vector<Vector2> scales;
-	static std::vector<Vector2> texCoordOffsets;
-	static std::vector<Vector2> texCoordScales;
-	static std::vector<Vector3> colors;
-	static std::vector<U32> textureIds;
+	static Buffer instanceBuffer;
 
 	static Vector2 positions[4];
 	static Vector2 texCoords[4];
 	static U32 indices[6];
 
+	static Vector4 indicatorBounds[Controllers::LaneCount];
+	static Vector4 indicatorColors[Controllers::LaneCount];
+	static bool showIndicators;
+
 	STATIC_CLASS(Renderer)
 };
\ No newline at end of file
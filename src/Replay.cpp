@@ -0,0 +1,120 @@
+#include "Replay.hpp"
+
+#include "EventSource.hpp"
+#include "Engine.hpp"
+#include "Time.hpp"
+#include "Visualizer.hpp"
+
+#include <iostream>
+
+EventSource* Replay::source = nullptr;
+F64 Replay::speed = 1.0;
+F64 Replay::accumulator = 0.0;
+U64 Replay::step = 0;
+U64 Replay::nextEvent = 0;
+U64 Replay::nextSetting = 0;
+U64 Replay::endTime = 0;
+bool Replay::finished = false;
+
+bool Replay::Load(const std::string& path, F64 speed_)
+{
+	Shutdown();
+
+	source = EventSource::Create(path);
+	if (!source)
+	{
+		std::cout << "Failed To Load Replay: " << path << std::endl;
+		return false;
+	}
+
+	speed = speed_;
+	accumulator = 0.0;
+	step = 0;
+	nextEvent = 0;
+	nextSetting = 0;
+	finished = false;
+
+	//Keep stepping after the last event until its notes have scrolled off screen
+	endTime = source->GetDuration() + Time::FromSeconds(2.0);
+
+	Visualizer::ResetState();
+
+#ifdef DV_DEBUG
+	std::cout << "Replaying " << source->GetEvents().size() << " event(s) from: " << path << std::endl;
+#endif
+
+	return true;
+}
+
+void Replay::Shutdown()
+{
+	delete source;
+	source = nullptr;
+}
+
+void Replay::Update(F64 deltaTime)
+{
+	if (!source || finished) { return; }
+
+	static constexpr F64 StepSize = 1.0 / StepsPerSecond;
+	static constexpr U64 MaxFrameTime = 12000000;
+
+	if (speed <= 0.0)
+	{
+		U64 start = Time::Now();
+		while (!finished && Time::Now() - start < MaxFrameTime) { Step(); }
+	}
+	else
+	{
+		accumulator += deltaTime * speed;
+
+		while (!finished && accumulator >= StepSize)
+		{
+			Step();
+			accumulator -= StepSize;
+		}
+	}
+}
+
+bool Replay::IsActive()
+{
+	return source;
+}
+
+bool Replay::IsFinished()
+{
+	return finished;
+}
+
+void Replay::Step()
+{
+	++step;
+	U64 clock = step * 1000000000ull / StepsPerSecond;
+
+	const std::vector<SettingEvent>& settings = source->GetSettings();
+	const std::vector<MidiEvent>& events = source->GetEvents();
+
+	while (nextSetting < settings.size() && settings[nextSetting].time <= clock)
+	{
+		Visualizer::ApplyRecordedSetting(settings[nextSetting].key, settings[nextSetting].value);
+		++nextSetting;
+	}
+
+	while (nextEvent < events.size() && events[nextEvent].time <= clock)
+	{
+		Visualizer::ProcessEvent(events[nextEvent]);
+		++nextEvent;
+	}
+
+	Engine& engine = Visualizer::GetEngine();
+	engine.SampleControllers(clock);
+	engine.Simulate(engine.ScrollVelocity(1.0 / StepsPerSecond));
+
+	if (clock >= endTime)
+	{
+		finished = true;
+
+		std::cout << "Replay finished after " << step << " steps, " << events.size() << " event(s), state hash 0x" <<
+			std::hex << Visualizer::StateHash() << std::dec << std::endl;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <string>
+
+class EventSource;
+
+/// <summary>
+/// Drives the visualizer from an EventSource on a virtual clock. The simulation advances in fixed steps, so
+/// the note and stats state after any step is identical between runs regardless of speed or frame rate.
+/// </summary>
+class Replay
+{
+public:
+	/// <summary>
+	/// Loads a session log or MIDI file and resets the visualizer to a clean state
+	/// </summary>
+	/// <param name="path:">The file to replay</param>
+	/// <param name="speed:">Playback rate, 1.0 is real time, 0.0 or lower runs as fast as possible</param>
+	static bool Load(const std::string& path, F64 speed);
+	static void Shutdown();
+
+	static void Update(F64 deltaTime);
+
+	static bool IsActive();
+	static bool IsFinished();
+
+	static constexpr U64 StepsPerSecond = 240;
+
+private:
+	static void Step();
+
+	static EventSource* source;
+	static F64 speed;
+	static F64 accumulator;
+	static U64 step;
+	static U64 nextEvent;
+	static U64 nextSetting;
+	static U64 endTime;
+	static bool finished;
+
+	STATIC_CLASS(Replay)
+};
\ No newline at end of file
@@ -1,18 +1,77 @@
 #include "Resources.hpp"
 
+#include "Allocations.hpp"
 #include "GraphicsInclude.hpp"
+#include "Trace.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
 #include <fstream>
 
-std::map<std::string, Texture> Resources::textures;
+//From EXT_texture_compression_s3tc, which glad wasn't generated with
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#	define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#	define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+struct Resources::Staging
+{
+	U32 buffer{ 0 };
+	U8* memory{ nullptr };
+	GLsync fences[StagingSegments]{};
+	U32 segment{ 0 };
+};
+
+struct Resources::Retired
+{
+	U32 texture;
+	U64 handle;
+	bool resident;
+	GLsync fence;
+};
 
-std::vector<char*> Resources::textureNames;
-std::vector<U64> Resources::textureHandles;
+static GLenum InternalFormat(PackFormat format)
+{
+	switch (format)
+	{
+	case PackFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case PackFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	default: return GL_RGBA8;
+	}
+}
+
+std::map<std::string, Texture> Resources::textures;
+AssetPack Resources::pack;
+
+StringTable Resources::textureNames;
+std::vector<Resources::Slot> Resources::slots;
+U32 Resources::placeholder = 0;
+U64 Resources::placeholderHandle = 0;
+U32 Resources::handleTable = 0;
+U64 Resources::frame = 0;
+U64 Resources::residentBytes = 0;
+F32 Resources::anisotropy = 1.0f;
+bool Resources::compressionSupported = false;
+
+std::vector<std::thread> Resources::decoders;
+std::mutex Resources::decodeMutex;
+std::condition_variable Resources::decodeSignal;
+std::deque<Resources::Image> Resources::decodeQueue;
+std::vector<Resources::Image> Resources::decoded;
+std::vector<Resources::Image> Resources::ready;
+U32 Resources::decoding = 0;
+bool Resources::stopDecoding = false;
+
+std::vector<Resources::Upload> Resources::uploads;
+std::vector<Resources::Retired> Resources::retired;
+Resources::Staging Resources::staging;
 
 bool Resources::Initialize()
 {
@@ -20,16 +79,273 @@ bool Resources::Initialize()
 	std::cout << "Loading Assets..." << std::endl;
 #endif
 
+	//Shown until a texture's upload completes, a white texel leaves notes their plain color
+	static const U8 white[4] = { 255, 255, 255, 255 };
+	glCreateTextures(GL_TEXTURE_2D, 1, &placeholder);
+	glTextureStorage2D(placeholder, 1, GL_RGBA8, 1, 1);
+	glTextureSubImage2D(placeholder, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, white);
+	placeholderHandle = glGetTextureHandleARB(placeholder);
+	glMakeTextureHandleResidentARB(placeholderHandle);
+
+	std::vector<U64> handles(MaxTextures, placeholderHandle);
+	glCreateBuffers(1, &handleTable);
+	glNamedBufferStorage(handleTable, MaxTextures * sizeof(U64), handles.data(), GL_DYNAMIC_STORAGE_BIT);
+
+	//One persistently mapped ring, each frame writes its own segment so the CPU never waits on the GPU's copies
+	glCreateBuffers(1, &staging.buffer);
+	glNamedBufferStorage(staging.buffer, UploadBudget * StagingSegments, nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+	staging.memory = static_cast<U8*>(glMapNamedBufferRange(staging.buffer, 0, UploadBudget * StagingSegments,
+		GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
+
+	if (!staging.memory)
+	{
+		std::cout << "Failed To Map Texture Staging Buffer!" << std::endl;
+		return false;
+	}
+
+	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &anisotropy);
+	if (anisotropy > MaxAnisotropy) { anisotropy = MaxAnisotropy; }
+	if (anisotropy < 1.0f) { anisotropy = 1.0f; }
+
+	I32 extensionCount = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+	for (I32 i = 0; i < extensionCount && !compressionSupported; ++i)
+	{
+		const C8* extension = reinterpret_cast<const C8*>(glGetStringi(GL_EXTENSIONS, i));
+		compressionSupported = extension && strcmp(extension, "GL_EXT_texture_compression_s3tc") == 0;
+	}
+
+	//Global in stb_image, set before any decoder starts
 	stbi_set_flip_vertically_on_load(true);
 
-	LoadAssets();
+	//Packed textures are already decoded with their mips, they go straight into the upload queue
+	if (pack.Open(AssetPack::DefaultPath))
+	{
+		for (const PackEntry& entry : pack)
+		{
+			if (entry.type != PackEntryType::Texture) { continue; }
+
+			//Without driver support compressed textures are left to the loose images
+			if (entry.format != PackFormat::RGBA8 && !compressionSupported) { continue; }
+
+			std::string path = std::string(pack.Name(entry));
+			Texture* texture = Register(GetFileName(path), path);
+			if (!texture) { continue; }
+
+			BeginUpload(texture->id, pack.Data(entry), false, entry.format, static_cast<I32>(entry.width), static_cast<I32>(entry.height),
+				entry.levels, path);
+		}
+	}
+
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator("assets"))
+	{
+		std::string path = entry.path().string();
+
+		//The pack wins over loose files, a changed image is picked up by rebuilding the pack
+		if (pack.IsOpen() && GetTexture(GetFileName(path))) { continue; }
+
+		std::string ext = path.substr(path.find_last_of('.') + 1);
+
+		switch (HashCI(ext.c_str(), ext.length()))
+		{
+			//Textures
+		case "jpg"_Hash:
+		case "jpeg"_Hash:
+		case "png"_Hash:
+		case "bmp"_Hash:
+		case "tga"_Hash:
+		case "jfif"_Hash:
+		case "tiff"_Hash: {
+			LoadTexture(path);
+		} break;
+		}
+	}
+
+	//Leaves a core to the main thread
+	U32 threadCount = std::thread::hardware_concurrency();
+	threadCount = threadCount > 2 ? threadCount - 1 : 1;
+	if (threadCount > 4) { threadCount = 4; }
+
+	for (U32 i = 0; i < threadCount; ++i) { decoders.emplace_back(Decoder); }
 
 	return true;
 }
 
 void Resources::Shutdown()
 {
+	{
+		std::lock_guard<std::mutex> lock(decodeMutex);
+		stopDecoding = true;
+	}
+
+	decodeSignal.notify_all();
+	for (std::thread& decoder : decoders) { decoder.join(); }
+	decoders.clear();
+
+	for (Image& image : decodeQueue) { stbi_image_free(image.data); }
+	for (Image& image : decoded) { stbi_image_free(image.data); }
+	decodeQueue.clear();
+	decoded.clear();
+
+	for (Upload& upload : uploads)
+	{
+		FreeData(upload);
+		glDeleteTextures(1, &upload.texture);
+	}
+
+	uploads.clear();
+	pack.Close();
+
+	ReleaseRetired(true);
+
+	for (GLsync& fence : staging.fences)
+	{
+		if (fence) { glDeleteSync(fence); }
+		fence = nullptr;
+	}
+
+	if (staging.buffer) { glUnmapNamedBuffer(staging.buffer); }
+	glDeleteBuffers(1, &staging.buffer);
+	staging.memory = nullptr;
+
+	for (Slot& slot : slots)
+	{
+		if (slot.resident) { glMakeTextureHandleNonResidentARB(slot.handle); }
+		if (slot.object) { glDeleteTextures(1, &slot.object); }
+	}
+
+	slots.clear();
+	residentBytes = 0;
+
+	if (placeholder)
+	{
+		glMakeTextureHandleNonResidentARB(placeholderHandle);
+		glDeleteTextures(1, &placeholder);
+	}
+
+	glDeleteBuffers(1, &handleTable);
+}
+
+void Resources::Update()
+{
+	TRACE_ZONE("Stream Textures");
+
+	++frame;
+
+	ReleaseRetired(false);
+	UpdateResidency();
+
+	{
+		std::lock_guard<std::mutex> lock(decodeMutex);
+		ready.swap(decoded);
+	}
+
+	for (Image& image : ready) { BeginUpload(image); }
+	ready.clear();
+
+	if (uploads.empty()) { return; }
+
+	//A segment still being copied from means the GPU is behind, skipping a frame of streaming beats stalling it
+	GLsync& fence = staging.fences[staging.segment];
+	if (fence)
+	{
+		GLenum status = glClientWaitSync(fence, 0, 0);
+		if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) { return; }
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	U64 start = staging.segment * UploadBudget;
+	U64 offset = start;
+	U64 end = start + UploadBudget;
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	U32 completed = 0;
+	for (Upload& upload : uploads)
+	{
+		U32 rowHeight = AssetPack::RowHeight(upload.format);
+
+		while (upload.level < upload.levels)
+		{
+			U32 width = AssetPack::LevelSize(upload.width, upload.level);
+			U32 height = AssetPack::LevelSize(upload.height, upload.level);
+			U32 rowCount = (height + rowHeight - 1) / rowHeight;
+
+			U64 rowSize = AssetPack::RowBytes(upload.format, width);
+			U64 rows = (end - offset) / rowSize;
+			U64 remaining = rowCount - upload.row;
+			if (rows > remaining) { rows = remaining; }
+			if (rows == 0) { break; }
+
+			memcpy(staging.memory + offset, upload.data + upload.levelOffset + upload.row * rowSize, rows * rowSize);
+
+			//Block rows cover 4 pixel rows, except the last one of a level that isn't a multiple of 4 tall
+			U32 y = upload.row * rowHeight;
+			U32 pixelRows = static_cast<U32>(rows) * rowHeight;
+			if (pixelRows > height - y) { pixelRows = height - y; }
+
+			if (upload.format == PackFormat::RGBA8)
+			{
+				glTextureSubImage2D(upload.texture, upload.level, 0, y, width, pixelRows, GL_RGBA, GL_UNSIGNED_BYTE,
+					reinterpret_cast<const void*>(offset));
+			}
+			else
+			{
+				glCompressedTextureSubImage2D(upload.texture, upload.level, 0, y, width, pixelRows, InternalFormat(upload.format),
+					static_cast<I32>(rows * rowSize), reinterpret_cast<const void*>(offset));
+			}
+
+			offset += rows * rowSize;
+			upload.row += static_cast<U32>(rows);
+
+			if (upload.row == rowCount)
+			{
+				upload.levelOffset += rowSize * rowCount;
+				upload.row = 0;
+				++upload.level;
+			}
+		}
+
+		//Commands run in order, so draws after the swap already see the finished image
+		if (upload.level == upload.levels)
+		{
+			Swap(upload);
+			++completed;
+		}
+		else { break; }
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (offset > start)
+	{
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		staging.segment = (staging.segment + 1) % StagingSegments;
+	}
+
+	if (completed)
+	{
+		uploads.erase(std::remove_if(uploads.begin(), uploads.end(), [](const Upload& upload) { return upload.level == upload.levels; }), uploads.end());
+	}
+}
+
+Texture* Resources::LoadTexture(const std::string& path)
+{
+	Texture* texture = Register(GetFileName(path), path);
+	if (!texture) { return nullptr; }
+
+	{
+		std::lock_guard<std::mutex> lock(decodeMutex);
+		decodeQueue.push_back({ path, texture->id });
+		++decoding;
+	}
 
+	decodeSignal.notify_one();
+
+	return texture;
 }
 
 Texture* Resources::GetTexture(const std::string& name)
@@ -41,11 +357,33 @@ Texture* Resources::GetTexture(const std::string& name)
 	return &result->second;
 }
 
-const std::vector<char*>& Resources::GetTextureNames()
+const StringTable& Resources::GetTextureNames()
 {
 	return textureNames;
 }
 
+U32 Resources::GetHandleTable()
+{
+	return handleTable;
+}
+
+U32 Resources::PendingCount()
+{
+	std::lock_guard<std::mutex> lock(decodeMutex);
+	return decoding + static_cast<U32>(decoded.size() + uploads.size());
+}
+
+std::string Resources::ReadAsset(const std::string& name)
+{
+	const PackEntry* entry = pack.Find(name);
+	if (entry && entry->type == PackEntryType::Text)
+	{
+		return std::string(reinterpret_cast<const C8*>(pack.Data(*entry)), entry->size);
+	}
+
+	return ReadFile("assets/" + name);
+}
+
 std::string Resources::ReadFile(const std::string& path)
 {
 	std::ifstream file(path);
@@ -55,78 +393,250 @@ std::string Resources::ReadFile(const std::string& path)
 	return data;
 }
 
-std::string Resources::ReadFile(const std::wstring& path)
+Texture* Resources::Register(const std::string& name, const std::string& path)
 {
-	std::ifstream file(path);
-	std::string data((std::istreambuf_iterator<char>(file)),
-		(std::istreambuf_iterator<char>()));
+	std::map<std::string, Texture>::iterator result = textures.find(name);
+	if (result != textures.end()) { return &result->second; }
 
-	return data;
+	if (textures.size() == MaxTextures)
+	{
+		std::cout << "Failed To Load Texture, Limit Of " << MaxTextures << " Reached: " << path << std::endl;
+		return nullptr;
+	}
+
+	Texture texture{};
+	texture.name = name;
+	texture.width = 1;
+	texture.height = 1;
+	texture.id = (U32)textures.size();
+
+	textureNames.Intern(texture.name);
+	slots.emplace_back();
+
+	return &textures.insert({ texture.name, texture }).first->second;
 }
 
-void Resources::LoadAssets()
+void Resources::Decoder()
 {
-	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator("assets"))
+	while (true)
 	{
-		std::string path = entry.path().string();
+		Image image;
 
-		std::string ext = path.substr(path.find_last_of('.') + 1);
+		{
+			std::unique_lock<std::mutex> lock(decodeMutex);
+			decodeSignal.wait(lock, []() { return stopDecoding || !decodeQueue.empty(); });
+			if (stopDecoding) { return; }
+
+			image = std::move(decodeQueue.front());
+			decodeQueue.pop_front();
+		}
 
-		switch (HashCI(ext.c_str(), ext.length()))
 		{
-			//Textures
-		case "jpg"_Hash:
-		case "jpeg"_Hash:
-		case "png"_Hash:
-		case "bmp"_Hash:
-		case "tga"_Hash:
-		case "jfif"_Hash:
-		case "tiff"_Hash: {
-			LoadTexture(entry.path().string());
-		} break;
+			TRACE_ZONE("Decode Image");
+
+			I32 comp;
+			image.data = stbi_load(image.path.c_str(), &image.width, &image.height, &comp, 4);
 		}
+
+		//Mips are built here so the upload never waits on them, the pack ships them precomputed instead
+		if (image.data)
+		{
+			TRACE_ZONE("Generate Mips");
+
+			U32 width = static_cast<U32>(image.width);
+			U32 height = static_cast<U32>(image.height);
+			U32 levels = AssetPack::LevelCount(width, height);
+			U8* chain = static_cast<U8*>(STBI_REALLOC(image.data, AssetPack::TextureSize(PackFormat::RGBA8, width, height, levels)));
+
+			if (chain)
+			{
+				U8* level = chain;
+				for (U32 i = 1; i < levels; ++i)
+				{
+					U8* next = level + AssetPack::LevelBytes(PackFormat::RGBA8, width, height, i - 1);
+					AssetPack::Downsample(level, AssetPack::LevelSize(width, i - 1), AssetPack::LevelSize(height, i - 1), next);
+					level = next;
+				}
+
+				image.data = chain;
+				image.levels = levels;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(decodeMutex);
+		decoded.push_back(std::move(image));
+		--decoding;
 	}
 }
 
-void Resources::LoadTexture(const std::string& path)
+void Resources::BeginUpload(Image& image)
 {
-	I32 width, height, comp;
-	U8* data = stbi_load(path.c_str(), &width, &height, &comp, 4);
-	if (!data)
+	Allocations::ExcludeFrame();
+
+	if (!image.data)
 	{
-		std::cout << "Failed To Load Texture: " << path << std::endl;
+		std::cout << "Failed To Load Texture: " << image.path << std::endl;
 		return;
 	}
 
-	U32 textureLocation;
-	glGenTextures(1, &textureLocation);
-	glBindTexture(GL_TEXTURE_2D, textureLocation);
-	glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
-	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	BeginUpload(image.id, image.data, true, PackFormat::RGBA8, image.width, image.height, image.levels, image.path);
+	image.data = nullptr;
+}
 
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+void Resources::BeginUpload(U32 id, const U8* data, bool owned, PackFormat format, I32 width, I32 height, U32 levels, const std::string& path)
+{
+	Upload upload{};
+	upload.id = id;
+	upload.data = data;
+	upload.owned = owned;
+	upload.format = format;
+	upload.width = width;
+	upload.height = height;
+	upload.levels = levels;
+	upload.level = 0;
+	upload.levelOffset = 0;
+	upload.row = 0;
+
+	if (AssetPack::RowBytes(format, width) > UploadBudget)
+	{
+		std::cout << "Failed To Load Texture, Too Wide To Stream: " << path << std::endl;
+		FreeData(upload);
+		return;
+	}
 
-	stbi_image_free(data);
+	//A newer load of the same texture supersedes one still uploading
+	for (Upload& previous : uploads)
+	{
+		if (previous.id == id)
+		{
+			FreeData(previous);
+			glDeleteTextures(1, &previous.texture);
+			previous = uploads.back();
+			uploads.pop_back();
+			break;
+		}
+	}
 
-	U64 textureHandle = glGetTextureHandleARB(textureLocation);
-	glMakeTextureHandleResidentARB(textureHandle);
-	textureHandles.push_back(textureHandle);
+	glCreateTextures(GL_TEXTURE_2D, 1, &upload.texture);
+	glTextureStorage2D(upload.texture, static_cast<I32>(levels), InternalFormat(format), width, height);
+	glTextureParameteri(upload.texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(upload.texture, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTextureParameteri(upload.texture, GL_TEXTURE_MAX_LEVEL, static_cast<I32>(levels) - 1);
+	glTextureParameterf(upload.texture, GL_TEXTURE_MAX_ANISOTROPY, levels > 1 ? anisotropy : 1.0f);
+	glTextureParameteri(upload.texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(upload.texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-	Texture texture{};
-	texture.name = GetFileName(path);
-	texture.width = width;
-	texture.height = height;
-	texture.id = (U32)textures.size();
+	uploads.push_back(upload);
+}
+
+void Resources::FreeData(const Upload& upload)
+{
+	if (upload.owned) { stbi_image_free(const_cast<U8*>(upload.data)); }
+}
+
+void Resources::Swap(const Upload& upload)
+{
+	Allocations::ExcludeFrame();
+
+	FreeData(upload);
+
+	Slot& slot = slots[upload.id];
+
+	//Frames already submitted may still sample the old image, it's released once the GPU is past them
+	if (slot.object) { retired.push_back({ slot.object, slot.handle, slot.resident, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) }); }
+	if (slot.resident) { residentBytes -= slot.bytes; }
+
+	slot.object = upload.texture;
+	slot.handle = glGetTextureHandleARB(upload.texture);
+	slot.bytes = AssetPack::TextureSize(upload.format, upload.width, upload.height, upload.levels);
+
+	//A texture on screen swaps straight to the new image, anything else waits for its next use
+	if (slot.resident)
+	{
+		slot.resident = false;
+		MakeResident(slot);
+	}
+
+	for (std::pair<const std::string, Texture>& entry : textures)
+	{
+		if (entry.second.id == upload.id)
+		{
+			entry.second.width = upload.width;
+			entry.second.height = upload.height;
+			break;
+		}
+	}
+}
+
+void Resources::ReleaseRetired(bool wait)
+{
+	for (U64 i = 0; i < retired.size();)
+	{
+		Retired& texture = retired[i];
+
+		if (!wait && glClientWaitSync(texture.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+		{
+			++i;
+			continue;
+		}
+
+		if (wait) { glClientWaitSync(texture.fence, GL_SYNC_FLUSH_COMMANDS_BIT, U64_MAX); }
+		glDeleteSync(texture.fence);
+
+		if (texture.resident) { glMakeTextureHandleNonResidentARB(texture.handle); }
+		glDeleteTextures(1, &texture.texture);
+
+		texture = retired.back();
+		retired.pop_back();
+	}
+}
+
+void Resources::MakeResident(Slot& slot)
+{
+	glMakeTextureHandleResidentARB(slot.handle);
+	SetHandle(slot, slot.handle);
+
+	slot.resident = true;
+	residentBytes += slot.bytes;
+}
 
-	char* nameStorage = new char[texture.name.size() + 1];
-	memcpy(nameStorage, texture.name.c_str(), texture.name.size());
-	nameStorage[texture.name.size()] = '\0';
+void Resources::Evict(Slot& slot)
+{
+	//Sampled as the placeholder from here on, frames that could still use the texture are long since done
+	SetHandle(slot, placeholderHandle);
+	glMakeTextureHandleNonResidentARB(slot.handle);
 
-	textureNames.push_back(nameStorage);
-	textures.insert({ texture.name, texture });
+	slot.resident = false;
+	residentBytes -= slot.bytes;
+}
+
+void Resources::UpdateResidency()
+{
+	for (Slot& slot : slots)
+	{
+		if (slot.resident && frame - slot.lastUsed > IdleFrames) { Evict(slot); }
+	}
+
+	//Over budget the least recently used go first, as long as the GPU can't still be drawing them
+	while (residentBytes > ResidentBudget)
+	{
+		Slot* oldest = nullptr;
+
+		for (Slot& slot : slots)
+		{
+			if (slot.resident && frame - slot.lastUsed >= MinIdleFrames && (!oldest || slot.lastUsed < oldest->lastUsed)) { oldest = &slot; }
+		}
+
+		if (!oldest) { break; }
+
+		Evict(*oldest);
+	}
+}
+
+void Resources::SetHandle(const Slot& slot, U64 handle)
+{
+	U64 id = static_cast<U64>(&slot - slots.data());
+	glNamedBufferSubData(handleTable, id * sizeof(U64), sizeof(U64), &handle);
 }
 
 std::string Resources::GetFileName(const std::string& path)
@@ -2,43 +2,158 @@
 
 #include "Defines.hpp"
 
+#include "AssetPack.hpp"
+#include "Config.hpp"
+#include "StringTable.hpp"
+
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
-struct Texture
-{
-	std::string name{};
-	U32 id;
-	U32 width;
-	U32 height;
-};
-
 class Resources
 {
 public:
+	/// <summary>
+	/// Registers every texture behind a placeholder, needs the GL context. Textures in the asset pack stream
+	/// straight from its mapping, images in the assets folder the pack doesn't have are decoded in the background.
+	/// </summary>
 	static bool Initialize();
 	static void Shutdown();
 
+	/// <summary>
+	/// Streams decoded images to the GPU within a per-frame budget and evicts textures that went unused, called
+	/// once per frame on the context thread before any Use
+	/// </summary>
+	static void Update();
+
+	/// <summary>
+	/// Marks a texture as drawn this frame, making its handle resident if it was evicted. Textures that aren't
+	/// resident sample the placeholder.
+	/// </summary>
+	static void Use(U32 id)
+	{
+		Slot& slot = slots[id];
+		slot.lastUsed = frame;
+		if (!slot.resident && slot.object) { MakeResident(slot); }
+	}
+
+	/// <summary>
+	/// Queues an image for decoding. A new texture shows the placeholder and an existing one keeps its current
+	/// image until the upload completes, either way its id never changes.
+	/// </summary>
+	static Texture* LoadTexture(const std::string& path);
+
 	static Texture* GetTexture(const std::string& name);
-	static const std::vector<char*>& GetTextureNames();
+	static const StringTable& GetTextureNames();
+
+	/// <summary>
+	/// The bindless handle of every texture indexed by id, bound as the sprite shader's texture table
+	/// </summary>
+	static U32 GetHandleTable();
 
+	/// <summary>
+	/// Gets the number of textures still decoding or uploading
+	/// </summary>
+	static U32 PendingCount();
+
+	/// <summary>
+	/// Reads a non-texture asset like a shader source, from the asset pack if it has it
+	/// </summary>
+	/// <param name="name:">The file name in the assets folder, extension included</param>
+	static std::string ReadAsset(const std::string& name);
 	static std::string ReadFile(const std::string& path);
-	static std::string ReadFile(const std::wstring& path);
+
+	static constexpr U32 MaxTextures = 256;
+	static constexpr U64 UploadBudget = 4 * 1024 * 1024;	//Bytes uploaded per frame at most
+	static constexpr U32 StagingSegments = 3;				//Frames of uploads the GPU can be behind on
+	static constexpr U64 ResidentBudget = 256 * 1024 * 1024;	//Bytes of resident textures before the least recently used are evicted
+	static constexpr U64 IdleFrames = 300;					//Frames a texture stays resident after its last use
+	static constexpr U64 MinIdleFrames = 8;					//Frames the GPU could still be sampling a texture after its last use
+	static constexpr F32 MaxAnisotropy = 8.0f;
 
 private:
-	static void LoadAssets();
+	struct Slot
+	{
+		U32 object{ 0 };	//0 while a texture still shows the placeholder
+		U64 handle{ 0 };
+		U64 bytes{ 0 };
+		U64 lastUsed{ 0 };
+		bool resident{ false };
+	};
+
+	struct Image
+	{
+		std::string path;
+		U32 id;
+		U8* data{ nullptr };
+		I32 width{ 0 };
+		I32 height{ 0 };
+		U32 levels{ 1 };
+	};
+
+	struct Upload
+	{
+		U32 id;
+		U32 texture;
+		const U8* data;		//Every mip level back to back, largest first
+		bool owned;			//Decoded by stb_image, otherwise it points into the asset pack
+		PackFormat format;
+		I32 width;
+		I32 height;
+		U32 levels;
+		U32 level;
+		U64 levelOffset;
+		U32 row;			//In rows of data, rows of blocks for block compressed formats
+	};
 
-	static void LoadTexture(const std::string& path);
+	struct Staging;
+	struct Retired;
+
+	static Texture* Register(const std::string& name, const std::string& path);
+	static void Decoder();
+	static void BeginUpload(Image& image);
+	static void BeginUpload(U32 id, const U8* data, bool owned, PackFormat format, I32 width, I32 height, U32 levels, const std::string& path);
+	static void FreeData(const Upload& upload);
+	static void Swap(const Upload& upload);
+	static void ReleaseRetired(bool wait);
+	static void MakeResident(Slot& slot);
+	static void Evict(Slot& slot);
+	static void UpdateResidency();
+	static void SetHandle(const Slot& slot, U64 handle);
 
 	static std::string GetFileName(const std::string& path);
 
 	static std::map<std::string, Texture> textures;
+	static AssetPack pack;
+
+	static StringTable textureNames;
+	static std::vector<Slot> slots;
+	static U32 placeholder;
+	static U64 placeholderHandle;
+	static U32 handleTable;
+	static U64 frame;
+	static U64 residentBytes;
+	static F32 anisotropy;
+	static bool compressionSupported;
 
-	static std::vector<char*> textureNames;
-	static std::vector<U64> textureHandles;
+	static std::vector<std::thread> decoders;
+	static std::mutex decodeMutex;
+	static std::condition_variable decodeSignal;
+	static std::deque<Image> decodeQueue;
+	static std::vector<Image> decoded;
+	static std::vector<Image> ready;
+	static U32 decoding;
+	static bool stopDecoding;
+
+	static std::vector<Upload> uploads;
+	static std::vector<Retired> retired;
+	static Staging staging;
 
 	STATIC_CLASS(Resources);
 
 	friend class Renderer;
-};
\ No newline at end of file
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <atomic>
+
+/// <summary>
+/// Lock-free ring buffer for exactly one producer thread and one consumer thread
+/// </summary>
+/// <typeparam name="Type:">The element type, must be trivially copyable</typeparam>
+/// <typeparam name="Capacity:">The element count, must be a power of two</typeparam>
+template<class Type, U32 Capacity>
+class RingBuffer
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	bool Push(const Type& value)
+	{
+		U32 h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) >= Capacity) { return false; }
+
+		data[h & Mask] = value;
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Pushes several elements, the consumer sees either all of them or none
+	/// </summary>
+	bool PushRange(const Type* values, U32 count)
+	{
+		U32 h = head.load(std::memory_order_relaxed);
+		if (Capacity - (h - tail.load(std::memory_order_acquire)) < count) { return false; }
+
+		for (U32 i = 0; i < count; ++i) { data[(h + i) & Mask] = values[i]; }
+		head.store(h + count, std::memory_order_release);
+		return true;
+	}
+
+	bool Pop(Type& value)
+	{
+		U32 t = tail.load(std::memory_order_relaxed);
+		if (t == head.load(std::memory_order_acquire)) { return false; }
+
+		value = data[t & Mask];
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	U32 Size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+	bool Empty() const { return Size() == 0; }
+	void Clear() { tail.store(head.load(std::memory_order_acquire), std::memory_order_release); }
+
+	static constexpr U32 Mask = Capacity - 1;
+
+private:
+	alignas(64) std::atomic<U32> head{ 0 };
+	alignas(64) std::atomic<U32> tail{ 0 };
+	alignas(64) Type data[Capacity];
+};
\ No newline at end of file
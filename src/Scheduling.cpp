@@ -0,0 +1,287 @@
+#include "Scheduling.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef DV_PLATFORM_LINUX
+#	include <pthread.h>
+#	include <sched.h>
+#	include <sys/mman.h>
+#	include <sys/resource.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+std::mutex Scheduling::reportMutex;
+Scheduling::Report Scheduling::reports[MaxReports];
+U32 Scheduling::reportCount = 0;
+
+#ifdef DV_PLATFORM_LINUX
+static cpu_set_t processCpus;
+static I32 processNice = 0;
+
+static const C8* ErrorText(I32 error)
+{
+	switch (error)
+	{
+	case EPERM: case EACCES: return "not permitted";
+	case EINVAL: return "invalid";
+	case ENOMEM: case EAGAIN: return "over the memlock limit";
+	default: return "failed";
+	}
+}
+
+static id_t ThreadId()
+{
+	return static_cast<id_t>(syscall(SYS_gettid));
+}
+#elif defined DV_PLATFORM_WINDOWS
+static DWORD_PTR processCpus = 0;
+#endif
+
+void Scheduling::Initialize()
+{
+#ifdef DV_PLATFORM_LINUX
+	CPU_ZERO(&processCpus);
+	pthread_getaffinity_np(pthread_self(), sizeof(processCpus), &processCpus);
+
+	errno = 0;
+	I32 nice = getpriority(PRIO_PROCESS, ThreadId());
+	processNice = errno ? 0 : nice;
+#elif defined DV_PLATFORM_WINDOWS
+	DWORD_PTR systemCpus;
+	GetProcessAffinityMask(GetCurrentProcess(), &processCpus, &systemCpus);
+#endif
+}
+
+bool Scheduling::Apply(const C8* thread, const ThreadPolicy& policy)
+{
+	bool requested = policy.scheduling != SchedulingPolicy::Normal || policy.cpu >= 0;
+
+	C8 priorityText[64];
+	C8 affinityText[64];
+	bool granted = SetPriority(policy, priorityText, sizeof(priorityText));
+	granted &= SetAffinity(policy.cpu, affinityText, sizeof(affinityText));
+
+	//Threads left at the defaults aren't worth a line, unless undoing what they inherited failed
+	if (requested || !granted)
+	{
+		C8 text[ReportLength];
+		snprintf(text, sizeof(text), "%s thread: %s, %s", thread, priorityText, affinityText);
+		SetReport(thread, text);
+	}
+
+	return granted;
+}
+
+bool Scheduling::SetPriority(const ThreadPolicy& policy, C8* text, U64 size)
+{
+#ifdef DV_PLATFORM_LINUX
+	switch (policy.scheduling)
+	{
+	case SchedulingPolicy::Normal: {
+		//Only undone when inherited from a raised thread, an untouched thread costs two reads
+		I32 current;
+		sched_param param{};
+		bool granted = true;
+
+		if (pthread_getschedparam(pthread_self(), &current, &param) == 0 && current != SCHED_OTHER)
+		{
+			param.sched_priority = 0;
+			granted &= pthread_setschedparam(pthread_self(), SCHED_OTHER, &param) == 0;
+		}
+
+		errno = 0;
+		I32 nice = getpriority(PRIO_PROCESS, ThreadId());
+		if (!errno && nice != processNice) { granted &= setpriority(PRIO_PROCESS, ThreadId(), processNice) == 0; }
+
+		snprintf(text, size, granted ? "normal priority" : "normal priority not restored");
+		return granted;
+	}
+	case SchedulingPolicy::Nice: {
+		I32 nice = policy.priority < -20 ? -20 : (policy.priority > 19 ? 19 : policy.priority);
+
+		//Nice values are per thread on Linux, so this leaves the rest of the process alone
+		I32 error = setpriority(PRIO_PROCESS, ThreadId(), nice) == 0 ? 0 : errno;
+
+		errno = 0;
+		I32 current = getpriority(PRIO_PROCESS, ThreadId());
+		bool granted = !error && !errno && current == nice;
+
+		if (granted) { snprintf(text, size, "nice %d granted", nice); }
+		else { snprintf(text, size, "nice %d %s, running at nice %d", nice, ErrorText(error), current); }
+
+		return granted;
+	}
+	case SchedulingPolicy::RoundRobin:
+	case SchedulingPolicy::Fifo: {
+		I32 native = policy.scheduling == SchedulingPolicy::Fifo ? SCHED_FIFO : SCHED_RR;
+		const C8* name = native == SCHED_FIFO ? "SCHED_FIFO" : "SCHED_RR";
+
+		I32 minimum = sched_get_priority_min(native);
+		I32 maximum = sched_get_priority_max(native);
+		I32 priority = policy.priority < minimum ? minimum : (policy.priority > maximum ? maximum : policy.priority);
+
+		sched_param param{};
+		param.sched_priority = priority;
+		I32 error = pthread_setschedparam(pthread_self(), native, &param);
+
+		I32 current = SCHED_OTHER;
+		sched_param currentParam{};
+		pthread_getschedparam(pthread_self(), &current, &currentParam);
+		bool granted = !error && current == native && currentParam.sched_priority == priority;
+
+		if (granted) { snprintf(text, size, "%s %d granted", name, priority); }
+		else { snprintf(text, size, "%s %d %s", name, priority, ErrorText(error)); }
+
+		return granted;
+	}
+	}
+
+	snprintf(text, size, "unknown scheduling policy");
+	return false;
+#elif defined DV_PLATFORM_WINDOWS
+	//Windows has no real-time policies inside a normal priority class, these are the closest thread priorities
+	I32 priority = THREAD_PRIORITY_NORMAL;
+	const C8* name = "normal priority";
+
+	switch (policy.scheduling)
+	{
+	case SchedulingPolicy::Normal: break;
+	case SchedulingPolicy::Nice: {
+		if (policy.priority <= -10) { priority = THREAD_PRIORITY_HIGHEST; name = "highest priority"; }
+		else if (policy.priority < 0) { priority = THREAD_PRIORITY_ABOVE_NORMAL; name = "above normal priority"; }
+		else if (policy.priority >= 10) { priority = THREAD_PRIORITY_LOWEST; name = "lowest priority"; }
+		else if (policy.priority > 0) { priority = THREAD_PRIORITY_BELOW_NORMAL; name = "below normal priority"; }
+	} break;
+	case SchedulingPolicy::RoundRobin: { priority = THREAD_PRIORITY_HIGHEST; name = "highest priority"; } break;
+	case SchedulingPolicy::Fifo: { priority = THREAD_PRIORITY_TIME_CRITICAL; name = "time critical priority"; } break;
+	}
+
+	//Threads start at normal priority whatever created them, so there's nothing to undo
+	if (priority == THREAD_PRIORITY_NORMAL)
+	{
+		snprintf(text, size, "%s", name);
+		return true;
+	}
+
+	bool granted = SetThreadPriority(GetCurrentThread(), priority) && GetThreadPriority(GetCurrentThread()) == priority;
+	snprintf(text, size, "%s %s", name, granted ? "granted" : "denied");
+	return granted;
+#else
+	snprintf(text, size, "scheduling not supported");
+	return policy.scheduling == SchedulingPolicy::Normal;
+#endif
+}
+
+bool Scheduling::SetAffinity(I32 cpu, C8* text, U64 size)
+{
+#ifdef DV_PLATFORM_LINUX
+	cpu_set_t set;
+	CPU_ZERO(&set);
+
+	if (cpu < 0) { set = processCpus; }
+	else if (cpu < CPU_SETSIZE) { CPU_SET(cpu, &set); }
+	else
+	{
+		snprintf(text, size, "CPU %d invalid", cpu);
+		return false;
+	}
+
+	cpu_set_t current;
+	CPU_ZERO(&current);
+	pthread_getaffinity_np(pthread_self(), sizeof(current), &current);
+
+	if (cpu < 0 && CPU_EQUAL(&current, &set))
+	{
+		snprintf(text, size, "any CPU");
+		return true;
+	}
+
+	I32 error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+	pthread_getaffinity_np(pthread_self(), sizeof(current), &current);
+	bool granted = !error && CPU_EQUAL(&current, &set);
+
+	if (cpu < 0) { snprintf(text, size, granted ? "any CPU" : "CPUs not restored"); }
+	else if (granted) { snprintf(text, size, "CPU %d granted", cpu); }
+	else { snprintf(text, size, "CPU %d %s", cpu, ErrorText(error)); }
+
+	return granted;
+#elif defined DV_PLATFORM_WINDOWS
+	//Affinity isn't inherited on Windows either, any CPU is the default
+	if (cpu < 0)
+	{
+		snprintf(text, size, "any CPU");
+		return true;
+	}
+
+	DWORD_PTR mask = cpu < 64 ? (DWORD_PTR)1 << cpu : 0;
+	bool granted = (mask & processCpus) && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+
+	snprintf(text, size, "CPU %d %s", cpu, granted ? "granted" : "denied");
+	return granted;
+#else
+	snprintf(text, size, cpu < 0 ? "any CPU" : "CPU pinning not supported");
+	return cpu < 0;
+#endif
+}
+
+bool Scheduling::LockMemory(const void* hot, U64 size)
+{
+	C8 text[ReportLength];
+	bool granted = false;
+
+#ifdef DV_PLATFORM_LINUX
+	rlimit limit{};
+	getrlimit(RLIMIT_MEMLOCK, &limit);
+
+	//Past the limit MCL_FUTURE makes later allocations fail, so it's only asked for when there's no limit to hit
+	bool unlimited = limit.rlim_cur == RLIM_INFINITY;
+
+	if (mlockall(unlimited ? MCL_CURRENT | MCL_FUTURE : MCL_CURRENT) == 0)
+	{
+		granted = true;
+		if (unlimited) { snprintf(text, sizeof(text), "Memory: mlockall granted"); }
+		else
+		{
+			snprintf(text, sizeof(text), "Memory: mlockall of current pages granted, the %llu KiB memlock limit leaves later allocations unlocked",
+				(unsigned long long)(limit.rlim_cur / 1024));
+		}
+	}
+	else
+	{
+		I32 error = errno;
+		granted = mlock(hot, size) == 0;
+
+		snprintf(text, sizeof(text), "Memory: mlockall %s, %llu KiB of input data %s", ErrorText(error),
+			(unsigned long long)(size / 1024), granted ? "locked" : ErrorText(errno));
+	}
+#elif defined DV_PLATFORM_WINDOWS
+	granted = VirtualLock(const_cast<void*>(hot), size);
+	snprintf(text, sizeof(text), "Memory: no mlockall on Windows, %llu KiB of input data %s",
+		(unsigned long long)(size / 1024), granted ? "locked" : "denied");
+#else
+	snprintf(text, sizeof(text), "Memory: locking not supported");
+#endif
+
+	SetReport("Memory", text);
+	return granted;
+}
+
+void Scheduling::SetReport(const C8* name, const C8* text)
+{
+	std::cout << text << std::endl;
+
+	std::lock_guard<std::mutex> lock(reportMutex);
+
+	U32 index = 0;
+	while (index < reportCount && strcmp(reports[index].name, name) != 0) { ++index; }
+
+	if (index == MaxReports) { return; }
+	if (index == reportCount) { ++reportCount; }
+
+	reports[index].name = name;
+	snprintf(reports[index].text, sizeof(reports[index].text), "%s", text);
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include "Config.hpp"
+
+#include <mutex>
+
+/// <summary>
+/// Applies thread policies from the settings: real-time scheduling or niceness, CPU pinning and locking memory.
+/// Every request is checked against what the OS actually set and the outcome kept as a line of the report, so
+/// a missing rtprio or memlock limit shows up instead of silently running at default priority.
+/// </summary>
+class Scheduling
+{
+public:
+	/// <summary>
+	/// Remembers the CPUs the process may run on, call before any thread is pinned
+	/// </summary>
+	static void Initialize();
+
+	/// <summary>
+	/// Applies a policy to the calling thread. Threads inherit their creator's policy, so a thread asking for
+	/// none is put back on the process's CPUs at normal priority if it was left pinned or raised.
+	/// </summary>
+	/// <param name="thread:">Name used in the report, must be a string literal</param>
+	/// <returns>True if everything asked for was granted</returns>
+	static bool Apply(const C8* thread, const ThreadPolicy& policy);
+
+	/// <summary>
+	/// Locks the process's memory with mlockall, falling back to locking only the hot region when the memlock
+	/// limit is too low for the whole process
+	/// </summary>
+	/// <param name="hot:">The data the input path touches, locked on its own if the process can't be</param>
+	/// <returns>True if at least the hot region is locked</returns>
+	static bool LockMemory(const void* hot, U64 size);
+
+	/// <summary>
+	/// Calls function with every line of the report, under the report's lock
+	/// </summary>
+	template<class Function>
+	static void ForEachReport(Function&& function)
+	{
+		std::lock_guard<std::mutex> lock(reportMutex);
+		for (U32 i = 0; i < reportCount; ++i) { function(reports[i].text); }
+	}
+
+	static constexpr U32 MaxReports = 8;
+	static constexpr U32 ReportLength = 160;
+
+private:
+	struct Report
+	{
+		const C8* name;
+		C8 text[ReportLength];
+	};
+
+	/// <summary>
+	/// Prints a line and keeps it, replacing the previous line for the same name
+	/// </summary>
+	static void SetReport(const C8* name, const C8* text);
+
+	static bool SetPriority(const ThreadPolicy& policy, C8* text, U64 size);
+	static bool SetAffinity(I32 cpu, C8* text, U64 size);
+
+	static std::mutex reportMutex;
+	static Report reports[MaxReports];
+	static U32 reportCount;
+
+	STATIC_CLASS(Scheduling)
+};
\ No newline at end of file
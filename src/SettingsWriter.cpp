@@ -0,0 +1,118 @@
+#include "SettingsWriter.hpp"
+
+#include "Trace.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+std::thread SettingsWriter::writer;
+std::mutex SettingsWriter::mutex;
+std::condition_variable SettingsWriter::wake;
+std::string SettingsWriter::pending;
+std::string SettingsWriter::written;
+bool SettingsWriter::dirty = false;
+bool SettingsWriter::running = false;
+
+void SettingsWriter::Start()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (running) { return; }
+
+	running = true;
+	writer = std::thread(WriterThread);
+}
+
+void SettingsWriter::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		running = false;
+	}
+
+	wake.notify_one();
+	if (writer.joinable()) { writer.join(); }
+
+	//Whatever the writer didn't get to, or everything if it was never started
+	if (dirty)
+	{
+		dirty = false;
+		if (Write(pending)) { written = std::move(pending); }
+	}
+}
+
+void SettingsWriter::Queue(std::string config)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending = std::move(config);
+		dirty = true;
+	}
+
+	wake.notify_one();
+}
+
+bool SettingsWriter::Wrote(const std::string& config)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return config == written;
+}
+
+void SettingsWriter::WriterThread()
+{
+	Trace::SetThreadName("Settings Writer");
+
+	std::string config;
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true)
+	{
+		wake.wait(lock, []() { return dirty || !running; });
+		if (!running) { break; }
+
+		//Every change restarts the wait, dragging a slider writes once after it's let go
+		dirty = false;
+		if (wake.wait_for(lock, std::chrono::milliseconds(Debounce), []() { return dirty || !running; }))
+		{
+			//Stopped mid-wait, Stop writes the snapshot instead
+			if (!running) { dirty = true; }
+			continue;
+		}
+
+		config = pending;
+		lock.unlock();
+
+		bool success = Write(config);
+
+		lock.lock();
+		if (success) { written.swap(config); }
+	}
+}
+
+bool SettingsWriter::Write(const std::string& config)
+{
+	TRACE_ZONE("Write Settings");
+
+	std::string temporary = std::string(Path) + ".tmp";
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		std::cout << "Failed To Write Settings: " << Path << std::endl;
+		return false;
+	}
+
+	file << config;
+	file.close();
+
+	std::error_code error;
+	if (file) { std::filesystem::rename(temporary, Path, error); }
+	if (!file || error)
+	{
+		std::cout << "Failed To Write Settings: " << Path << std::endl;
+		std::filesystem::remove(temporary, error);
+		return false;
+	}
+
+	return true;
+}
\ No newline at end of file
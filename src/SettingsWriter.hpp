@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/// <summary>
+/// Saves settings.cfg from a background thread. Changes coming in close together are written once, the file is
+/// written next to settings.cfg and renamed over it so a crash or kill mid-write never leaves it truncated.
+/// </summary>
+class SettingsWriter
+{
+public:
+	static void Start();
+
+	/// <summary>
+	/// Writes whatever is still queued right away and joins the writer
+	/// </summary>
+	static void Stop();
+
+	/// <summary>
+	/// Queues a snapshot to be written once settings stop changing, never touches the disk on the calling thread
+	/// </summary>
+	/// <param name="config:">The config in settings.cfg format</param>
+	static void Queue(std::string config);
+
+	/// <summary>
+	/// Checks a config against the last one written, lets the file watcher skip our own writes
+	/// </summary>
+	static bool Wrote(const std::string& config);
+
+	static constexpr const C8* Path = "settings.cfg";
+	static constexpr U32 Debounce = 500;	//Milliseconds settings have to stay unchanged before they're written
+
+private:
+	static void WriterThread();
+	static bool Write(const std::string& config);
+
+	static std::thread writer;
+	static std::mutex mutex;
+	static std::condition_variable wake;
+	static std::string pending;
+	static std::string written;
+	static bool dirty;
+	static bool running;
+
+	STATIC_CLASS(SettingsWriter)
+};
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "Startup.hpp"
+
+#include "Time.hpp"
+#include "Trace.hpp"
+
+#include <cstdio>
+#include <iostream>
+
+std::deque<Startup::Task> Startup::tasks;
+U64 Startup::beginTime = 0;
+U64 Startup::firstFrameTime = 0;
+
+void Startup::Begin()
+{
+	beginTime = Time::Now();
+	firstFrameTime = 0;
+}
+
+U32 Startup::Launch(const C8* name, std::function<bool()> work)
+{
+	U32 id = static_cast<U32>(tasks.size());
+	Task& task = tasks.emplace_back();
+	task.name = name;
+	task.worker = true;
+
+	task.thread = std::thread([&task, work = std::move(work)]()
+	{
+		Trace::SetThreadName(task.name);
+
+		task.start = Time::Now();
+		{
+			TRACE_ZONE(task.name);
+			task.result = work();
+		}
+		task.end = Time::Now();
+
+		task.done.store(true, std::memory_order_release);
+	});
+
+	return id;
+}
+
+bool Startup::Run(const C8* name, const std::function<bool()>& work)
+{
+	Task& task = tasks.emplace_back();
+	task.name = name;
+	task.start = Time::Now();
+
+	{
+		TRACE_ZONE(name);
+		task.result = work();
+	}
+
+	task.end = Time::Now();
+	task.polled = true;
+	task.done = true;
+
+	return task.result;
+}
+
+bool Startup::Wait(U32 task)
+{
+	if (task >= tasks.size()) { return false; }
+
+	Task& t = tasks[task];
+	if (t.thread.joinable())
+	{
+		TRACE_ZONE("Wait For Task");
+		t.thread.join();
+	}
+
+	t.polled = true;
+	return t.result;
+}
+
+bool Startup::Poll(U32 task, bool& result)
+{
+	if (task >= tasks.size()) { return false; }
+
+	Task& t = tasks[task];
+	if (t.polled || !t.done.load(std::memory_order_acquire)) { return false; }
+
+	if (t.thread.joinable()) { t.thread.join(); }
+
+	t.polled = true;
+	result = t.result;
+	return true;
+}
+
+void Startup::FirstFrame()
+{
+	if (firstFrameTime) { return; }
+
+	firstFrameTime = Time::Now();
+
+	C8 line[128];
+	snprintf(line, sizeof(line), "Time to first frame: %.1f ms", GetTimeToFirstFrame());
+	std::cout << line << std::endl;
+
+#ifdef DV_DEBUG
+	for (const Task& task : tasks)
+	{
+		if (task.done.load(std::memory_order_acquire))
+		{
+			snprintf(line, sizeof(line), "  %-20s %-6s %8.1f - %8.1f ms", task.name, task.worker ? "worker" : "main",
+				Time::ToMilliseconds(static_cast<I64>(task.start - beginTime)), Time::ToMilliseconds(static_cast<I64>(task.end - beginTime)));
+		}
+		else { snprintf(line, sizeof(line), "  %-20s %-6s still running", task.name, task.worker ? "worker" : "main"); }
+
+		std::cout << line << std::endl;
+	}
+#endif
+}
+
+void Startup::Shutdown()
+{
+	for (Task& task : tasks)
+	{
+		if (task.thread.joinable()) { task.thread.join(); }
+	}
+
+	tasks.clear();
+}
+
+F64 Startup::GetTimeToFirstFrame()
+{
+	return firstFrameTime ? Time::ToMilliseconds(static_cast<I64>(firstFrameTime - beginTime)) : 0.0;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <thread>
+
+/// <summary>
+/// Startup task graph. A task either runs on its own worker thread or inline on the main thread, which owns the GL
+/// context, and a dependency is a wait on the task before starting the work that needs it. Every task is timed and
+/// the time to first frame is reported along with them.
+/// </summary>
+class Startup
+{
+public:
+	/// <summary>
+	/// Marks the start of startup, the time to first frame is measured from here
+	/// </summary>
+	static void Begin();
+
+	/// <summary>
+	/// Starts a task on a worker thread
+	/// </summary>
+	/// <param name="name:">A string literal naming the task</param>
+	/// <param name="work:">The task, returning false if it failed</param>
+	/// <returns>The task's id</returns>
+	static U32 Launch(const C8* name, std::function<bool()> work);
+
+	/// <summary>
+	/// Runs and times a task on the calling thread
+	/// </summary>
+	/// <returns>The task's result</returns>
+	static bool Run(const C8* name, const std::function<bool()>& work);
+
+	/// <summary>
+	/// Blocks until a task finishes
+	/// </summary>
+	/// <returns>The task's result</returns>
+	static bool Wait(U32 task);
+
+	/// <summary>
+	/// Checks a task without blocking, for work the first frame doesn't wait on
+	/// </summary>
+	/// <param name="result:">Receives the task's result once it's finished</param>
+	/// <returns>True on the first call after the task finished</returns>
+	static bool Poll(U32 task, bool& result);
+
+	/// <summary>
+	/// Reports the time to first frame, called once the first frame is presented
+	/// </summary>
+	static void FirstFrame();
+
+	/// <summary>
+	/// Joins any task that's still running
+	/// </summary>
+	static void Shutdown();
+
+	static F64 GetTimeToFirstFrame();
+
+private:
+	struct Task
+	{
+		const C8* name{ nullptr };
+		std::thread thread;
+		std::atomic<bool> done{ false };
+		bool result{ false };
+		bool polled{ false };
+		bool worker{ false };
+		U64 start{ 0 };
+		U64 end{ 0 };
+	};
+
+	static std::deque<Task> tasks;	//A deque so running workers keep their task's address as tasks are added
+	static U64 beginTime;
+	static U64 firstFrameTime;
+
+	STATIC_CLASS(Startup)
+};
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "Stress.hpp"
+
+#include "Visualizer.hpp"
+#include "Replay.hpp"
+#include "Time.hpp"
+#include "Trace.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+StressConfig Stress::config{};
+std::thread Stress::generator;
+std::atomic<bool> Stress::running{ false };
+std::atomic<bool> Stress::finished{ false };
+std::atomic<U64> Stress::sent{ 0 };
+std::atomic<U64> Stress::dropped{ 0 };
+std::atomic<U32> Stress::highWater{ 0 };
+Histogram Stress::frameTimes;
+Histogram Stress::callbackTimes;
+std::mutex Stress::callbackMutex;
+
+static thread_local bool generating = false;
+
+//General MIDI percussion notes, used for lanes the loaded profile doesn't map
+static constexpr U8 DefaultNotes[8] = { 38, 36, 42, 48, 51, 45, 49, 43 };
+
+bool Stress::Start(const StressConfig& config_)
+{
+	if (running || Replay::IsActive()) { return false; }
+
+	config = config_;
+
+	//Resolved here as the main thread owns the mappings
+	std::array<U8, 8> laneNotes;
+	for (U32 lane = 0; lane < 8; ++lane)
+	{
+		laneNotes[lane] = DefaultNotes[lane];
+
+		for (const Mapping& mapping : Visualizer::GetMappings())
+		{
+			if ((U32)mapping.type == lane)
+			{
+				laneNotes[lane] = static_cast<U8>(mapping.midiValue);
+				break;
+			}
+		}
+	}
+
+	Reset();
+
+	running = true;
+	finished = false;
+	generator = std::thread(Generate, config, laneNotes);
+
+#ifdef DV_DEBUG
+	std::cout << "Stress test started" << std::endl;
+#endif
+
+	return true;
+}
+
+void Stress::Stop()
+{
+	running = false;
+	if (generator.joinable()) { generator.join(); }
+}
+
+bool Stress::Update()
+{
+	if (!finished) { return false; }
+
+	finished = false;
+	if (generator.joinable()) { generator.join(); }
+
+	std::cout << "Stress test finished: " << sent.load() << " sent, " << dropped.load() << " dropped, queue high-water " <<
+		highWater.load() << '/' << Visualizer::InputQueueCapacity << std::endl;
+
+	return true;
+}
+
+bool Stress::IsRunning()
+{
+	return running;
+}
+
+bool Stress::IsGenerating()
+{
+	return generating;
+}
+
+void Stress::RecordCallback(U64 duration, U32 queueSize, bool drop)
+{
+	if (drop) { dropped.fetch_add(1, std::memory_order_relaxed); }
+
+	U32 high = highWater.load(std::memory_order_relaxed);
+	while (queueSize > high && !highWater.compare_exchange_weak(high, queueSize, std::memory_order_relaxed)) {}
+
+	std::lock_guard<std::mutex> lock(callbackMutex);
+	callbackTimes.Record(duration);
+}
+
+void Stress::RecordFrame(U64 frameTime)
+{
+	frameTimes.Record(frameTime);
+}
+
+void Stress::Reset()
+{
+	sent = 0;
+	dropped = 0;
+	highWater = 0;
+	frameTimes.Reset();
+
+	std::lock_guard<std::mutex> lock(callbackMutex);
+	callbackTimes.Reset();
+}
+
+bool Stress::ExportReport(const std::string& path)
+{
+	std::ofstream output(path);
+	if (!output.is_open())
+	{
+		std::cout << "Failed To Write Stress Report: " << path << std::endl;
+		return false;
+	}
+
+	Histogram callbacks;
+	GetCallbackTimes(callbacks);
+
+	output << "metric,value\n";
+	output << "sent," << sent.load() << '\n';
+	output << "dropped," << dropped.load() << '\n';
+	output << "queue_high_water," << highWater.load() << '\n';
+	output << "queue_capacity," << Visualizer::InputQueueCapacity << '\n';
+
+	auto percentiles = [&output](const C8* name, const Histogram& histogram)
+	{
+		output << name << "_count," << histogram.Total() << '\n';
+		output << name << "_p50_ms," << Time::ToMilliseconds(histogram.Percentile(50.0)) << '\n';
+		output << name << "_p90_ms," << Time::ToMilliseconds(histogram.Percentile(90.0)) << '\n';
+		output << name << "_p99_ms," << Time::ToMilliseconds(histogram.Percentile(99.0)) << '\n';
+		output << name << "_p99.9_ms," << Time::ToMilliseconds(histogram.Percentile(99.9)) << '\n';
+		output << name << "_max_ms," << Time::ToMilliseconds(histogram.Max()) << '\n';
+	};
+
+	percentiles("frame", frameTimes);
+	percentiles("callback", callbacks);
+
+	output.flush();
+	output.close();
+
+#ifdef DV_DEBUG
+	std::cout << "Stress report written to: " << path << std::endl;
+#endif
+
+	return true;
+}
+
+StressConfig& Stress::GetConfig()
+{
+	return config;
+}
+
+U64 Stress::GetSentCount()
+{
+	return sent;
+}
+
+U64 Stress::GetDroppedCount()
+{
+	return dropped;
+}
+
+U32 Stress::GetHighWater()
+{
+	return highWater;
+}
+
+const Histogram& Stress::GetFrameTimes()
+{
+	return frameTimes;
+}
+
+void Stress::GetCallbackTimes(Histogram& histogram)
+{
+	std::lock_guard<std::mutex> lock(callbackMutex);
+	histogram = callbackTimes;
+}
+
+void Stress::Generate(StressConfig config, std::array<U8, 8> laneNotes)
+{
+	generating = true;
+	Trace::SetThreadName("Stress");
+
+	enum class Kind { Note, Clock, Control, SysEx };
+
+	struct Stream
+	{
+		Kind kind;
+		U8 note;
+		U64 interval;
+		U64 base;
+		U64 next;
+	};
+
+	if (config.velocityMin > config.velocityMax) { std::swap(config.velocityMin, config.velocityMax); }
+
+	std::mt19937 random(std::random_device{}());
+	std::uniform_int_distribution<I32> uniformVelocity(config.velocityMin, config.velocityMax);
+	std::normal_distribution<F32> normalVelocity(config.velocityMean, config.velocityDeviation > 0.01f ? config.velocityDeviation : 0.01f);
+	std::uniform_int_distribution<I64> jitter(-static_cast<I64>(config.jitter * 1000000.0f), static_cast<I64>(config.jitter * 1000000.0f));
+	std::uniform_int_distribution<I32> step(-4, 4);
+
+	U64 start = Time::Now();
+	U64 end = config.duration > 0.0f ? start + static_cast<U64>(Time::FromSeconds(config.duration)) : U64_MAX;
+
+	Stream streams[11];
+	U32 streamCount = 0;
+
+	auto addStream = [&](Kind kind, U8 note, F32 rate)
+	{
+		if (rate <= 0.0f) { return; }
+		if (rate > MaxRate) { rate = MaxRate; }
+
+		U64 interval = static_cast<U64>(Time::FromSeconds(1.0 / rate));
+		streams[streamCount++] = { kind, note, interval, start, start };
+	};
+
+	for (U32 lane = 0; lane < 8; ++lane) { addStream(Kind::Note, laneNotes[lane], config.laneRates[lane]); }
+	addStream(Kind::Clock, 0, config.clockRate);
+	addStream(Kind::Control, 0, config.controlRate);
+	addStream(Kind::SysEx, 0, config.sysExRate);
+
+	I32 sysExSize = config.sysExSize < 3 ? 3 : config.sysExSize;
+
+	//RtMidi hands the callback a vector, reserving up front keeps the generator itself from allocating
+	std::vector<U8> message;
+	message.reserve(sysExSize);
+
+	I32 pedal = 0;
+	U64 previous = start;
+
+	while (running)
+	{
+		U64 now = Time::Now();
+		if (now >= end) { break; }
+
+		U64 nextDue = end;
+
+		for (U32 i = 0; i < streamCount; ++i)
+		{
+			Stream& stream = streams[i];
+
+			while (stream.next <= now && running)
+			{
+				message.clear();
+
+				switch (stream.kind)
+				{
+				case Kind::Note: {
+					I32 velocity = config.velocityMin;
+					switch (config.velocityDistribution)
+					{
+					case VelocityDistribution::Uniform: { velocity = uniformVelocity(random); } break;
+					case VelocityDistribution::Normal: { velocity = static_cast<I32>(normalVelocity(random) + 0.5f); } break;
+					case VelocityDistribution::Fixed: { velocity = static_cast<I32>(config.velocityMean + 0.5f); } break;
+					}
+
+					velocity = velocity < 1 ? 1 : (velocity > 127 ? 127 : velocity);
+
+					message.push_back(153);
+					message.push_back(stream.note);
+					message.push_back(static_cast<U8>(velocity));
+				} break;
+				case Kind::Clock: {
+					message.push_back(0xF8);
+				} break;
+				case Kind::Control: {
+					pedal += step(random);
+					pedal = pedal < 0 ? 0 : (pedal > 127 ? 127 : pedal);
+
+					message.push_back(185);
+					message.push_back(4);
+					message.push_back(static_cast<U8>(pedal));
+				} break;
+				case Kind::SysEx: {
+					message.push_back(0xF0);
+					message.push_back(0x7D);
+					for (I32 b = 2; b < sysExSize - 1; ++b) { message.push_back(static_cast<U8>(random() & 0x7F)); }
+					message.push_back(0xF7);
+				} break;
+				}
+
+				//Like RtMidi, the delta is the time since the previous message on this "port"
+				Visualizer::MidiCallback(Time::ToSeconds(static_cast<I64>(now - previous)), &message, nullptr);
+				previous = now;
+				sent.fetch_add(1, std::memory_order_relaxed);
+
+				stream.base += stream.interval;
+				I64 offset = jitter(random);
+				stream.next = offset < 0 && static_cast<U64>(-offset) > stream.base ? 0 : stream.base + offset;
+			}
+
+			if (stream.next < nextDue) { nextDue = stream.next; }
+		}
+
+		//Sleeping is only accurate to a millisecond or worse, so the last stretch is spent yielding
+		now = Time::Now();
+		if (nextDue > now + 2000000) { std::this_thread::sleep_for(std::chrono::nanoseconds(nextDue - now - 1000000)); }
+		else if (nextDue > now) { std::this_thread::yield(); }
+	}
+
+	running = false;
+	finished = true;
+	generating = false;
+}
\ No newline at end of file
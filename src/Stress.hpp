@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include "Histogram.hpp"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+enum class VelocityDistribution
+{
+	Uniform,
+	Normal,
+	Fixed
+};
+
+struct StressConfig
+{
+	F32 laneRates[8]{ 8.0f, 8.0f, 8.0f, 8.0f, 8.0f, 8.0f, 8.0f, 8.0f };	//Note-ons per second, indexed like the note stats
+	VelocityDistribution velocityDistribution{ VelocityDistribution::Uniform };
+	I32 velocityMin{ 1 };
+	I32 velocityMax{ 127 };
+	F32 velocityMean{ 100.0f };
+	F32 velocityDeviation{ 15.0f };
+	F32 jitter{ 0.0f };				//Maximum timing offset of every message in milliseconds
+	F32 clockRate{ 0.0f };			//Timing clock messages per second, 48 is 120 BPM
+	F32 controlRate{ 0.0f };		//Hi-hat pedal CC4 messages per second
+	F32 sysExRate{ 0.0f };			//SysEx messages per second
+	I32 sysExSize{ 64 };
+	F32 duration{ 10.0f };			//Seconds, 0 runs until stopped
+};
+
+/// <summary>
+/// Synthetic MIDI load generator, messages go through Visualizer::MidiCallback from its own thread exactly like
+/// a port's would. Input pipeline statistics are kept whether or not a run is active.
+/// </summary>
+class Stress
+{
+public:
+	static constexpr F32 MaxRate = 10000.0f;
+
+	static bool Start(const StressConfig& config);
+	static void Stop();
+
+	/// <summary>
+	/// Joins a finished run, called once per frame from the main loop
+	/// </summary>
+	/// <returns>True on the frame a run finishes</returns>
+	static bool Update();
+	static bool IsRunning();
+
+	/// <summary>
+	/// True on the generator thread, lets the callback skip its console echo
+	/// </summary>
+	static bool IsGenerating();
+
+	static void RecordCallback(U64 duration, U32 queueSize, bool dropped);
+	static void RecordFrame(U64 frameTime);
+	static void Reset();
+	static bool ExportReport(const std::string& path);
+
+	static StressConfig& GetConfig();
+	static U64 GetSentCount();
+	static U64 GetDroppedCount();
+	static U32 GetHighWater();
+	static const Histogram& GetFrameTimes();
+	static void GetCallbackTimes(Histogram& histogram);
+
+private:
+	static void Generate(StressConfig config, std::array<U8, 8> laneNotes);
+
+	static StressConfig config;
+	static std::thread generator;
+	static std::atomic<bool> running;
+	static std::atomic<bool> finished;
+	static std::atomic<U64> sent;
+	static std::atomic<U64> dropped;
+	static std::atomic<U32> highWater;
+	static Histogram frameTimes;
+	static Histogram callbackTimes;
+	static std::mutex callbackMutex;
+
+	STATIC_CLASS(Stress)
+};
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "StringTable.hpp"
+
+#include <cstring>
+
+U32 StringTable::Intern(std::string_view name)
+{
+	U64 hash = Hash(name.data(), name.size());
+
+	if (!buckets.empty())
+	{
+		U32 mask = static_cast<U32>(buckets.size()) - 1;
+
+		for (U32 i = static_cast<U32>(hash) & mask; buckets[i]; i = (i + 1) & mask)
+		{
+			U32 id = buckets[i] - 1;
+			if (hashes[id] == hash && lengths[id] == name.size() && memcmp(views[id], name.data(), name.size()) == 0) { return id; }
+		}
+	}
+
+	return Insert(name, hash);
+}
+
+U32 StringTable::Add(std::string_view name)
+{
+	return Insert(name, Hash(name.data(), name.size()));
+}
+
+U32 StringTable::Find(std::string_view name) const
+{
+	if (buckets.empty()) { return U32_MAX; }
+
+	U64 hash = Hash(name.data(), name.size());
+	U32 mask = static_cast<U32>(buckets.size()) - 1;
+	U32 found = U32_MAX;
+
+	//Duplicates added with Add share a probe chain, the lowest id is the first occurrence
+	for (U32 i = static_cast<U32>(hash) & mask; buckets[i]; i = (i + 1) & mask)
+	{
+		U32 id = buckets[i] - 1;
+		if (id < found && hashes[id] == hash && lengths[id] == name.size() && memcmp(views[id], name.data(), name.size()) == 0) { found = id; }
+	}
+
+	return found;
+}
+
+void StringTable::Clear()
+{
+	arena.clear();
+	offsets.clear();
+	lengths.clear();
+	hashes.clear();
+	views.clear();
+	for (U32& bucket : buckets) { bucket = 0; }
+}
+
+U32 StringTable::Insert(std::string_view name, U64 hash)
+{
+	U32 id = static_cast<U32>(views.size());
+	const C8* previous = arena.data();
+
+	offsets.push_back(static_cast<U32>(arena.size()));
+	lengths.push_back(static_cast<U32>(name.size()));
+	hashes.push_back(hash);
+	arena.insert(arena.end(), name.begin(), name.end());
+	arena.push_back('\0');
+
+	views.push_back(arena.data() + offsets[id]);
+
+	//Growing the arena moves every name, the views are rebuilt from their offsets
+	if (arena.data() != previous)
+	{
+		for (U32 i = 0; i < id; ++i) { views[i] = arena.data() + offsets[i]; }
+	}
+
+	//Kept at most half full so probe chains stay short
+	if ((id + 1) * 2 > buckets.size()) { Rehash(buckets.empty() ? 16 : static_cast<U32>(buckets.size()) * 2); }
+	else
+	{
+		U32 mask = static_cast<U32>(buckets.size()) - 1;
+		U32 i = static_cast<U32>(hash) & mask;
+		while (buckets[i]) { i = (i + 1) & mask; }
+		buckets[i] = id + 1;
+	}
+
+	return id;
+}
+
+void StringTable::Rehash(U32 bucketCount)
+{
+	buckets.assign(bucketCount, 0);
+	U32 mask = bucketCount - 1;
+
+	for (U32 id = 0; id < views.size(); ++id)
+	{
+		U32 i = static_cast<U32>(hashes[id]) & mask;
+		while (buckets[i]) { i = (i + 1) & mask; }
+		buckets[i] = id + 1;
+	}
+}
\ No newline at end of file
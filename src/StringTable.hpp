@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// List of names stored back to back in one contiguous arena, with a hash index for name to id lookups. Ids are
+/// positions in the list and stay stable until Clear. Views() is a C string array ImGui combos take directly.
+/// </summary>
+class StringTable
+{
+public:
+	/// <summary>
+	/// Adds a name, returning the id it already has if it was added before
+	/// </summary>
+	U32 Intern(std::string_view name);
+
+	/// <summary>
+	/// Adds a name even if it's already in the table, for lists whose ids have to line up with another list
+	/// </summary>
+	U32 Add(std::string_view name);
+
+	/// <summary>
+	/// Looks up a name
+	/// </summary>
+	/// <returns>The id of the name's first occurrence, U32_MAX if it isn't in the table</returns>
+	U32 Find(std::string_view name) const;
+
+	/// <summary>
+	/// Empties the table but keeps its memory, so a rescan doesn't reallocate
+	/// </summary>
+	void Clear();
+
+	const C8* Get(U32 id) const { return views[id]; }
+	const C8* operator[](U32 id) const { return views[id]; }
+	const C8* const* Views() const { return views.data(); }
+	U32 Size() const { return static_cast<U32>(views.size()); }
+	bool Empty() const { return views.empty(); }
+
+	const C8* const* begin() const { return views.data(); }
+	const C8* const* end() const { return views.data() + views.size(); }
+
+private:
+	U32 Insert(std::string_view name, U64 hash);
+	void Rehash(U32 bucketCount);
+
+	std::vector<C8> arena;
+	std::vector<U32> offsets;
+	std::vector<U32> lengths;
+	std::vector<U64> hashes;
+	std::vector<const C8*> views;
+	std::vector<U32> buckets;	//Open addressing, holds id + 1 so 0 is an empty bucket
+};
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <chrono>
+#include <cmath>
+
+class Time
+{
+public:
+	/// <summary>
+	/// Gets the host's monotonic clock, shared by every thread
+	/// </summary>
+	/// <returns>The time in nanoseconds</returns>
+	static U64 Now()
+	{
+		return static_cast<U64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	static F64 ToSeconds(I64 nanoseconds) { return nanoseconds / 1000000000.0; }
+	static F64 ToMilliseconds(I64 nanoseconds) { return nanoseconds / 1000000.0; }
+	static I64 FromSeconds(F64 seconds) { return static_cast<I64>(seconds * 1000000000.0); }
+
+	STATIC_CLASS(Time)
+};
+
+/// <summary>
+/// Maps the timestamps a MIDI driver gives in the time between messages back onto the host clock. The first message
+/// is anchored at the time it arrived, and whenever a message would land after its own arrival the anchor is pulled
+/// back, so the offset settles on the shortest delivery delay seen instead of every message's scheduling delay
+/// </summary>
+class DeviceClock
+{
+public:
+	/// <summary>
+	/// Forgets the anchor, for when the port is reopened and the driver's deltas start over
+	/// </summary>
+	void Reset() { started = false; }
+
+	/// <summary>
+	/// Places a message on the host clock
+	/// </summary>
+	/// <param name="deltaTime:">Seconds since the previous message, as stamped by the driver</param>
+	/// <param name="arrival:">Host time the message was handed to us, in nanoseconds</param>
+	/// <returns>The host time the driver received the message, in nanoseconds</returns>
+	U64 Map(F64 deltaTime, U64 arrival)
+	{
+		if (!started)
+		{
+			started = true;
+			anchor = arrival;
+			elapsed = 0;
+			return arrival;
+		}
+
+		//Rounded rather than truncated, a nanosecond lost per message would drift the clock early
+		elapsed += static_cast<I64>(std::llround(deltaTime * 1000000000.0));
+
+		U64 time = anchor + elapsed;
+		if (time > arrival)
+		{
+			anchor -= time - arrival;
+			time = arrival;
+		}
+
+		return time;
+	}
+
+private:
+	U64 anchor{ 0 };
+	I64 elapsed{ 0 };
+	bool started{ false };
+};
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "Trace.hpp"
+
+#include "Time.hpp"
+
+#include <fstream>
+#include <iostream>
+
+struct Trace::ThreadBuffer
+{
+	struct Event
+	{
+		const C8* name;
+		U64 start;
+		U64 end;
+	};
+
+	static constexpr U64 Capacity = 1 << 16;
+
+	U32 id;
+	const C8* name{ nullptr };
+	bool released{ false };		//Its thread exited, guarded by buffersMutex
+	std::atomic<U64> count{ 0 };
+	Event events[Capacity];
+};
+
+std::atomic<bool> Trace::enabled{ false };
+std::string Trace::path;
+U64 Trace::startTime = 0;
+std::mutex Trace::buffersMutex;
+std::vector<Trace::ThreadBuffer*> Trace::buffers;
+U32 Trace::nextId = 1;
+thread_local Trace::ThreadSlot Trace::threadSlot;
+
+void Trace::Start(const std::string& path_)
+{
+	path = path_;
+	startTime = Time::Now();
+
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		FreeReleased();
+		for (ThreadBuffer* buffer : buffers) { buffer->count = 0; }
+	}
+
+	enabled = true;
+
+#ifdef DV_DEBUG
+	std::cout << "Tracing To: " << path << std::endl;
+#endif
+}
+
+void Trace::Stop()
+{
+	if (!enabled) { return; }
+
+	enabled = false;
+	Write();
+}
+
+void Trace::SetThreadName(const C8* name)
+{
+	threadSlot.name = name;
+	if (threadSlot.buffer) { threadSlot.buffer->name = name; }
+}
+
+void Trace::Record(const C8* name, U64 start, U64 end)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+
+	//Only this thread writes the buffer, the oldest events are overwritten once it's full
+	U64 index = buffer->count.load(std::memory_order_relaxed);
+	buffer->events[index & (ThreadBuffer::Capacity - 1)] = { name, start, end };
+	buffer->count.store(index + 1, std::memory_order_release);
+}
+
+Trace::Zone::Zone(const C8* name_) : name(nullptr), start(0)
+{
+	if (!Trace::IsEnabled()) { return; }
+
+	name = name_;
+	start = Time::Now();
+}
+
+Trace::Zone::~Zone()
+{
+	if (name) { Trace::Record(name, start, Time::Now()); }
+}
+
+Trace::ThreadBuffer* Trace::GetThreadBuffer()
+{
+	//Zones only record while tracing, so a thread that never traces never gets a buffer
+	if (!threadSlot.buffer)
+	{
+		ThreadBuffer* buffer = new ThreadBuffer();
+		buffer->name = threadSlot.name;
+
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		buffer->id = nextId++;
+		buffers.push_back(buffer);
+		threadSlot.buffer = buffer;
+	}
+
+	return threadSlot.buffer;
+}
+
+Trace::ThreadSlot::~ThreadSlot()
+{
+	if (!buffer) { return; }
+
+	//Its events may not have been written yet, the buffer is freed by the next Start or Stop
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	buffer->released = true;
+}
+
+void Trace::FreeReleased()
+{
+	std::erase_if(buffers, [](ThreadBuffer* buffer)
+	{
+		if (!buffer->released) { return false; }
+
+		delete buffer;
+		return true;
+	});
+}
+
+void Trace::Write()
+{
+	std::ofstream output(path);
+	if (!output.is_open())
+	{
+		std::cout << "Failed To Write Trace: " << path << std::endl;
+		return;
+	}
+
+	output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	output << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"DrumVisualizer\"}}";
+
+	output.setf(std::ios::fixed);
+	output.precision(3);
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+
+	for (ThreadBuffer* buffer : buffers)
+	{
+		if (buffer->name)
+		{
+			output << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id <<
+				",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+		}
+
+		U64 count = buffer->count.load(std::memory_order_acquire);
+		U64 first = count > ThreadBuffer::Capacity ? count - ThreadBuffer::Capacity : 0;
+
+		for (U64 i = first; i < count; ++i)
+		{
+			const ThreadBuffer::Event& event = buffer->events[i & (ThreadBuffer::Capacity - 1)];
+			if (event.start < startTime) { continue; }
+
+			output << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id <<
+				",\"ts\":" << (event.start - startTime) / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0 << '}';
+		}
+	}
+
+	FreeReleased();
+
+	output << "\n]}\n";
+	output.flush();
+	output.close();
+
+#ifdef DV_DEBUG
+	std::cout << "Trace written to: " << path << std::endl;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Scoped zone tracer that writes chrome://tracing / Perfetto JSON. Every thread records into its own ring
+/// buffer, so recording takes no locks, and a disabled tracer costs a single relaxed load per zone. Buffers are only
+/// made for threads that record while tracing, and the ones whose threads exited are freed once their events have
+/// been written.
+/// </summary>
+class Trace
+{
+public:
+	static void Start(const std::string& path);
+	static void Stop();
+	static bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+	/// <summary>
+	/// Names the calling thread in the trace output, costs a store so threads can call it whether tracing or not
+	/// </summary>
+	/// <param name="name:">The thread name, must be a string literal</param>
+	static void SetThreadName(const C8* name);
+
+	/// <summary>
+	/// Records a zone, name must be a string literal as only the pointer is kept
+	/// </summary>
+	static void Record(const C8* name, U64 start, U64 end);
+
+	struct Zone
+	{
+		Zone(const C8* name);
+		~Zone();
+
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+
+	private:
+		const C8* name;
+		U64 start;
+	};
+
+private:
+	struct ThreadBuffer;
+
+	struct ThreadSlot
+	{
+		~ThreadSlot();
+
+		ThreadBuffer* buffer{ nullptr };
+		const C8* name{ nullptr };
+	};
+
+	static ThreadBuffer* GetThreadBuffer();
+	static void Write();
+	static void FreeReleased();
+
+	static std::atomic<bool> enabled;
+	static std::string path;
+	static U64 startTime;
+	static std::mutex buffersMutex;
+	static std::vector<ThreadBuffer*> buffers;
+	static U32 nextId;
+	static thread_local ThreadSlot threadSlot;
+
+	STATIC_CLASS(Trace)
+};
+
+#define DV_TRACE_CONCAT_INNER(a, b) a##b
+#define DV_TRACE_CONCAT(a, b) DV_TRACE_CONCAT_INNER(a, b)
+
+#ifdef DV_NO_TRACE
+#	define TRACE_ZONE(name)
+#else
+#	define TRACE_ZONE(name) Trace::Zone DV_TRACE_CONCAT(traceZone, __LINE__)(name) //Traces the enclosing scope
+#endif
\ No newline at end of file
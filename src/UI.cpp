@@ -2,7 +2,13 @@
 
 #include "GraphicsInclude.hpp"
 #include "Visualizer.hpp"
+#include "Latency.hpp"
+#include "Stress.hpp"
+#include "Scheduling.hpp"
+#include "Time.hpp"
+#include "FrameArena.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 Window* UI::settingsWindow;
@@ -16,14 +22,16 @@ F32 UI::statsSize = 60.0f;
 Settings* UI::settings;
 std::array<Stats, 8>* UI::stats;
 std::array<NoteInfo, 8>* UI::noteInfos;
-const std::vector<char*>* UI::ports;
-const std::vector<char*>* UI::profiles;
-const std::vector<char*>* UI::colorProfiles;
-const std::vector<char*>* UI::midiProfiles;
-const std::vector<char*>* UI::textures;
+const StringTable* UI::ports;
+const StringTable* UI::profiles;
+const StringTable* UI::colorProfiles;
+const StringTable* UI::midiProfiles;
+const StringTable* UI::textures;
 
 const char* UI::directions[] = { "Up", "Down", "Left", "Right" };
 const char* UI::separationModes[] = { "None", "Cutoff", "Squish" };
+const char* UI::laneNames[] = { "Snare", "Kick", "Cymbal 1", "Tom 1", "Cymbal 2", "Tom 2", "Cymbal 3", "Tom 3" };
+const char* UI::velocityDistributions[] = { "Uniform", "Normal", "Fixed" };
 I32 UI::direction;
 I32 UI::separationMode;
 I32 UI::tomId;
@@ -33,6 +41,7 @@ I32 UI::portId;
 I32 UI::profileId;
 I32 UI::colorProfileId;
 I32 UI::midiProfileId;
+F32 UI::stressAllLanes = 8.0f;
 
 bool UI::Initialize(Window* settingsWindow_, Window* visualizerWindow_)
 {
@@ -77,45 +86,28 @@ bool UI::Initialize(Window* settingsWindow_, Window* visualizerWindow_)
 	tomId = settings->tomTexture->id;
 	cymbalId = settings->cymbalTexture->id;
 	kickId = settings->kickTexture->id;
-	profileId = settings->profileId;
-
-	I32 i = 0;
-	for (const std::string& port : *ports)
-	{
-		if (port == settings->portName)
-		{
-			portId = i;
-			break;
-		}
 
-		++i;
-	}
+	RefreshPorts();
+	RefreshProfiles();
 
-	i = 0;
-	for (const std::string& profile : *colorProfiles)
-	{
-		if (profile == settings->colorProfileName)
-		{
-			colorProfileId = i;
-			break;
-		}
+	return true;
+}
 
-		++i;
-	}
+void UI::RefreshPorts()
+{
+	U32 id = ports->Find(settings->portName);
+	if (id != U32_MAX) { portId = (I32)id; }
+}
 
-	i = 0;
-	for (const std::string& profile : *midiProfiles)
-	{
-		if (profile == settings->midiProfileName)
-		{
-			midiProfileId = i;
-			break;
-		}
+void UI::RefreshProfiles()
+{
+	profileId = settings->profileId;
 
-		++i;
-	}
+	U32 id = colorProfiles->Find(settings->colorProfileName);
+	if (id != U32_MAX) { colorProfileId = (I32)id; }
 
-	return true;
+	id = midiProfiles->Find(settings->midiProfileName);
+	if (id != U32_MAX) { midiProfileId = (I32)id; }
 }
 
 void UI::Shutdown()
@@ -150,6 +142,8 @@ void UI::Render(Window* window)
 		ImGui::SetNextWindowPos(viewport->Pos);
 		ImGui::SetNextWindowSize(viewport->Size);
 
+		bool changed = false;
+
 		if (ImGui::Begin("Settings", NULL, flags))
 		{
 			ImGui::Text("Press F1 to toggle config mode to drag and resize visualizer window");
@@ -159,6 +153,7 @@ void UI::Render(Window* window)
 			ImGui::SameLine();
 			if (ImGui::Checkbox("##ShowStats", &settings->showStats))
 			{
+				changed = true;
 				Visualizer::SetScrollDirection((ScrollDirection)direction);
 			}
 
@@ -177,39 +172,77 @@ void UI::Render(Window* window)
 			ImGui::SameLine();
 			if (ImGui::Checkbox("##LongKicks", &settings->longKicks))
 			{
+				changed = true;
 				Visualizer::SetScrollDirection((ScrollDirection)direction);
 			}
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Show Dynamics:");
 			ImGui::SameLine();
-			ImGui::Checkbox("##ShowDynamics", &settings->showDynamics);
+			changed |= ImGui::Checkbox("##ShowDynamics", &settings->showDynamics);
+
+			ImGui::AlignTextToFramePadding();
+			ImGui::Text("Choke On Note Off:");
+			ImGui::SameLine();
+			changed |= ImGui::Checkbox("##ChokeOnNoteOff", &settings->chokeOnNoteOff);
+
+			ImGui::AlignTextToFramePadding();
+			ImGui::Text("Show Latency:");
+			ImGui::SameLine();
+			changed |= ImGui::Checkbox("##ShowLatency", &settings->showLatency);
+
+			ImGui::SameLine();
+			if (ImGui::Button("Export Latency Report"))
+			{
+				Latency::ExportReport("latency.csv");
+			}
+
+			ImGui::SameLine();
+			if (ImGui::Button("Reset Latency"))
+			{
+				Latency::Reset();
+			}
+
+			ImGui::AlignTextToFramePadding();
+			ImGui::Text("Record Sessions:");
+			ImGui::SameLine();
+			bool recording = settings->recordSessions;
+			if (ImGui::Checkbox("##RecordSessions", &recording))
+			{
+				Visualizer::SetRecording(recording);
+				changed = true;
+			}
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Scroll Speed:");
 			ImGui::SameLine();
 			ImGui::SliderFloat("##ScrollSpeed", &settings->scrollSpeed, 0.25f, 5.0f, "%.2f");
+			changed |= ImGui::IsItemDeactivatedAfterEdit();
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Note Width:");
 			ImGui::SameLine();
 			ImGui::SliderFloat("##NoteWidth", &settings->noteWidth, 0.01f, 0.125f, "%.3f");
+			changed |= ImGui::IsItemDeactivatedAfterEdit();
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Note Height:");
 			ImGui::SameLine();
 			ImGui::SliderFloat("##NoteHeight", &settings->noteHeight, 0.01f, 0.125f, "%.3f");
+			changed |= ImGui::IsItemDeactivatedAfterEdit();
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Note Gap:");
 			ImGui::SameLine();
 			ImGui::SliderFloat("##NoteGap", &settings->noteGap, 0.0f, 0.01f, "%.3f");
+			changed |= ImGui::IsItemDeactivatedAfterEdit();
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Note Separation Mode:");
 			ImGui::SameLine();
 			if (ImGui::Combo("##NoteSeparationMode", &separationMode, separationModes, IM_COUNTOF(separationModes)))
 			{
+				changed = true;
 				settings->noteSeparationMode = (NoteSeparationMode)separationMode;
 			}
 
@@ -218,50 +251,59 @@ void UI::Render(Window* window)
 			ImGui::SameLine();
 			if (ImGui::Combo("##ScrollDirection", &direction, directions, IM_COUNTOF(directions)))
 			{
+				changed = true;
 				Visualizer::SetScrollDirection((ScrollDirection)direction);
 			}
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Tom Texture:");
 			ImGui::SameLine();
-			if (ImGui::Combo("##TomTexture", &tomId, textures->data(), (I32)textures->size()))
+			if (ImGui::Combo("##TomTexture", &tomId, textures->Views(), (I32)textures->Size()))
 			{
-				settings->tomTextureName = textures->at(tomId);
+				changed = true;
+				settings->tomTextureName = textures->Get(tomId);
 				settings->tomTexture = Resources::GetTexture(settings->tomTextureName);
 			}
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Cymbal Texture:");
 			ImGui::SameLine();
-			if (ImGui::Combo("##CymbalTexture", &cymbalId, textures->data(), (I32)textures->size()))
+			if (ImGui::Combo("##CymbalTexture", &cymbalId, textures->Views(), (I32)textures->Size()))
 			{
-				settings->cymbalTextureName = textures->at(cymbalId);
+				changed = true;
+				settings->cymbalTextureName = textures->Get(cymbalId);
 				settings->cymbalTexture = Resources::GetTexture(settings->cymbalTextureName);
 			}
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Kick Texture:");
 			ImGui::SameLine();
-			if (ImGui::Combo("##KickTexture", &kickId, textures->data(), (I32)textures->size()))
+			if (ImGui::Combo("##KickTexture", &kickId, textures->Views(), (I32)textures->Size()))
 			{
-				settings->kickTextureName = textures->at(kickId);
+				changed = true;
+				settings->kickTextureName = textures->Get(kickId);
 				settings->kickTexture = Resources::GetTexture(settings->kickTextureName);
 			}
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Midi Ports:");
 			ImGui::SameLine();
-			if (ImGui::Combo("##MidiPorts", &portId, ports->data(), (I32)ports->size()))
+			if (ImGui::Combo("##MidiPorts", &portId, ports->Views(), (I32)ports->Size()))
 			{
-				settings->portName = ports->at(portId);
+				changed = true;
+				settings->portName = ports->Get(portId);
 				Visualizer::LoadPort(settings->portName);
 			}
 
+			F64 clockTempo = Visualizer::GetEngine().GetClockTempo(Time::Now());
+			if (clockTempo > 0.0) { ImGui::Text("MIDI Clock: %.1f BPM", clockTempo); }
+
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("CH Profiles:");
 			ImGui::SameLine();
-			if (ImGui::Combo("##CHProfiles", &profileId, profiles->data(), (I32)profiles->size()))
+			if (ImGui::Combo("##CHProfiles", &profileId, profiles->Views(), (I32)profiles->Size()))
 			{
+				changed = true;
 				settings->profileId = profileId;
 				Visualizer::SetProfile(profileId);
 			}
@@ -269,25 +311,28 @@ void UI::Render(Window* window)
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Color Profiles:");
 			ImGui::SameLine();
-			if (ImGui::Combo("##ColorProfiles", &colorProfileId, colorProfiles->data(), (I32)colorProfiles->size()))
+			if (ImGui::Combo("##ColorProfiles", &colorProfileId, colorProfiles->Views(), (I32)colorProfiles->Size()))
 			{
-				settings->colorProfileName = colorProfiles->at(colorProfileId);
-				Visualizer::SetColorProfile(colorProfiles->at(colorProfileId));
+				changed = true;
+				settings->colorProfileName = colorProfiles->Get(colorProfileId);
+				Visualizer::SetColorProfile(colorProfiles->Get(colorProfileId));
 			}
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Midi Profiles:");
 			ImGui::SameLine();
-			if (ImGui::Combo("##MidiProfiles", &midiProfileId, midiProfiles->data(), (I32)midiProfiles->size()))
+			if (ImGui::Combo("##MidiProfiles", &midiProfileId, midiProfiles->Views(), (I32)midiProfiles->Size()))
 			{
-				settings->midiProfileName = midiProfiles->at(midiProfileId);
-				Visualizer::SetMidiProfile(midiProfiles->at(midiProfileId));
+				changed = true;
+				settings->midiProfileName = midiProfiles->Get(midiProfileId);
+				Visualizer::SetMidiProfile(midiProfiles->Get(midiProfileId));
 			}
 
 			ImGui::AlignTextToFramePadding();
 			ImGui::Text("Background Color:");
 			ImGui::SameLine();
 			ImGui::ColorEdit4("##BackgroundColor", (F32*)&settings->backgroundColor, ImGuiColorEditFlags_NoInputs);
+			changed |= ImGui::IsItemDeactivatedAfterEdit();
 
 			const F32 size = 70.0f;
 			const F32 spacing = 8.0f;
@@ -332,15 +377,21 @@ void UI::Render(Window* window)
 						}
 
 						Visualizer::SetScrollDirection((ScrollDirection)direction);
+						changed = true;
 					}
 					ImGui::EndDragDropTarget();
 				}
 
 				ImGui::PopID();
 			}
+
+			StressPanel();
+			ThreadPanel();
 		}
 
 		ImGui::End();
+
+		if (changed) { Visualizer::SettingsChanged(); }
 	}
 	else if (settings->showStats)
 	{
@@ -383,7 +434,7 @@ void UI::Render(Window* window)
 				count = 7;
 				for (NoteInfo& note : *noteInfos)
 				{
-					if (note.name == "Kick")
+					if (note.index == (U32)NoteType::Kick)
 					{
 						Stats& s = stats->at(note.index);
 						SetupKick(s.hitCount, s.ghostCount, settings->showDynamics);
@@ -403,7 +454,7 @@ void UI::Render(Window* window)
 
 					for (NoteInfo& note : *noteInfos)
 					{
-						if (settings->longKicks && note.name == "Kick") { continue; }
+						if (settings->longKicks && note.index == (U32)NoteType::Kick) { continue; }
 						Stats& s = stats->at(note.index);
 						SetupColumn(s.hitCount, s.ghostCount, rowHeight, blockHeight, settings->showDynamics);
 					}
@@ -423,7 +474,7 @@ void UI::Render(Window* window)
 
 					for (I64 i = noteInfos->size() - 1; i >= 0; --i)
 					{
-						if (settings->longKicks && noteInfos->at(i).name == "Kick") { continue; }
+						if (settings->longKicks && noteInfos->at(i).index == (U32)NoteType::Kick) { continue; }
 						Stats& s = stats->at(noteInfos->at(i).index);
 						SetupRow(s.hitCount, s.ghostCount, rowHeight, blockHeight, settings->showDynamics);
 					}
@@ -436,27 +487,192 @@ void UI::Render(Window* window)
 		ImGui::End();
 	}
 
+	if (window == visualizerWindow && settings->showLatency) { LatencyOverlay(); }
+
 	ImGui::Render();
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+void UI::LatencyOverlay()
+{
+	const ImGuiViewport* viewport = ImGui::GetMainViewport();
+	ImGui::SetNextWindowPos(ImVec2(viewport->Pos.x + 4.0f, viewport->Pos.y + 4.0f));
+	ImGui::SetNextWindowBgAlpha(0.6f);
+
+	if (ImGui::Begin("Latency", NULL, flags | ImGuiWindowFlags_AlwaysAutoResize))
+	{
+		ImGui::Text("%-7s %7s %7s %7s", "ms", "p50", "p99", "p99.9");
+
+		for (U32 i = 0; i < (U32)LatencyStage::Count; ++i)
+		{
+			const Histogram& histogram = Latency::GetHistogram((LatencyStage)i);
+
+			ImGui::Text("%-7s %7.2f %7.2f %7.2f", Latency::GetStageName((LatencyStage)i),
+				histogram.Percentile(50.0) / 1000000.0,
+				histogram.Percentile(99.0) / 1000000.0,
+				histogram.Percentile(99.9) / 1000000.0);
+		}
+	}
+
+	ImGui::End();
+}
+
+void UI::StressPanel()
+{
+	if (!ImGui::CollapsingHeader("Stress Test")) { return; }
+
+	StressConfig& config = Stress::GetConfig();
+	bool running = Stress::IsRunning();
+
+	ImGui::BeginDisabled(running);
+
+	ImGui::AlignTextToFramePadding();
+	ImGui::Text("All Lanes (hits/s):");
+	ImGui::SameLine();
+	if (ImGui::DragFloat("##StressAllLanes", &stressAllLanes, 1.0f, 0.0f, Stress::MaxRate, "%.0f"))
+	{
+		for (F32& rate : config.laneRates) { rate = stressAllLanes; }
+	}
+
+	for (U32 i = 0; i < CountOf(laneNames); ++i)
+	{
+		ImGui::PushID(i);
+		ImGui::AlignTextToFramePadding();
+		ImGui::Text("%s (hits/s):", laneNames[i]);
+		ImGui::SameLine();
+		ImGui::DragFloat("##StressLane", &config.laneRates[i], 1.0f, 0.0f, Stress::MaxRate, "%.0f");
+		ImGui::PopID();
+	}
+
+	ImGui::AlignTextToFramePadding();
+	ImGui::Text("Velocity:");
+	ImGui::SameLine();
+	I32 distribution = (I32)config.velocityDistribution;
+	if (ImGui::Combo("##StressVelocity", &distribution, velocityDistributions, (I32)CountOf(velocityDistributions)))
+	{
+		config.velocityDistribution = (VelocityDistribution)distribution;
+	}
+
+	switch (config.velocityDistribution)
+	{
+	case VelocityDistribution::Uniform: {
+		ImGui::AlignTextToFramePadding();
+		ImGui::Text("Velocity Range:");
+		ImGui::SameLine();
+		ImGui::DragIntRange2("##StressVelocityRange", &config.velocityMin, &config.velocityMax, 1.0f, 1, 127);
+	} break;
+	case VelocityDistribution::Normal: {
+		ImGui::AlignTextToFramePadding();
+		ImGui::Text("Velocity Mean:");
+		ImGui::SameLine();
+		ImGui::SliderFloat("##StressVelocityMean", &config.velocityMean, 1.0f, 127.0f, "%.0f");
+
+		ImGui::AlignTextToFramePadding();
+		ImGui::Text("Velocity Deviation:");
+		ImGui::SameLine();
+		ImGui::SliderFloat("##StressVelocityDeviation", &config.velocityDeviation, 0.0f, 64.0f, "%.1f");
+	} break;
+	case VelocityDistribution::Fixed: {
+		ImGui::AlignTextToFramePadding();
+		ImGui::Text("Velocity Value:");
+		ImGui::SameLine();
+		ImGui::SliderFloat("##StressVelocityMean", &config.velocityMean, 1.0f, 127.0f, "%.0f");
+	} break;
+	}
+
+	ImGui::AlignTextToFramePadding();
+	ImGui::Text("Jitter (ms):");
+	ImGui::SameLine();
+	ImGui::SliderFloat("##StressJitter", &config.jitter, 0.0f, 20.0f, "%.1f");
+
+	ImGui::AlignTextToFramePadding();
+	ImGui::Text("Clock (msgs/s):");
+	ImGui::SameLine();
+	ImGui::DragFloat("##StressClock", &config.clockRate, 1.0f, 0.0f, Stress::MaxRate, "%.0f");
+
+	ImGui::AlignTextToFramePadding();
+	ImGui::Text("CC4 (msgs/s):");
+	ImGui::SameLine();
+	ImGui::DragFloat("##StressControl", &config.controlRate, 1.0f, 0.0f, Stress::MaxRate, "%.0f");
+
+	ImGui::AlignTextToFramePadding();
+	ImGui::Text("SysEx (msgs/s):");
+	ImGui::SameLine();
+	ImGui::DragFloat("##StressSysEx", &config.sysExRate, 1.0f, 0.0f, Stress::MaxRate, "%.0f");
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(80.0f);
+	ImGui::DragInt("bytes##StressSysExSize", &config.sysExSize, 1.0f, 3, 4096);
+
+	ImGui::AlignTextToFramePadding();
+	ImGui::Text("Duration (s):");
+	ImGui::SameLine();
+	ImGui::DragFloat("##StressDuration", &config.duration, 1.0f, 0.0f, 3600.0f, config.duration > 0.0f ? "%.0f" : "Until Stopped");
+
+	ImGui::EndDisabled();
+
+	if (running)
+	{
+		if (ImGui::Button("Stop")) { Stress::Stop(); }
+	}
+	else if (ImGui::Button("Start")) { Stress::Start(config); }
+
+	ImGui::SameLine();
+	if (ImGui::Button("Export Stress Report"))
+	{
+		Stress::ExportReport("stress.csv");
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Reset Stress Stats"))
+	{
+		Stress::Reset();
+	}
+
+	const Histogram& frames = Stress::GetFrameTimes();
+	//Snapshot of the callback thread's histogram, too big to copy onto the stack every frame
+	Histogram* callbacks = FrameArena::Allocate<Histogram>();
+	Stress::GetCallbackTimes(*callbacks);
+
+	ImGui::Text("Sent: %llu  Dropped: %llu  Queue High-Water: %u/%u", Stress::GetSentCount(), Stress::GetDroppedCount(),
+		Stress::GetHighWater(), Visualizer::InputQueueCapacity);
+	ImGui::Text("Frame ms     p50 %7.2f  p99 %7.2f  max %7.2f", frames.Percentile(50.0) / 1000000.0,
+		frames.Percentile(99.0) / 1000000.0, frames.Max() / 1000000.0);
+	ImGui::Text("Callback us  p50 %7.2f  p99 %7.2f  max %7.2f", callbacks->Percentile(50.0) / 1000.0,
+		callbacks->Percentile(99.0) / 1000.0, callbacks->Max() / 1000.0);
+}
+
+void UI::ThreadPanel()
+{
+	if (!ImGui::CollapsingHeader("Thread Policies")) { return; }
+
+	//Only threads asking for something show up, along with what the OS actually gave them
+	bool empty = true;
+	Scheduling::ForEachReport([&empty](const C8* line)
+	{
+		ImGui::TextUnformatted(line);
+		empty = false;
+	});
+
+	if (empty) { ImGui::TextUnformatted("Default policies, set inputScheduling or renderScheduling in settings.cfg"); }
+}
+
 void UI::SetupColumn(U32 value1, U32 value2, F32 rowHeight, F32 blockHeight, bool showDynamics)
 {
 	ImGui::TableNextColumn();
 
-	std::string text1 = std::to_string(value1);
-	std::string text2 = std::to_string(value2);
+	const C8* text1 = FrameArena::Format("%u", value1);
+	const C8* text2 = FrameArena::Format("%u", value2);
 
 	F32 startPosY = ImGui::GetCursorPosY() + (rowHeight - blockHeight) * 0.5f;
 
 	ImGui::SetCursorPosY(startPosY);
-	ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (ImGui::GetColumnWidth() - ImGui::CalcTextSize(text1.c_str()).x) * 0.5f);
-	ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), text1.c_str());
+	ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (ImGui::GetColumnWidth() - ImGui::CalcTextSize(text1).x) * 0.5f);
+	ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), text1);
 
 	if (showDynamics)
 	{
-		ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (ImGui::GetColumnWidth() - ImGui::CalcTextSize(text2.c_str()).x) * 0.5f);
-		ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), text2.c_str());
+		ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (ImGui::GetColumnWidth() - ImGui::CalcTextSize(text2).x) * 0.5f);
+		ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), text2);
 	}
 }
 
@@ -465,37 +681,37 @@ void UI::SetupRow(U32 value1, U32 value2, F32 rowHeight, F32 blockHeight, bool s
 	ImGui::TableNextRow(ImGuiTableRowFlags_None, rowHeight);
 	ImGui::TableNextColumn();
 
-	std::string text1 = std::to_string(value1);
-	std::string text2 = std::to_string(value2);
+	const C8* text1 = FrameArena::Format("%u", value1);
+	const C8* text2 = FrameArena::Format("%u", value2);
 
 	F32 startPosY = ImGui::GetCursorPosY() + (rowHeight - blockHeight) * 0.5f;
 
 	ImGui::SetCursorPosY(startPosY);
-	ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (ImGui::GetColumnWidth() - ImGui::CalcTextSize(text1.c_str()).x) * 0.5f);
-	ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), text1.c_str());
+	ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (ImGui::GetColumnWidth() - ImGui::CalcTextSize(text1).x) * 0.5f);
+	ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), text1);
 
 	if (showDynamics)
 	{
-		ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (ImGui::GetColumnWidth() - ImGui::CalcTextSize(text2.c_str()).x) * 0.5f);
-		ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), text2.c_str());
+		ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (ImGui::GetColumnWidth() - ImGui::CalcTextSize(text2).x) * 0.5f);
+		ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), text2);
 	}
 }
 
 void UI::SetupKick(U32 value1, U32 value2, bool showDynamics)
 {
-	std::string text1 = std::to_string(value1);
-	std::string text2 = std::to_string(value2);
+	const C8* text1 = FrameArena::Format("%u", value1);
+	const C8* text2 = FrameArena::Format("%u", value2);
 
 	F32 width = ImGui::GetContentRegionAvail().x * 0.66f;
 
-	ImGui::SetCursorPosY(ImGui::CalcTextSize(text1.c_str()).y * 0.5f);
-	ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (width - ImGui::CalcTextSize(text1.c_str()).x) * 0.5f);
-	ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), text1.c_str());
+	ImGui::SetCursorPosY(ImGui::CalcTextSize(text1).y * 0.5f);
+	ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (width - ImGui::CalcTextSize(text1).x) * 0.5f);
+	ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), text1);
 
 	if (showDynamics)
 	{
 		ImGui::SameLine();
-		ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (width - ImGui::CalcTextSize(text2.c_str()).x) * 0.5f);
-		ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), text2.c_str());
+		ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (width - ImGui::CalcTextSize(text2).x) * 0.5f);
+		ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), text2);
 	}
 }
\ No newline at end of file
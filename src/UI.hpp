@@ -20,12 +20,25 @@ public:
 	static void Update(Window* window);
 	static void Render(Window* window);
 
+	/// <summary>
+	/// Reselects the saved port, called once MIDI initialization hands over the port list
+	/// </summary>
+	static void RefreshPorts();
+
+	/// <summary>
+	/// Reselects the saved profiles, called after the file watcher swaps in reloaded profile lists
+	/// </summary>
+	static void RefreshProfiles();
+
 	static F32 statsSize;
 
 private:
 	static void SetupColumn(U32 value1, U32 value2, F32 rowHeight, F32 blockHeight, bool showDynamics);
 	static void SetupRow(U32 value1, U32 value2, F32 height, F32 blockHeight, bool showDynamics);
 	static void SetupKick(U32 value1, U32 value2, bool showDynamics);
+	static void LatencyOverlay();
+	static void StressPanel();
+	static void ThreadPanel();
 
 	static Window* settingsWindow;
 	static Window* visualizerWindow;
@@ -37,14 +50,16 @@ private:
 	static Settings* settings;
 	static std::array<Stats, 8>* stats;
 	static std::array<NoteInfo, 8>* noteInfos;
-	static const std::vector<char*>* ports;
-	static const std::vector<char*>* profiles;
-	static const std::vector<char*>* colorProfiles;
-	static const std::vector<char*>* midiProfiles;
-	static const std::vector<char*>* textures;
+	static const StringTable* ports;
+	static const StringTable* profiles;
+	static const StringTable* colorProfiles;
+	static const StringTable* midiProfiles;
+	static const StringTable* textures;
 
 	static const char* directions[];
 	static const char* separationModes[];
+	static const char* laneNames[];
+	static const char* velocityDistributions[];
 	static I32 direction;
 	static I32 separationMode;
 	static I32 tomId;
@@ -54,6 +69,7 @@ private:
 	static I32 profileId;
 	static I32 colorProfileId;
 	static I32 midiProfileId;
+	static F32 stressAllLanes;
 
 	STATIC_CLASS(UI)
 };
\ No newline at end of file
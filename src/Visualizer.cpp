@@ -1,98 +1,168 @@
 #include "Visualizer.hpp"
 
 #include "Renderer.hpp"
+#include "Allocations.hpp"
+#include "CloneHero.hpp"
 #include "UI.hpp"
 #include "Resources.hpp"
+#include "Recorder.hpp"
+#include "Latency.hpp"
+#include "Replay.hpp"
+#include "Stress.hpp"
+#include "Time.hpp"
+#include "Trace.hpp"
+#include "FrameArena.hpp"
+#include "Scheduling.hpp"
+#include "Startup.hpp"
+#include "Parser.hpp"
+#include "SettingsWriter.hpp"
 
 #include "GraphicsInclude.hpp"
 
 #define RTMIDI_DO_NOT_ENSURE_UNIQUE_PORTNAMES
 #define RTMIDI_DO_NOT_ENABLE_WORKAROUND_UWP_WRONG_TIMESTAMPS
-#include "rtmidi\RtMidi.h"
+#include "rtmidi/RtMidi.h"
 
-#include <codecvt>
 #include <filesystem>
-#include <fstream>
 #include <mutex>
 
-#ifdef DV_PLATFORM_WINDOWS
-#include "shlobj_core.h"
-#include <objbase.h>
-#endif
-
 Settings Visualizer::settings{};
-std::wstring Visualizer::cloneHeroFolder;
-std::array<NoteInfo, 8> Visualizer::noteInfos = {
-	NoteInfo{ "Snare", 0 },
-	NoteInfo{ "Kick", 1 },
-	NoteInfo{ "Cymbal 1", 2 },
-	NoteInfo{ "Tom 1", 3 },
-	NoteInfo{ "Cymbal 2", 4 },
-	NoteInfo{ "Tom 2", 5 },
-	NoteInfo{ "Cymbal 3", 6 },
-	NoteInfo{ "Tom 3", 7 }
-};
-std::array<Stats, 8> Visualizer::noteStats;
+std::filesystem::path Visualizer::cloneHeroFolder;
+NoteLayout Visualizer::noteInfos = ConfigFile::DefaultLayout();
 ColorProfile Visualizer::colorProfile{};
+Engine Visualizer::engine{ settings, colorProfile };
 std::vector<Profile> Visualizer::profiles;
-std::vector<char*> Visualizer::profileNames;
-std::vector<char*> Visualizer::colorProfileNames;
-std::vector<char*> Visualizer::midiProfileNames;
-std::vector<char*> Visualizer::midiPorts;
-std::vector<Mapping> Visualizer::mappings;
+StringTable Visualizer::profileNames;
+StringTable Visualizer::colorProfileNames;
+StringTable Visualizer::midiProfileNames;
+StringTable Visualizer::midiPorts;
+StringTable Visualizer::foundPorts;
 Window Visualizer::settingsWindow;
 Window Visualizer::visualizerWindow;
 GLFWmonitor* Visualizer::monitor = nullptr;
 RtMidiIn* Visualizer::midiIn = nullptr;
+RtMidiIn* Visualizer::pendingMidiIn = nullptr;
+DeviceClock Visualizer::midiClock;
+RawMidiReader Visualizer::rawMidi;
+MidiDispatch Visualizer::inputDispatch;
+ThreadPolicy Visualizer::inputPolicy{};
+U32 Visualizer::midiTask = U32_MAX;
+bool Visualizer::startupFailed = false;
 RtMidiOut* Visualizer::midiOut = nullptr;
-F64 Visualizer::lastInput = 0.0;
 bool Visualizer::configureMode = false;
-std::mutex Visualizer::midiMutex;
-
-I32 SafeStoi(const std::string& str, I32 defaultValue = 0)
-{
-	try { return std::stoi(str); }
-	catch (...) { return defaultValue; }
-}
-
-F32 SafeStof(const std::string& str, F32 defaultValue = 0.0f)
-{
-	try { return std::stof(str); }
-	catch (...) { return defaultValue; }
-}
-
-F64 SafeStod(const std::string& str, F64 defaultValue = 0.0)
+LaunchOptions Visualizer::launchOptions{};
+RingBuffer<MidiEvent, Visualizer::InputQueueCapacity> Visualizer::inputQueue;
+std::mutex Visualizer::inputMutex;
+std::thread Visualizer::watcher;
+std::atomic<bool> Visualizer::watching{ false };
+std::atomic<bool> Visualizer::reloadPending{ false };
+std::mutex Visualizer::reloadMutex;
+ReloadTables Visualizer::pendingReload;
+std::string Visualizer::watchedColorProfile;
+std::string Visualizer::watchedMidiProfile;
+
+//Indices of the folders the watcher thread adds
+enum WatchedFolder : U32
 {
-	try { return std::stod(str); }
-	catch (...) { return defaultValue; }
-}
+	CloneHeroFolder,
+	ColorsFolder,
+	MidiProfilesFolder,
+	WorkingFolder
+};
 
-U64 SafeStoull(const std::string& str, int base = 10, U64 defaultValue = 0)
-{
-	try { return std::stoull(str, nullptr, base); }
-	catch (...) { return defaultValue; }
-}
+static constexpr U32 WatchTimeout = 250;	//Milliseconds between checks for shutdown
+static constexpr U32 SettleTime = 100;		//Milliseconds a folder has to stay quiet before its files are read
 
-bool Visualizer::Initialize()
+bool Visualizer::Initialize(const LaunchOptions& options)
 {
 #ifdef DV_DEBUG
 	std::cout << "=== DrumVisualizer Debug Mode ===" << std::endl;
 #endif
-	if (!InitializeGlfw()) { return false; }
-	if (!InitializeWindows()) { return false; }
-	if (!InitializeCH()) { return false; }
-	if (!InitializeMidi()) { return false; }
-	if (!Resources::Initialize()) { return false; }
-	PrepareTextures();
-	if (!Renderer::Initialize()) { return false; }
-	if (!UI::Initialize(&settingsWindow, &visualizerWindow)) { return false; }
+	launchOptions = options;
+
+	//Before any thread exists, so there's a clean affinity to put unpinned threads back on
+	Scheduling::Initialize();
+	Startup::Begin();
+
+	if (!launchOptions.tracePath.empty()) { Trace::Start(launchOptions.tracePath); }
+	if (launchOptions.checkAllocations) { Allocations::StartCheck(); }
+	Trace::SetThreadName("Main");
+
+	if (!RunStartup())
+	{
+		Startup::Shutdown();
+		return false;
+	}
+
 #ifdef DV_DEBUG
 	std::cout << "Initialized Successfully!" << std::endl;
 #endif
 
 	MainLoop();
+	bool allocationFree = Allocations::Report();
 	Shutdown();
 
+	return allocationFree && !startupFailed;
+}
+
+bool Visualizer::RunStartup()
+{
+	TRACE_ZONE("Startup");
+
+	bool replaying = !launchOptions.replayPath.empty();
+
+	//Everything after the config reads settings, so it's loaded before any other task starts
+	bool configLoaded = Startup::Run("Load Config", LoadConfig);
+	if (!configLoaded) { std::cout << "No settings.cfg found, using default settings" << std::endl; }
+	inputPolicy = settings.inputThread;
+	inputDispatch.SetChannels(settings.midiChannels);
+
+	if (!FrameArena::Initialize()) { return false; }
+
+	//None of these touch GL, and the main thread leaves the state they fill alone until it waits on them
+	U32 cloneHeroTask = Startup::Launch("Load CH Profiles", InitializeCH);
+	if (!replaying) { midiTask = Startup::Launch("Initialize Midi", InitializeMidi); }
+
+	if (!Startup::Run("Initialize GLFW", InitializeGlfw)) { return false; }
+	if (!Startup::Run("Create Windows", [configLoaded]() { return InitializeWindows(configLoaded); })) { return false; }
+
+	//Only registers the textures, they decode and stream in over the first frames
+	if (!Startup::Run("Load Resources", Resources::Initialize)) { return false; }
+	if (!Startup::Wait(cloneHeroTask)) { return false; }
+
+	SetScrollDirection(settings.scrollDirection);
+	PrepareTextures();
+
+	if (!Startup::Run("Initialize Renderer", Renderer::Initialize)) { return false; }
+	if (!Startup::Run("Initialize Latency", Latency::Initialize)) { return false; }
+	if (!Startup::Run("Initialize UI", []() { return UI::Initialize(&settingsWindow, &visualizerWindow); })) { return false; }
+
+	//The MIDI port isn't needed to show the first frame, MainLoop picks it up once it's connected
+	if (replaying && !Replay::Load(launchOptions.replayPath, launchOptions.replaySpeed)) { return false; }
+	if (!replaying && settings.recordSessions) { SetRecording(true); }
+
+	if (launchOptions.stressRate > 0.0f)
+	{
+		StressConfig& config = Stress::GetConfig();
+		for (F32& rate : config.laneRates) { rate = launchOptions.stressRate; }
+		config.duration = launchOptions.stressDuration;
+
+		if (!Stress::Start(config)) { return false; }
+	}
+
+	//Replays carry their own settings, they're never saved over the user's and edits on disk would fight them
+	if (!replaying)
+	{
+		SettingsWriter::Start();
+
+		watching = true;
+		watcher = std::thread(WatchFiles);
+	}
+
+	//Applied last so the helper threads started above don't inherit the render thread's pinning or priority
+	Scheduling::Apply("Render", settings.renderThread);
+	if (settings.lockMemory) { Scheduling::LockMemory(&inputQueue, sizeof(inputQueue)); }
+
 	return true;
 }
 
@@ -101,47 +171,45 @@ void Visualizer::Shutdown()
 #ifdef DV_DEBUG
 	std::cout << std::endl << "=== Shutting Down ===" << std::endl;
 #endif
-	WindowConfig config = settingsWindow.Config();
-
-	settings.settingWindowX = config.x;
-	settings.settingWindowY = config.y;
-	settings.settingWindowWidth = config.width;
-	settings.settingWindowHeight = config.height;
+	StoreWindowPlacement();
 
-	config = visualizerWindow.Config();
+	//A MIDI task still running owns pendingMidiIn until it's joined
+	Startup::Shutdown();
+	rawMidi.Close();
+	StopWatching();
 
-	settings.visualizerWindowX = config.x;
-	settings.visualizerWindowY = config.y;
-	settings.visualizerWindowWidth = config.width;
-	settings.visualizerWindowHeight = config.height;
+	Stress::Stop();
+	Recorder::Stop();
+	Replay::Shutdown();
 
 #ifdef DV_DEBUG
 	std::cout << "Saving Configuration..." << std::endl;
 #endif
 	SaveConfig();
+	SettingsWriter::Stop();
 
 #ifdef DV_DEBUG
 	std::cout << "Cleaning Up Resources..." << std::endl;
 #endif
 
-	for (char* str : profileNames) { delete[] str; }
-	for (char* str : colorProfileNames) { delete[] str; }
-	for (char* str : midiProfileNames) { delete[] str; }
-	for (char* str : midiPorts) { delete[] str; }
-
 	UI::Shutdown();
+	Latency::Shutdown();
 	Renderer::Shutdown();
 	Resources::Shutdown();
+	FrameArena::Shutdown();
 
 #ifndef DV_PLATFORM_WINDOWS
 	delete midiOut;
 #endif
 	delete midiIn;
+	delete pendingMidiIn;
 
 	settingsWindow.Destroy();
 	visualizerWindow.Destroy();
 	glfwTerminate();
 
+	Trace::Stop();
+
 #ifdef DV_DEBUG
 	std::cout << "Shutdown Complete" << std::endl;
 #endif
@@ -154,37 +222,114 @@ void Visualizer::MainLoop()
 
 	while (!glfwWindowShouldClose(settingsWindow))
 	{
+		TRACE_ZONE("Frame");
+		Allocations::BeginFrame();
+		FrameArena::BeginFrame();
+		ApplyReload();
+
 		deltaTime = glfwGetTime() - previousTime;
 		previousTime = glfwGetTime();
 
-		Vector2 velocity{ 0.0f, 0.0f };
+		Stress::RecordFrame(static_cast<U64>(Time::FromSeconds(deltaTime)));
 
-		switch (settings.scrollDirection)
+		//A stress run started from the command line exits with its report once it's done
+		if (Stress::Update() && launchOptions.stressRate > 0.0f)
 		{
-		case ScrollDirection::Up: {
-			velocity = Vector2{ 0.0f, 1.0f } *
-				static_cast<F32>(deltaTime * settings.scrollSpeed);
-		} break;
-		case ScrollDirection::Down: {
-			velocity = Vector2{ 0.0f, -1.0f } *
-				static_cast<F32>(deltaTime * settings.scrollSpeed);
-		} break;
-		case ScrollDirection::Left: {
-			velocity = Vector2{ -1.0f, 0.0f } *
-				static_cast<F32>(deltaTime * settings.scrollSpeed);
-		} break;
-		case ScrollDirection::Right: {
-			velocity = Vector2{ 1.0f, 0.0f } *
-				static_cast<F32>(deltaTime * settings.scrollSpeed);
-		} break;
+			Allocations::ExcludeFrame();
+			Stress::ExportReport("stress.csv");
+			glfwSetWindowShouldClose(settingsWindow, true);
 		}
 
-		Renderer::Update(velocity, settingsWindow, visualizerWindow);
+		if (Replay::IsActive())
+		{
+			Replay::Update(deltaTime);
+
+			if (launchOptions.exitAfterReplay && Replay::IsFinished()) { glfwSetWindowShouldClose(settingsWindow, true); }
+		}
+		else
+		{
+			TRACE_ZONE("Process Events");
+
+			//Channel changes reach the input threads here, a compare unless they changed
+			inputDispatch.SetChannels(settings.midiChannels);
+
+			MidiEvent event;
+			while (inputQueue.Pop(event))
+			{
+				if (ProcessEvent(event)) { Latency::AddEvent(event.time, Time::Now()); }
+			}
+
+			//One sample a frame however fast the controllers stream, the input threads feed them under this lock
+			{
+				std::lock_guard<std::mutex> lock(inputMutex);
+				engine.SampleControllers(Time::Now());
+			}
+
+			engine.Simulate(engine.ScrollVelocity(deltaTime));
+		}
 
-		glfwPollEvents();
+		RenderFrame();
+		Startup::FirstFrame();
+
+		if (StoreWindowPlacement()) { SettingsChanged(); }
+
+		bool connected;
+		if (Startup::Poll(midiTask, connected)) { FinishMidi(connected); }
+
+		{
+			TRACE_ZONE("Poll Events");
+			glfwPollEvents();
+		}
+
+		Allocations::EndFrame();
 	}
 }
 
+void Visualizer::RenderFrame()
+{
+	Renderer::Upload(engine);
+
+	visualizerWindow.SetClearColor(settings.backgroundColor);
+
+	{
+		TRACE_ZONE("Settings UI");
+
+		settingsWindow.Update();
+
+		UI::Update(&settingsWindow);
+		UI::Render(&settingsWindow);
+	}
+
+	visualizerWindow.Update();
+
+	{
+		TRACE_ZONE("Visualizer UI");
+		UI::Update(&visualizerWindow);
+	}
+
+	{
+		TRACE_ZONE("Draw Notes");
+		Renderer::Draw();
+	}
+
+	{
+		TRACE_ZONE("Render Overlay");
+		UI::Render(&visualizerWindow);
+	}
+
+	{
+		TRACE_ZONE("Swap Settings");
+		settingsWindow.Render();
+	}
+
+	{
+		TRACE_ZONE("Swap Visualizer");
+		visualizerWindow.Render();
+	}
+
+	Latency::MarkPresent();
+}
+
 bool Visualizer::InitializeGlfw()
 {
 	glfwSetErrorCallback(ErrorCallback);
@@ -209,14 +354,13 @@ bool Visualizer::InitializeGlfw()
 	return true;
 }
 
-bool Visualizer::InitializeWindows()
+bool Visualizer::InitializeWindows(bool configLoaded)
 {
 #ifdef DV_DEBUG
 	std::cout << "Initializing Windows..." << std::endl;
 #endif
-	if (!LoadConfig())
+	if (!configLoaded)
 	{
-		std::cout << "No settings.cfg found, using default settings" << std::endl;
 		monitor = glfwGetPrimaryMonitor();
 
 		I32 x = 0;
@@ -257,17 +401,19 @@ bool Visualizer::InitializeWindows()
 	visualizerWindow.Create(config, &settingsWindow);
 	glfwSetKeyCallback(visualizerWindow, KeyCallback);
 
-	SetScrollDirection(settings.scrollDirection);
-
 	return true;
 }
 
 bool Visualizer::InitializeCH()
 {
-	cloneHeroFolder = GetCloneHeroFolder();
-	LoadProfiles();
-	LoadColorProfiles();
-	LoadMidiProfiles();
+	cloneHeroFolder = CloneHero::GetFolder();
+	CloneHero::LoadProfiles(cloneHeroFolder, profiles, profileNames);
+	CloneHero::LoadColorProfiles(cloneHeroFolder, colorProfileNames);
+	CloneHero::LoadMidiProfiles(cloneHeroFolder, midiProfileNames);
+
+	//The saved id can point past the end if players were removed in Clone Hero since
+	if (profiles.front().id == U32_MAX) { settings.profileId = U32_MAX; }
+	else if (settings.profileId >= profiles.size()) { settings.profileId = 0; }
 
 	if (settings.profileId != U32_MAX)
 	{
@@ -289,40 +435,53 @@ bool Visualizer::InitializeMidi()
 #ifdef DV_DEBUG
 	std::cout << "Initializing MIDI..." << std::endl;
 #endif
-	midiIn = new RtMidiIn();
+	//Raw devices skip RtMidi entirely, the port list just shows the device
+	if (!launchOptions.rawMidiDevice.empty())
+	{
+		foundPorts.Add(launchOptions.rawMidiDevice);
+
+		if (!rawMidi.Open(launchOptions.rawMidiDevice, RawMidiCallback, nullptr, inputPolicy))
+		{
+			std::cout << "Failed To Open Raw MIDI Device '" << launchOptions.rawMidiDevice << "', Shutting Down!" << std::endl;
+			return false;
+		}
+
+		if (!rawMidi.HasKernelTimestamps()) { std::cout << "Raw MIDI device has no kernel timestamps, stamping on wakeup" << std::endl; }
+
+		return true;
+	}
+
+	//The UI runs while this task does, so the input only becomes midiIn once FinishMidi hands it over
+	RtMidiIn* input = new RtMidiIn();
+	pendingMidiIn = input;
 
 	bool connected = false;
 	std::string foundPortName;
-	U32 portCount = midiIn->getPortCount();
+	U32 portCount = input->getPortCount();
 #ifdef DV_DEBUG
 	std::cout << "Found " << portCount << " MIDI port(s)" << std::endl;
 #endif
 	for (U32 i = 0; i < portCount; ++i)
 	{
-		std::string midiName = midiIn->getPortName(i);
-		if (midiName.size() >= 2)
-		{
-			midiName = midiName.substr(0, midiName.size() - 2);
-		}
+		std::string midiName = PortName(input->getPortName(i));
 
 #ifdef DV_DEBUG
 		std::cout << "  Port " << i << ": " << midiName << std::endl;
 #endif
-		char* str = new char[midiName.length() + 1];
-		memcpy(str, midiName.c_str(), midiName.length() + 1);
-		midiPorts.push_back(str);
+		//Ids line up with RtMidi's port numbers, so same-named ports each get their own
+		foundPorts.Add(midiName);
 
 		if (midiName == settings.portName)
 		{
-			if (LoadPort(midiName)) { connected = true; }
+			if (OpenPort(input, midiName)) { connected = true; }
 		}
 	}
 
 	if (!connected)
 	{
-		for (const std::string& port : midiPorts)
+		for (const C8* port : foundPorts)
 		{
-			if (LoadPort(port)) { connected = true; break; }
+			if (OpenPort(input, port)) { connected = true; break; }
 		}
 
 		if (!connected)
@@ -332,34 +491,81 @@ bool Visualizer::InitializeMidi()
 		}
 	}
 
-	midiIn->setCallback(MidiCallback, nullptr);
-	midiIn->ignoreTypes(false, false, false);
-
 #ifndef DV_PLATFORM_WINDOWS
+	//Opened before the callback is set, the callback echoes to it
 	midiOut = new RtMidiOut();
 	midiOut->openVirtualPort(foundPortName);
 #endif
 
+#ifdef DV_PLATFORM_LINUX
+	//The ALSA sequencer stamps every event as it comes in, so events keep the device's spacing however late we wake
+	input->setCallback(MidiCallback, &midiClock);
+#else
+	input->setCallback(MidiCallback, nullptr);
+#endif
+	//SysEx and active sensing never reach the callback, timing can't be split from the clock so the table drops the rest
+	input->ignoreTypes(true, false, true);
+
 	return true;
 }
 
+void Visualizer::FinishMidi(bool connected)
+{
+	Allocations::ExcludeFrame();
+
+	//Handed over only now, the UI reads the port list every frame and changes ports through midiIn
+	midiPorts = std::move(foundPorts);
+	midiIn = pendingMidiIn;
+	pendingMidiIn = nullptr;
+	UI::RefreshPorts();
+
+	if (!connected)
+	{
+		startupFailed = true;
+		glfwSetWindowShouldClose(settingsWindow, true);
+	}
+}
+
+std::string Visualizer::PortName(const std::string& backendName)
+{
+#ifdef DV_PLATFORM_WINDOWS
+	//WinMM ports end in their number
+	return backendName.size() >= 2 ? backendName.substr(0, backendName.size() - 2) : backendName;
+#else
+	//ALSA ports end in their client:port address, which changes with the order devices are plugged in
+	U64 space = backendName.rfind(' ');
+	if (space != std::string::npos && backendName.find(':', space) != std::string::npos) { return backendName.substr(0, space); }
+
+	return backendName;
+#endif
+}
+
 bool Visualizer::LoadPort(const std::string& portName)
 {
-	if (midiIn->isPortOpen()) { midiIn->closePort(); }
+	//Until the MIDI task finishes there's no port to change, the task connects to the saved one itself
+	return OpenPort(midiIn, portName);
+}
+
+bool Visualizer::OpenPort(RtMidiIn* input, const std::string& portName)
+{
+	if (!input) { return false; }
+	if (input->isPortOpen()) { input->closePort(); }
 
-	for (U32 i = 0; i < midiPorts.size(); ++i)
+	U32 portCount = input->getPortCount();
+	for (U32 i = 0; i < portCount; ++i)
 	{
-		std::string midiName = midiIn->getPortName(i);
-		if (midiName.size() >= 2)
-		{
-			midiName = midiName.substr(0, midiName.size() - 2);
-		}
+		std::string midiName = PortName(input->getPortName(i));
 
 		if (midiName == portName)
 		{
 			try
 			{
-				midiIn->openPort(i, midiName);
+				{
+					std::lock_guard<std::mutex> lock(inputMutex);
+					midiClock.Reset();
+				}
+
+				input->openPort(i, midiName);
 #ifdef DV_DEBUG
 				std::cout << "Connected to MIDI port: " << portName << std::endl;
 #endif
@@ -382,210 +588,48 @@ bool Visualizer::LoadConfig()
 #ifdef DV_DEBUG
 	std::cout << "Loading Configuration..." << std::endl;
 #endif
-	std::string data = Resources::ReadFile("settings.cfg");
-
-	if (data.empty()) { return false; }
-
-	std::string name;
-	std::string value;
+	return ConfigFile::Load(ConfigFile::Read(SettingsWriter::Path), settings, noteInfos);
+}
 
-	U64 i = 0;
-	U64 end = 0;
+void Visualizer::SaveConfig()
+{
+	ConfigFile::Clamp(settings);
 
-	while ((end = data.find('=', i)) != std::string::npos)
-	{
-		name = data.substr(i, end - i);
-		i = end + 1;
-		end = data.find('\n', i);
-		value = data.substr(i, end - i);
-		i = end + 1;
+	//A replay applies the recorded session's settings over the live ones, saving them would replace the user's own
+	if (!launchOptions.replayPath.empty()) { return; }
 
-		switch (Hash(name.data(), name.size()))
-		{
-		case "settingWindowX"_Hash: {
-			settings.settingWindowX = SafeStoi(value, settings.settingWindowX);
-		} break;
-		case "settingWindowY"_Hash: {
-			settings.settingWindowY = SafeStoi(value, settings.settingWindowY);
-		} break;
-		case "settingWindowWidth"_Hash: {
-			settings.settingWindowWidth =
-				SafeStoi(value, settings.settingWindowWidth);
-		} break;
-		case "settingWindowHeight"_Hash: {
-			settings.settingWindowHeight =
-				SafeStoi(value, settings.settingWindowHeight);
-		} break;
-		case "visualizerWindowX"_Hash: {
-			settings.visualizerWindowX = SafeStoi(value, settings.visualizerWindowX);
-		} break;
-		case "visualizerWindowY"_Hash: {
-			settings.visualizerWindowY = SafeStoi(value, settings.visualizerWindowY);
-		} break;
-		case "visualizerWindowWidth"_Hash: {
-			settings.visualizerWindowWidth =
-				SafeStoi(value, settings.visualizerWindowWidth);
-		} break;
-		case "visualizerWindowHeight"_Hash: {
-			settings.visualizerWindowHeight =
-				SafeStoi(value, settings.visualizerWindowHeight);
-		} break;
-		case "profileId"_Hash: {
-			settings.profileId = SafeStoi(value, settings.profileId);
-		} break;
-		case "dynamicThreshold"_Hash: {
-			settings.dynamicThreshold = SafeStoi(value, settings.dynamicThreshold);
-		} break;
-		case "leftyFlip"_Hash: {
-			settings.leftyFlip = SafeStoi(value, settings.leftyFlip);
-		} break;
-		case "showDynamics"_Hash: {
-			settings.showDynamics = SafeStoi(value, settings.showDynamics);
-		} break;
-		case "showStats"_Hash: {
-			settings.showStats = SafeStoi(value, settings.showStats);
-		} break;
-		case "longKicks"_Hash: {
-			settings.longKicks = SafeStoi(value, settings.longKicks);
-		} break;
-		case "scrollSpeed"_Hash: {
-			settings.scrollSpeed = SafeStof(value, settings.scrollSpeed);
-		} break;
-		case "scrollDirection"_Hash: {
-			settings.scrollDirection =
-				(ScrollDirection)SafeStoi(value, (I32)settings.scrollDirection);
-		} break;
-		case "noteWidth"_Hash: {
-			settings.noteWidth = SafeStof(value, settings.noteWidth);
-		} break;
-		case "noteHeight"_Hash: {
-			settings.noteHeight = SafeStof(value, settings.noteHeight);
-		} break;
-		case "noteGap"_Hash: {
-			settings.noteGap = SafeStof(value, settings.noteGap);
-		} break;
-		case "noteSeparationMode"_Hash: {
-			settings.noteSeparationMode =
-				(NoteSeparationMode)SafeStoi(value, (I32)settings.noteSeparationMode);
-		} break;
-		case "tomTextureName"_Hash: {
-			settings.tomTextureName = value;
-		} break;
-		case "cymbalTextureName"_Hash: {
-			settings.cymbalTextureName = value;
-		} break;
-		case "kickTextureName"_Hash: {
-			settings.kickTextureName = value;
-		} break;
-		case "backgroundColor"_Hash: {
-			U64 vStart = 0;
-			U64 vEnd = value.find(',', vStart);
-			settings.backgroundColor.x = SafeStof(value.substr(vStart, vEnd - vStart), settings.backgroundColor.x);
-			vStart = vEnd + 1;
-			vEnd = value.find(',', vStart);
-			settings.backgroundColor.y = SafeStof(value.substr(vStart, vEnd - vStart), settings.backgroundColor.y);
-			vStart = vEnd + 1;
-			vEnd = value.find(',', vStart);
-			settings.backgroundColor.z = SafeStof(value.substr(vStart, vEnd - vStart), settings.backgroundColor.z);
-			vStart = vEnd + 1;
-			settings.backgroundColor.w = SafeStof(value.substr(vStart), settings.backgroundColor.w);
-		} break;
-		case "portName"_Hash: {
-			settings.portName = value;
-		} break;
-		case "colorProfileName"_Hash: {
-			settings.colorProfileName = value;
-		} break;
-		case "midiProfileName"_Hash: {
-			settings.midiProfileName = value;
-		} break;
-		case "noteLayout"_Hash: {
-			U32 i = 0;
-			for (C8 c : value)
-			{
-				U32 index = c - '0';
-
-				switch (index)
-				{
-				case 0: { noteInfos[i] = { "Snare", index }; } break;
-				case 1: { noteInfos[i] = { "Kick", index }; } break;
-				case 2: { noteInfos[i] = { "Cymbal 1", index }; } break;
-				case 3: { noteInfos[i] = { "Tom 1", index }; } break;
-				case 4: { noteInfos[i] = { "Cymbal 2", index }; } break;
-				case 5: { noteInfos[i] = { "Tom 2", index }; } break;
-				case 6: { noteInfos[i] = { "Cymbal 3", index }; } break;
-				case 7: { noteInfos[i] = { "Tom 3", index }; } break;
-				}
+	SettingsWriter::Queue(SerializeConfig());
+}
 
-				++i;
-			}
-		} break;
-		default: break;
-		}
+bool Visualizer::StoreWindowPlacement()
+{
+	const WindowConfig& settingsConfig = settingsWindow.Config();
+	const WindowConfig& visualizerConfig = visualizerWindow.Config();
 
-		if (i == 0) { break; }
+	if (settings.settingWindowX == settingsConfig.x && settings.settingWindowY == settingsConfig.y &&
+		settings.settingWindowWidth == settingsConfig.width && settings.settingWindowHeight == settingsConfig.height &&
+		settings.visualizerWindowX == visualizerConfig.x && settings.visualizerWindowY == visualizerConfig.y &&
+		settings.visualizerWindowWidth == visualizerConfig.width && settings.visualizerWindowHeight == visualizerConfig.height)
+	{
+		return false;
 	}
 
-	settings.settingWindowX = max(settings.settingWindowX, 0);
-	settings.settingWindowY = max(settings.settingWindowY, 0);
-	settings.settingWindowWidth = max(settings.settingWindowWidth, 100);
-	settings.settingWindowHeight = max(settings.settingWindowHeight, 100);
-	settings.visualizerWindowX = max(settings.visualizerWindowX, 0);
-	settings.visualizerWindowY = max(settings.visualizerWindowY, 0);
-	settings.visualizerWindowWidth = max(settings.visualizerWindowWidth, 100);
-	settings.visualizerWindowHeight = max(settings.visualizerWindowHeight, 100);
+	settings.settingWindowX = settingsConfig.x;
+	settings.settingWindowY = settingsConfig.y;
+	settings.settingWindowWidth = settingsConfig.width;
+	settings.settingWindowHeight = settingsConfig.height;
+
+	settings.visualizerWindowX = visualizerConfig.x;
+	settings.visualizerWindowY = visualizerConfig.y;
+	settings.visualizerWindowWidth = visualizerConfig.width;
+	settings.visualizerWindowHeight = visualizerConfig.height;
 
 	return true;
 }
 
-void Visualizer::SaveConfig()
+std::string Visualizer::SerializeConfig()
 {
-	settings.settingWindowX = max(settings.settingWindowX, 0);
-	settings.settingWindowY = max(settings.settingWindowY, 0);
-	settings.settingWindowWidth = max(settings.settingWindowWidth, 100);
-	settings.settingWindowHeight = max(settings.settingWindowHeight, 100);
-	settings.visualizerWindowX = max(settings.visualizerWindowX, 0);
-	settings.visualizerWindowY = max(settings.visualizerWindowY, 0);
-	settings.visualizerWindowWidth = max(settings.visualizerWindowWidth, 100);
-	settings.visualizerWindowHeight = max(settings.visualizerWindowHeight, 100);
-
-	std::ofstream output("settings.cfg");
-	output << "settingWindowX=" << settings.settingWindowX << '\n';
-	output << "settingWindowY=" << settings.settingWindowY << '\n';
-	output << "settingWindowWidth=" << settings.settingWindowWidth << '\n';
-	output << "settingWindowHeight=" << settings.settingWindowHeight << '\n';
-	output << "visualizerWindowX=" << settings.visualizerWindowX << '\n';
-	output << "visualizerWindowY=" << settings.visualizerWindowY << '\n';
-	output << "visualizerWindowWidth=" << settings.visualizerWindowWidth << '\n';
-	output << "visualizerWindowHeight=" << settings.visualizerWindowHeight << '\n';
-	output << "profileId=" << settings.profileId << '\n';
-	output << "dynamicThreshold=" << settings.dynamicThreshold << '\n';
-	output << "leftyFlip=" << settings.leftyFlip << '\n';
-	output << "showDynamics=" << settings.showDynamics << '\n';
-	output << "showStats=" << settings.showStats << '\n';
-	output << "longKicks=" << settings.longKicks << '\n';
-	output << "scrollSpeed=" << settings.scrollSpeed << '\n';
-	output << "scrollDirection=" << static_cast<U32>(settings.scrollDirection) << '\n';
-	output << "noteWidth=" << settings.noteWidth << '\n';
-	output << "noteHeight=" << settings.noteHeight << '\n';
-	output << "noteGap=" << settings.noteGap << '\n';
-	output << "noteSeparationMode=" << static_cast<U32>(settings.noteSeparationMode) << '\n';
-	output << "tomTextureName=" << settings.tomTextureName << '\n';
-	output << "cymbalTextureName=" << settings.cymbalTextureName << '\n';
-	output << "kickTextureName=" << settings.kickTextureName << '\n';
-	output << "backgroundColor=" << settings.backgroundColor.x << ',' <<
-		settings.backgroundColor.y << ',' << settings.backgroundColor.z <<
-		',' << settings.backgroundColor.w << '\n';
-	output << "portName=" << settings.portName << '\n';
-	output << "colorProfileName=" << settings.colorProfileName << '\n';
-	output << "midiProfileName=" << settings.midiProfileName << '\n';
-	
-	output << "noteLayout=";
-	for (NoteInfo& info : noteInfos) { output << info.index; }
-	output << '\n';
-
-	output.flush();
-	output.close();
+	return ConfigFile::Serialize(settings, noteInfos);
 }
 
 void Visualizer::PrepareTextures()
@@ -593,302 +637,321 @@ void Visualizer::PrepareTextures()
 	settings.tomTexture = Resources::GetTexture(settings.tomTextureName);
 	settings.cymbalTexture = Resources::GetTexture(settings.cymbalTextureName);
 	settings.kickTexture = Resources::GetTexture(settings.kickTextureName);
+
+	engine.SetDefaultTexture(Resources::GetTexture("square"));
 }
 
-std::wstring Visualizer::GetCloneHeroFolder()
+void Visualizer::SetRecording(bool record)
 {
-#ifdef DV_PLATFORM_WINDOWS
-	PWSTR path = nullptr;
-	SHGetKnownFolderPath(FOLDERID_Documents, 0, nullptr, &path);
-
-	std::wstring documents(path);
-	CoTaskMemFree(path);
+	settings.recordSessions = record;
 
-	documents.append(L"\\Clone Hero\\");
+	if (!record) { Recorder::Stop(); }
+	else if (Recorder::Start(settings.sessionFolder)) { Recorder::RecordConfig(SerializeConfig()); }
+	else { settings.recordSessions = false; }
+}
 
-#ifdef DV_DEBUG
-	std::wcout << "Found Clone Hero path: '" << documents << "'" << std::endl;
-#endif
+void Visualizer::SettingsChanged()
+{
+	Allocations::ExcludeFrame();
 
-	return documents;
-#elif DV_PLATFORM_LINUX
-	return "~/.clonehero";
-#elif DV_PLATFORM_MAC
-	return "~/Clone Hero";
-#endif
+	SaveConfig();
+	if (Recorder::IsRecording()) { Recorder::RecordConfig(SerializeConfig()); }
 }
 
-void Visualizer::LoadProfiles()
+void Visualizer::ApplyRecordedSetting(const std::string& name, const std::string& value)
 {
-#ifdef DV_DEBUG
-	std::cout << "Loading Profiles..." << std::endl;
-#endif
-	std::string data = Resources::ReadFile(cloneHeroFolder + L"profiles.ini");
+	Allocations::ExcludeFrame();
+
+	U64 hash = Hash(name.data(), name.size());
 
-	if (data.empty())
+	switch (hash)
 	{
-		std::cout << "Failed to open profiles.ini, using default profile" << std::endl;
-		profiles.push_back({ U32_MAX, "Guest", "DefaultColors", 100, false });
-		return;
+	//Window placement and I/O belong to the machine doing the replay
+	case "settingWindowX"_Hash:
+	case "settingWindowY"_Hash:
+	case "settingWindowWidth"_Hash:
+	case "settingWindowHeight"_Hash:
+	case "visualizerWindowX"_Hash:
+	case "visualizerWindowY"_Hash:
+	case "visualizerWindowWidth"_Hash:
+	case "visualizerWindowHeight"_Hash:
+	case "recordSessions"_Hash:
+	case "sessionFolder"_Hash:
+	case "portName"_Hash: return;
+	default: break;
 	}
 
-	U64 i = 0;
-	U64 end = 0;
-	U64 start = 0;
+	ConfigFile::Apply(name, value, settings, noteInfos);
 
-	U32 id = 0;
-	while ((start = data.find('[', i)) != std::string::npos)
+	switch (hash)
 	{
-		Profile profile{};
-
-		i = data.find("dynamics_threshold", start);
-		i = data.find('=', i) + 2;
-		end = data.find('\n', i);
+	case "profileId"_Hash: { SetProfile(settings.profileId); } break;
+	case "colorProfileName"_Hash: { SetColorProfile(settings.colorProfileName); } break;
+	case "midiProfileName"_Hash: { SetMidiProfile(settings.midiProfileName); } break;
+	case "tomTextureName"_Hash:
+	case "cymbalTextureName"_Hash:
+	case "kickTextureName"_Hash: { PrepareTextures(); } break;
+	case "showStats"_Hash:
+	case "longKicks"_Hash:
+	case "scrollDirection"_Hash:
+	case "noteLayout"_Hash: { SetScrollDirection(settings.scrollDirection); } break;
+	default: break;
+	}
+}
 
-		profile.dynamicThreshold = SafeStoi(data.substr(i, end - i), 100);
+void Visualizer::WatchFiles()
+{
+	Trace::SetThreadName("Watcher");
 
-		i = data.find("color_profile_name", start);
-		i = data.find('=', i) + 2;
-		end = data.find('\n', i);
+	const std::filesystem::path& folder = cloneHeroFolder;
 
-		profile.colorProfile = data.substr(i, end - i);
+	FileWatcher fileWatcher;
+	if (!fileWatcher.Add(folder)) { std::cout << "Can't watch the Clone Hero folder, profile edits need a restart" << std::endl; }
+	fileWatcher.Add(folder / "Custom" / "Colors");
+	fileWatcher.Add(folder / "MIDI Profiles");
+	fileWatcher.Add(std::filesystem::current_path());
 
-		i = data.find("player_name", start);
-		i = data.find('=', i) + 2;
-		end = data.find('\n', i);
+	//Settings are applied by difference to the version of the file already seen
+	std::string config = ConfigFile::Read(SettingsWriter::Path);
+	std::vector<FileChange> changes;
 
-		profile.name = data.substr(i, end - i);
+	while (watching)
+	{
+		if (!fileWatcher.Wait(changes, WatchTimeout)) { continue; }
 
-		i = data.find("lefty_flip", start);
-		i = data.find('=', i) + 2;
-		end = data.find('\n', i);
+		//Editors save in several steps, the files are read once their folders go quiet
+		while (watching && fileWatcher.Wait(changes, SettleTime)) {}
 
-		profile.leftyFlip = data.substr(i, end - i) == "1";
-		profile.id = id;
+		if (watching) { ReloadFiles(changes, config); }
+		changes.clear();
+	}
+}
 
-		profiles.push_back(profile);
+void Visualizer::ReloadFiles(const std::vector<FileChange>& changes, std::string& config)
+{
+	ReloadTables reload{};
 
-		char* name = new char[profile.name.size() + 1];
-		memcpy(name, profile.name.c_str(), profile.name.size() + 1);
-		profileNames.push_back(name);
-	}
+	std::string colorProfileName;
+	std::string midiProfileName;
 
-	if (settings.profileId == U32_MAX)
 	{
-		settings.profileId = 0;
+		std::lock_guard<std::mutex> lock(reloadMutex);
+		colorProfileName = watchedColorProfile;
+		midiProfileName = watchedMidiProfile;
 	}
-}
 
-void Visualizer::LoadColorProfiles()
-{
-	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(cloneHeroFolder + L"Custom\\Colors\\"))
-	{
-		std::string path = entry.path().string();
+	std::string colorName = colorProfileName + ".ini";
+	std::string midiName = midiProfileName + ".yaml";
 
-		std::string ext = path.substr(path.find_last_of('.') + 1);
-		U64 start = path.find_last_of('\\') + 1;
-		std::string file = path.substr(start, path.find_last_of('.') - start);
+	for (const FileChange& change : changes)
+	{
+		//An empty name means changes were lost, so everything in that folder is reread
+		std::string_view name = change.name;
+		bool all = name.empty();
 
-		if (ext == "ini")
+		switch (change.folder)
 		{
-			char* name = new char[file.size() + 1];
-			memcpy(name, file.c_str(), file.size() + 1);
-			colorProfileNames.push_back(name);
+		case CloneHeroFolder: {
+			if (all || name == "profiles.ini") { reload.flags |= ReloadProfiles; }
+		} break;
+		case ColorsFolder: {
+			if (all || (name.size() > 4 && name.substr(name.size() - 4) == ".ini")) { reload.flags |= ReloadColorList; }
+			if (all || name == colorName) { reload.flags |= ReloadColors; }
+		} break;
+		case MidiProfilesFolder: {
+			if (all || (name.size() > 5 && name.substr(name.size() - 5) == ".yaml")) { reload.flags |= ReloadMidiList; }
+			if (all || name == midiName) { reload.flags |= ReloadMappings; }
+		} break;
+		case WorkingFolder: {
+			if (all || name == SettingsWriter::Path) { reload.flags |= ReloadSettings; }
+		} break;
 		}
 	}
-}
 
-void Visualizer::LoadMidiProfiles()
-{
-	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(cloneHeroFolder + L"MIDI Profiles\\"))
+	if (reload.flags & ReloadProfiles) { CloneHero::LoadProfiles(cloneHeroFolder, reload.profiles, reload.profileNames); }
+	if (reload.flags & ReloadColorList) { CloneHero::LoadColorProfiles(cloneHeroFolder, reload.colorProfileNames); }
+	if (reload.flags & ReloadMidiList) { CloneHero::LoadMidiProfiles(cloneHeroFolder, reload.midiProfileNames); }
+
+	//A profile that was deleted or is mid-save keeps what's loaded
+	if ((reload.flags & ReloadColors) && !CloneHero::LoadColors(CloneHero::ColorProfilePath(cloneHeroFolder, colorProfileName), reload.colors))
 	{
-		std::string path = entry.path().string();
+		reload.flags &= ~ReloadColors;
+	}
 
-		std::string ext = path.substr(path.find_last_of('.') + 1);
-		U64 start = path.find_last_of('\\') + 1;
-		std::string file = path.substr(start, path.find_last_of('.') - start);
+	if ((reload.flags & ReloadMappings) && !CloneHero::LoadMidiProfile(CloneHero::MidiProfilePath(cloneHeroFolder, midiProfileName), reload.mappings))
+	{
+		reload.flags &= ~ReloadMappings;
+	}
 
-		if (ext == "yaml")
+	if (reload.flags & ReloadSettings)
+	{
+		std::string data = ConfigFile::Read(SettingsWriter::Path);
+
+		//Our own writes only move the baseline, the values in them are already in use
+		if (!SettingsWriter::Wrote(data))
 		{
-			char* name = new char[file.size() + 1];
-			memcpy(name, file.c_str(), file.size() + 1);
-			midiProfileNames.push_back(name);
-		}
-	}
-}
+			std::vector<std::pair<std::string_view, std::string_view>> previous;
+			IniReader reader(config);
+			IniLine line;
 
-void Visualizer::SetProfile(I32 profileId)
-{
-	settings.dynamicThreshold = profiles[profileId].dynamicThreshold;
-	settings.leftyFlip = profiles[profileId].leftyFlip;
-}
+			while (reader.Next(line))
+			{
+				if (line.type == IniLineType::Value) { previous.emplace_back(line.name, line.value); }
+			}
 
-void Visualizer::SetColorProfile(const std::string& name)
-{
-	std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-	LoadColors(cloneHeroFolder + L"Custom\\Colors\\" + converter.from_bytes(name) + L".ini");
-}
+			reader = IniReader(data);
 
-void Visualizer::SetMidiProfile(const std::string& name)
-{
-	std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-	if (!LoadMidiProfile(cloneHeroFolder + L"MIDI Profiles\\" + converter.from_bytes(name) + L".yaml"))
-	{
-		for (char* profile : midiProfileNames)
-		{
-			if (LoadMidiProfile(cloneHeroFolder + L"MIDI Profiles\\" + converter.from_bytes(profile) + L".yaml"))
+			while (reader.Next(line))
 			{
-				settings.midiProfileName = profile;
-				break;
+				if (line.type != IniLineType::Value) { continue; }
+
+				bool same = false;
+				for (const std::pair<std::string_view, std::string_view>& setting : previous)
+				{
+					if (setting.first == line.name) { same = setting.second == line.value; break; }
+				}
+
+				if (!same) { reload.settings.emplace_back(line.name, line.value); }
 			}
 		}
+
+		config = std::move(data);
+
+		if (reload.settings.empty()) { reload.flags &= ~ReloadSettings; }
 	}
-}
 
-void Visualizer::LoadColors(const std::wstring& path)
-{
-#ifdef DV_DEBUG
-	std::cout << "Loading Profile Colors..." << std::endl;
-#endif
-	std::string data = Resources::ReadFile(path);
+	if (!reload.flags) { return; }
+
+	std::lock_guard<std::mutex> lock(reloadMutex);
 
-	if (data.empty())
+	//The main thread may not have picked up the last reload yet, only the tables reread this time replace it
+	if (reload.flags & ReloadProfiles)
 	{
-		std::cout << "Failed to open profile colors, using default colors" << std::endl;
-		return;
+		pendingReload.profiles = std::move(reload.profiles);
+		pendingReload.profileNames = std::move(reload.profileNames);
 	}
 
-	U64 i = 0;
-	U64 end = 0;
-	U64 start = data.find("[drums]");
+	if (reload.flags & ReloadColorList) { pendingReload.colorProfileNames = std::move(reload.colorProfileNames); }
+	if (reload.flags & ReloadMidiList) { pendingReload.midiProfileNames = std::move(reload.midiProfileNames); }
+	if (reload.flags & ReloadColors) { pendingReload.colors = reload.colors; }
+	if (reload.flags & ReloadMappings) { pendingReload.mappings = std::move(reload.mappings); }
+
+	for (std::pair<std::string, std::string>& setting : reload.settings) { pendingReload.settings.push_back(std::move(setting)); }
 
-	i = data.find("note_kick ", start);
-	i = data.find('#', i) + 1;
-	end = data.find('\n', i);
+	pendingReload.flags |= reload.flags;
+	reloadPending.store(true, std::memory_order_release);
+}
 
-	std::string hex = data.substr(i, end - i);
-	colorProfile.kickColor = HexToRBG(hex);
+void Visualizer::StopWatching()
+{
+	watching = false;
+	if (watcher.joinable()) { watcher.join(); }
+}
 
-	i = data.find("cym_blue ", start);
-	i = data.find('#', i) + 1;
-	end = data.find('\n', i);
+void Visualizer::ApplyReload()
+{
+	if (!reloadPending.load(std::memory_order_acquire)) { return; }
 
-	hex = data.substr(i, end - i);
-	colorProfile.cymbal2Color = HexToRBG(hex);
+	//Never waits on the watcher, a reload it's still publishing is picked up next frame
+	std::unique_lock<std::mutex> lock(reloadMutex, std::try_to_lock);
+	if (!lock.owns_lock()) { return; }
 
-	i = data.find("cym_yellow ", start);
-	i = data.find('#', i) + 1;
-	end = data.find('\n', i);
+	ReloadTables reload = std::move(pendingReload);
+	pendingReload = {};
+	reloadPending = false;
+	lock.unlock();
 
-	hex = data.substr(i, end - i);
-	colorProfile.cymbal1Color = HexToRBG(hex);
+	Allocations::ExcludeFrame();
 
-	i = data.find("cym_green ", start);
-	i = data.find('#', i) + 1;
-	end = data.find('\n', i);
+	if (reload.flags & ReloadProfiles)
+	{
+		profiles = std::move(reload.profiles);
+		profileNames = std::move(reload.profileNames);
 
-	hex = data.substr(i, end - i);
-	colorProfile.cymbal3Color = HexToRBG(hex);
+		if (profiles.front().id == U32_MAX) { settings.profileId = U32_MAX; }
+		else
+		{
+			if (settings.profileId >= profiles.size()) { settings.profileId = 0; }
+			SetProfile(settings.profileId);
+		}
+	}
 
-	i = data.find("tom_blue ", start);
-	i = data.find('#', i) + 1;
-	end = data.find('\n', i);
+	if (reload.flags & ReloadColorList) { colorProfileNames = std::move(reload.colorProfileNames); }
+	if (reload.flags & ReloadMidiList) { midiProfileNames = std::move(reload.midiProfileNames); }
+	if (reload.flags & ReloadColors) { colorProfile = reload.colors; }
+	if (reload.flags & ReloadMappings) { engine.GetMappings() = std::move(reload.mappings); }
 
-	hex = data.substr(i, end - i);
-	colorProfile.tom2Color = HexToRBG(hex);
+	if (reload.flags & ReloadSettings)
+	{
+		//Writes of our own come back with the values already in use, those are left alone
+		std::string current = SerializeConfig();
 
-	i = data.find("tom_yellow ", start);
-	i = data.find('#', i) + 1;
-	end = data.find('\n', i);
+		for (const std::pair<std::string, std::string>& setting : reload.settings)
+		{
+			bool same = false;
 
-	hex = data.substr(i, end - i);
-	colorProfile.tom1Color = HexToRBG(hex);
+			IniReader reader(current);
+			IniLine line;
 
-	i = data.find("tom_red ", start);
-	i = data.find('#', i) + 1;
-	end = data.find('\n', i);
+			while (reader.Next(line))
+			{
+				if (line.name == setting.first) { same = line.value == setting.second; break; }
+			}
 
-	hex = data.substr(i, end - i);
-	colorProfile.snareColor = HexToRBG(hex);
+			if (!same) { ApplyRecordedSetting(setting.first, setting.second); }
+		}
+	}
 
-	i = data.find("tom_green ", start);
-	i = data.find('#', i) + 1;
-	end = data.find('\n', i);
+	UI::RefreshProfiles();
+	if (reload.flags & (ReloadProfiles | ReloadSettings)) { SettingsChanged(); }
 
-	hex = data.substr(i, end - i);
-	colorProfile.tom3Color = HexToRBG(hex);
+#ifdef DV_DEBUG
+	std::cout << "Reloaded changed Clone Hero files" << std::endl;
+#endif
 }
 
-Vector3 Visualizer::HexToRBG(const std::string& hex)
+void Visualizer::SetProfile(I32 profileId)
 {
-	static constexpr U64 RMask = 0xFF0000;
-	static constexpr U64 GMask = 0x00FF00;
-	static constexpr U64 BMask = 0x0000FF;
-
-	U64 rgb = SafeStoull(hex, 16, 0);
+	if (profileId < 0 || profileId >= (I32)profiles.size()) { return; }
 
-	return { ((rgb & RMask) >> 16) / 255.0f, ((rgb & GMask) >> 8) / 255.0f,
-			(rgb & BMask) / 255.0f };
+	settings.dynamicThreshold = profiles[profileId].dynamicThreshold;
+	settings.leftyFlip = profiles[profileId].leftyFlip;
 }
 
-bool Visualizer::LoadMidiProfile(const std::wstring& path)
+void Visualizer::SetColorProfile(const std::string& name)
 {
-	std::string data = Resources::ReadFile(path);
-
-	if (data.empty())
 	{
-		std::wcout << "Failed to open MIDI profile " << path << std::endl;
-		return false;
+		std::lock_guard<std::mutex> lock(reloadMutex);
+		watchedColorProfile = name;
 	}
 
-	U64 snare = data.find("Red Pad:");
-	U64 tom1 = data.find("Yellow Pad:", snare);
-	U64 tom2 = data.find("Blue Pad:", tom1);
-	U64 tom3 = data.find("Green Pad:", tom2);
-	U64 kick = data.find("Kick Pad:", tom3);
-	U64 cymbal1 = data.find("Yellow Cymbal:", kick);
-	U64 cymbal2 = data.find("Blue Cymbal:", cymbal1);
-	U64 cymbal3 = data.find("Green Cymbal:", cymbal2);
-	U64 start = data.find("Start:", cymbal3);
-
-	ParseMappings(data, NoteType::Snare, snare, tom1);
-	ParseMappings(data, NoteType::Tom1, tom1, tom2);
-	ParseMappings(data, NoteType::Tom2, tom2, tom3);
-	ParseMappings(data, NoteType::Tom3, tom3, kick);
-	ParseMappings(data, NoteType::Kick, kick, cymbal1);
-	ParseMappings(data, NoteType::Cymbal1, cymbal1, cymbal2);
-	ParseMappings(data, NoteType::Cymbal2, cymbal2, cymbal3);
-	ParseMappings(data, NoteType::Cymbal3, cymbal3, start);
-
-	std::wcout << "Succesfully opened MIDI profile " << path << std::endl;
-
-	return true;
+	ColorProfile colors{};
+	if (CloneHero::LoadColors(CloneHero::ColorProfilePath(cloneHeroFolder, name), colors)) { colorProfile = colors; }
 }
 
-void Visualizer::ParseMappings(const std::string& data, NoteType type, U64 start, U64 end)
+void Visualizer::SetMidiProfile(const std::string& name)
 {
-	U64 i = start;
-	U64 lineEnd = 0;
+	//Loaded aside and swapped in, so the previous profile's mappings don't linger behind the new ones
+	std::vector<Mapping> loaded;
+	bool found = CloneHero::LoadMidiProfile(CloneHero::MidiProfilePath(cloneHeroFolder, name), loaded);
 
-	while ((i = data.find('-', i)) < end)
+	if (!found)
 	{
-		Mapping mapping{};
-		mapping.type = type;
-
-		i = data.find(':', i) + 2;
-		lineEnd = data.find('\n', i);
-		mapping.midiValue = SafeStoi(data.substr(i, lineEnd - i), 0);
-
-		i = data.find(':', i) + 2;
-		lineEnd = data.find('\n', i);
-		mapping.velocityThreshold = SafeStoi(data.substr(i, lineEnd - i), 0);
+		for (const C8* profile : midiProfileNames)
+		{
+			if (CloneHero::LoadMidiProfile(CloneHero::MidiProfilePath(cloneHeroFolder, profile), loaded))
+			{
+				settings.midiProfileName = profile;
+				found = true;
+				break;
+			}
+		}
+	}
 
-		i = data.find(':', i) + 2;
-		lineEnd = data.find('\n', i);
-		mapping.overhitThreshold = SafeStod(data.substr(i, lineEnd - i), 0.0);
+	if (found) { engine.GetMappings().swap(loaded); }
 
-		mappings.push_back(mapping);
-	}
+	std::lock_guard<std::mutex> lock(reloadMutex);
+	watchedMidiProfile = settings.midiProfileName;
 }
 
 void Visualizer::SetScrollDirection(ScrollDirection direction)
@@ -896,78 +959,13 @@ void Visualizer::SetScrollDirection(ScrollDirection direction)
 	settings.scrollDirection = direction;
 	I32 width, height;
 	glfwGetFramebufferSize(visualizerWindow, &width, &height);
-	F32 spawnPosition = 1.0f - settings.noteHeight;
 
-	F32 layoutPosition = -0.875f;
-	F32 layoutIncrement = 0.25f;
-	F32 x = 0.0f;
-	F32 y = 0.0f;
-	F32 kickX = 0.0f;
-	F32 kickY = 0.0f;
-
-	if (settings.longKicks)
-	{
-		layoutPosition = -0.85714285714f;
-		layoutIncrement = 0.28571428571f;
-	}
-
-	switch (settings.scrollDirection)
-	{
-	case ScrollDirection::Down: {
-		if (settings.showStats) { spawnPosition = (height - UI::statsSize * 2.0f) / height - settings.noteHeight; }
-
-		x = layoutPosition;
-		y = spawnPosition;
-		kickX = 0.0f;
-		kickY = spawnPosition;
-	} break;
-	case ScrollDirection::Right: {
-		if (settings.showStats) { spawnPosition = (width - UI::statsSize * 2.0f) / width - settings.noteHeight; }
-
-		x = -spawnPosition;
-		y = layoutPosition;
-		kickX = -spawnPosition;
-		kickY = 0.0f;
-	} break;
-	case ScrollDirection::Up: {
-		if (settings.showStats) { spawnPosition = (height - UI::statsSize * 2.0f) / height - settings.noteHeight; }
-
-		x = layoutPosition;
-		y = -spawnPosition;
-		kickX = 0.0f;
-		kickY = -spawnPosition;
-	} break;
-	case ScrollDirection::Left: {
-		if (settings.showStats) { spawnPosition = (width - UI::statsSize * 2.0f) / width - settings.noteHeight; }
-
-		x = spawnPosition;
-		y = layoutPosition;
-		kickX = spawnPosition;
-		kickY = 0.0f;
-	} break;
-	default:
-		break;
-	}
-
-	for (NoteInfo& info : noteInfos)
-	{
-		Stats& stats = noteStats[info.index];
-
-		if (settings.longKicks && info.name == "Kick")
-		{
-			stats.scale = 100.0f;
-			stats.spawn = { kickX, kickY, 0.5f };
-		}
-		else
-		{
-			stats.scale = 1.0f;
-			stats.spawn = { x, y, 0.0f };
-			if (settings.scrollDirection == ScrollDirection::Left || settings.scrollDirection == ScrollDirection::Right) { y += layoutIncrement; }
-			if (settings.scrollDirection == ScrollDirection::Up || settings.scrollDirection == ScrollDirection::Down) { x += layoutIncrement; }
-		}
-	}
+	engine.Layout(noteInfos, width, height, UI::statsSize);
+}
 
-	Renderer::ClearNotes();
+Engine& Visualizer::GetEngine()
+{
+	return engine;
 }
 
 Settings& Visualizer::GetSettings()
@@ -977,125 +975,154 @@ Settings& Visualizer::GetSettings()
 
 std::array<Stats, 8>& Visualizer::GetStats()
 {
-	return noteStats;
+	return engine.GetStats();
 }
 
-std::array<NoteInfo, 8>& Visualizer::GetNoteInfos()
+NoteLayout& Visualizer::GetNoteInfos()
 {
 	return noteInfos;
 }
 
-std::vector<char*>& Visualizer::GetPorts()
+const StringTable& Visualizer::GetPorts()
 {
 	return midiPorts;
 }
 
-std::vector<char*>& Visualizer::GetProfiles()
+const StringTable& Visualizer::GetProfiles()
 {
 	return profileNames;
 }
 
-std::vector<char*>& Visualizer::GetColorProfiles()
+const StringTable& Visualizer::GetColorProfiles()
 {
 
 	return colorProfileNames;
 }
 
-std::vector<char*>& Visualizer::GetMidiProfiles()
+const StringTable& Visualizer::GetMidiProfiles()
 {
 	return midiProfileNames;
 }
 
+const std::vector<Mapping>& Visualizer::GetMappings()
+{
+	return engine.GetMappings();
+}
+
 void Visualizer::MidiCallback(F64 deltatime, std::vector<U8>* message, void* userData)
 {
+	U64 arrival = Time::Now();
+
+	static thread_local bool named = false;
+	if (!named && !Stress::IsGenerating())
+	{
+		//RtMidi creates its thread without a hook, so the first callback on it sets it up
+		Trace::SetThreadName("MIDI");
+		Scheduling::Apply("Input", inputPolicy);
+		named = true;
+	}
+
 #ifndef DV_PLATFORM_WINDOWS
-	midiOut->sendMessage(message);
+	//Everything the port delivers is passed on, Clone Hero reads channels the visualizer may not. Only the port's
+	//thread sends, so the output needs no lock, and synthetic traffic stays out of the game.
+	if (midiOut && !Stress::IsGenerating()) { midiOut->sendMessage(message); }
 #endif
 
-	lastInput += deltatime;
-
 	U64 byteCount = message->size();
 
-	//#ifdef DV_DEBUG
-	for (U32 i = 0; i < byteCount; ++i)
+	MidiEvent event{};
+	event.size = static_cast<U8>(byteCount);
+	if (byteCount <= 3) { memcpy(event.bytes, message->data(), byteCount); }
+
+	//The driver's deltas run from the last message it delivered, so a dropped one hands its delta to the next
+	static thread_local F64 skippedTime = 0.0;
+	MidiMessage kind = byteCount == 0 || byteCount > 3 ? MidiMessage::Ignored : inputDispatch.Classify(event);
+	if (kind == MidiMessage::Ignored)
 	{
-		std::cout << "Byte " << i << " = " << (I32)message->at(i) << ", ";
+		skippedTime += deltatime;
+		return;
 	}
-	std::cout << "stamp = " << deltatime << std::endl;
-	//#endif
 
-	if (byteCount >= 3 && (message->at(0) == 153 || message->at(0) == 144))
+	deltatime += skippedTime;
+	skippedTime = 0.0;
+
+	TRACE_ZONE("MIDI Callback");
+
+#ifdef DV_DEBUG
+	//Outside the lock, the render thread takes it every frame and mustn't wait on the console. Synthetic traffic
+	//skips the echo, at stress rates it would measure the console rather than the pipeline.
+	if (kind != MidiMessage::ControlChange && !Stress::IsGenerating())
 	{
-		std::lock_guard<std::mutex> lock(midiMutex);
-		for (Mapping& mapping : mappings)
+		for (U32 i = 0; i < byteCount; ++i)
 		{
-			if (message->at(1) == mapping.midiValue)
-			{
-				if (message->at(2) >= mapping.velocityThreshold && (lastInput - mapping.lastHit) >= mapping.overhitThreshold)
-				{
-					mapping.lastHit = lastInput;
-
-					bool ghost = message->at(2) < settings.dynamicThreshold;
-
-					F32 dynamicMod = (ghost && settings.showDynamics) ? 0.5f : 1.0f;
-
-					switch (mapping.type)
-					{
-					case NoteType::Snare: {
-						Stats& stats = noteStats[0];
-						Renderer::SpawnNote(stats, colorProfile.snareColor * dynamicMod, settings.tomTexture);
-						++stats.hitCount;
-						if (ghost) { ++stats.ghostCount; }
-					} break;
-					case NoteType::Kick: {
-						Stats& stats = noteStats[1];
-						Renderer::SpawnNote(stats, colorProfile.kickColor * dynamicMod, settings.kickTexture);
-						++stats.hitCount;
-						if (ghost) { ++stats.ghostCount; }
-					} break;
-					case NoteType::Cymbal1: {
-						Stats& stats = noteStats[2];
-						Renderer::SpawnNote(stats, colorProfile.cymbal1Color * dynamicMod, settings.cymbalTexture);
-						++stats.hitCount;
-						if (ghost) { ++stats.ghostCount; }
-					} break;
-					case NoteType::Tom1: {
-						Stats& stats = noteStats[3];
-						Renderer::SpawnNote(stats, colorProfile.tom1Color * dynamicMod, settings.tomTexture);
-						++stats.hitCount;
-						if (ghost) { ++stats.ghostCount; }
-					} break;
-					case NoteType::Cymbal2: {
-						Stats& stats = noteStats[4];
-						Renderer::SpawnNote(stats, colorProfile.cymbal2Color * dynamicMod, settings.cymbalTexture);
-						++stats.hitCount;
-						if (ghost) { ++stats.ghostCount; }
-					} break;
-					case NoteType::Tom2: {
-						Stats& stats = noteStats[5];
-						Renderer::SpawnNote(stats, colorProfile.tom2Color * dynamicMod, settings.tomTexture);
-						++stats.hitCount;
-						if (ghost) { ++stats.ghostCount; }
-					} break;
-					case NoteType::Cymbal3: {
-						Stats& stats = noteStats[6];
-						Renderer::SpawnNote(stats, colorProfile.cymbal3Color * dynamicMod, settings.cymbalTexture);
-						++stats.hitCount;
-						if (ghost) { ++stats.ghostCount; }
-					} break;
-					case NoteType::Tom3: {
-						Stats& stats = noteStats[7];
-						Renderer::SpawnNote(stats, colorProfile.tom3Color * dynamicMod, settings.tomTexture);
-						++stats.hitCount;
-						if (ghost) { ++stats.ghostCount; }
-					} break;
-					}
-				}
-
-				break;
-			}
+			std::cout << "Byte " << i << " = " << (I32)message->at(i) << ", ";
 		}
+		std::cout << "stamp = " << deltatime << std::endl;
 	}
+#endif
+
+	bool dropped = false;
+
+	{
+		//The port's thread and the stress generator can both call in, the queues below take one producer at a time
+		std::lock_guard<std::mutex> lock(inputMutex);
+
+		//Ports registered with a clock have driver timestamps, anything else is stamped as it arrives
+		DeviceClock* clock = static_cast<DeviceClock*>(userData);
+		event.time = clock ? clock->Map(deltatime, arrival) : arrival;
+
+		Recorder::RecordMidi(event.time, event.bytes, event.size);
+
+		//Controllers stream hundreds of messages a second, they're folded into the lane levels here instead of queued
+		if (kind == MidiMessage::ControlChange) { engine.GetControllers().Feed(event); }
+		else { dropped = !inputQueue.Push(event); }
+	}
+
+	//Timed from the callback's start, the event's own time includes the driver's delay in delivering it
+	Stress::RecordCallback(Time::Now() - arrival, static_cast<U32>(inputQueue.Size()), dropped);
+	Allocations::CheckEvent();
+}
+
+void Visualizer::RawMidiCallback(const MidiEvent& event, void* userData)
+{
+	U64 arrival = Time::Now();
+
+	MidiMessage kind = inputDispatch.Classify(event);
+	if (kind == MidiMessage::Ignored) { return; }
+
+	TRACE_ZONE("Raw MIDI Callback");
+
+	bool dropped = false;
+
+	{
+		//Parsed on the reader's thread with its timestamp already set, so all that's left is queueing it
+		std::lock_guard<std::mutex> lock(inputMutex);
+
+		Recorder::RecordMidi(event.time, event.bytes, event.size);
+
+		if (kind == MidiMessage::ControlChange) { engine.GetControllers().Feed(event); }
+		else { dropped = !inputQueue.Push(event); }
+	}
+
+	//The kernel's frame stamp is when the bytes came in, not when this was called
+	Stress::RecordCallback(Time::Now() - arrival, static_cast<U32>(inputQueue.Size()), dropped);
+	Allocations::CheckEvent();
+}
+
+bool Visualizer::ProcessEvent(const MidiEvent& event)
+{
+	return engine.ProcessEvent(event);
+}
+
+void Visualizer::ResetState()
+{
+	inputQueue.Clear();
+	engine.Reset();
+}
+
+U64 Visualizer::StateHash()
+{
+	return engine.StateHash();
 }
 
 void Visualizer::KeyCallback(GLFWwindow* window, I32 key, I32 scancode, I32 action, I32 mods)
@@ -1123,4 +1150,4 @@ void Visualizer::KeyCallback(GLFWwindow* window, I32 key, I32 scancode, I32 acti
 void Visualizer::ErrorCallback(I32 error, const C8* description)
 {
 	std::cout << description << std::endl;
-}
+}
\ No newline at end of file
@@ -2,137 +2,77 @@
 
 #include "Defines.hpp"
 
-#include "Resources.hpp"
+#include "Config.hpp"
+#include "Engine.hpp"
+#include "EventSource.hpp"
+#include "FileWatcher.hpp"
+#include "MidiDispatch.hpp"
+#include "RawMidi.hpp"
+#include "StringTable.hpp"
+#include "Time.hpp"
+#include "RingBuffer.hpp"
 #include "Window.hpp"
 
 #include <vector>
 #include <array>
-#include <string>
+#include <atomic>
+#include <filesystem>
 #include <mutex>
+#include <string>
+#include <thread>
 
 struct GLFWwindow;
 struct GLFWmonitor;
 namespace rt { namespace midi { class RtMidiIn; } }
 namespace rt { namespace midi { class RtMidiOut; } }
 
-enum class ScrollDirection
+enum ReloadFlags : U32
 {
-	Up,
-	Down,
-	Left,
-	Right
+	ReloadProfiles = 1 << 0,
+	ReloadColorList = 1 << 1,
+	ReloadMidiList = 1 << 2,
+	ReloadColors = 1 << 3,
+	ReloadMappings = 1 << 4,
+	ReloadSettings = 1 << 5
 };
 
-enum class NoteSeparationMode
+/// <summary>
+/// Tables reparsed by the file watcher thread, handed to the main thread whole so it never sees a half loaded file
+/// </summary>
+struct ReloadTables
 {
-	None,
-	Cutoff,
-	Squish
+	U32 flags{ 0 };
+	std::vector<Profile> profiles;
+	StringTable profileNames;
+	StringTable colorProfileNames;
+	StringTable midiProfileNames;
+	ColorProfile colors;
+	std::vector<Mapping> mappings;
+	std::vector<std::pair<std::string, std::string>> settings;
 };
 
-enum class NoteType
+struct LaunchOptions
 {
-	Snare,
-	Kick,
-	Cymbal1,
-	Tom1,
-	Cymbal2,
-	Tom2,
-	Cymbal3,
-	Tom3
-};
-
-struct Mapping
-{
-	NoteType type;
-	I32 midiValue;
-	I32 velocityThreshold;
-	F64 overhitThreshold;
-	F64 lastHit{ -1.0 };
-};
-
-struct Profile
-{
-	U32 id;
-	std::string name;
-	std::string colorProfile;
-	U32 dynamicThreshold{ 100 };
-	bool leftyFlip;
-};
-
-struct ColorProfile
-{
-	Vector3 snareColor{ 1.0f, 0.0f, 0.0f };
-	Vector3 tom1Color{ 1.0f, 1.0f, 0.0f };
-	Vector3 tom2Color{ 0.0f, 0.537254930f, 1.0f };
-	Vector3 tom3Color{ 0.0f, 1.0f, 0.0f };
-	Vector3 cymbal1Color{ 1.0f, 0.898039222f, 0.192156866f };
-	Vector3 cymbal2Color{ 0.113725491f, 0.388235301f, 1.0f };
-	Vector3 cymbal3Color{ 0.0470588244f, 1.0f, 0.0470588244f };
-	Vector3 kickColor{ 1.0f, 0.274509817f, 0.0f };
-};
-
-struct Settings
-{
-	I32 settingWindowX{ 100 };
-	I32 settingWindowY{ 100 };
-	I32 settingWindowWidth{ 630 };
-	I32 settingWindowHeight{ 800 };
-
-	I32 visualizerWindowX{ 730 };
-	I32 visualizerWindowY{ 100 };
-	I32 visualizerWindowWidth{ 350 };
-	I32 visualizerWindowHeight{ 800 };
-
-	std::string portName{ "loopMIDI Visualizer" };
-	std::string colorProfileName{};
-	std::string midiProfileName{ "loopMIDI CH" };
-	U32 profileId{ U32_MAX };
-	U32 dynamicThreshold{ 100 };
-	bool leftyFlip{ false };
-	bool showDynamics{ true };
-	bool showStats{ true };
-	bool longKicks{ false };
-
-	F32 scrollSpeed{ 1.0f };
-	ScrollDirection scrollDirection{ ScrollDirection::Down };
-	F32 noteWidth{ 0.1f };
-	F32 noteHeight{ 0.025f };
-	F32 noteGap{ 0.005f };
-	NoteSeparationMode noteSeparationMode{ NoteSeparationMode::Cutoff };
-
-	std::string tomTextureName{ "square" };
-	std::string cymbalTextureName{ "triangle" };
-	std::string kickTextureName{ "square" };
-	Vector4 backgroundColor{ 0.0f, 0.0f, 0.0f, 0.0f };
-
-	Texture* tomTexture{ nullptr };
-	Texture* cymbalTexture{ nullptr };
-	Texture* kickTexture{ nullptr };
-};
-
-struct NoteInfo
-{
-	std::string name;
-	U32 index;
-};
-
-struct Stats
-{
-	Vector3 spawn{ 0.0f, 0.0f, 0.0f };
-	F32 scale{ 1.0f };
-	U32 lastIndex{ U32_MAX };
-	U32 hitCount{ 0 };
-	U32 ghostCount{ 0 };
+	std::string replayPath{};
+	F64 replaySpeed{ 1.0 };
+	bool exitAfterReplay{ false };
+	std::string tracePath{};
+	F32 stressRate{ 0.0f };
+	F32 stressDuration{ 10.0f };
+	bool checkAllocations{ false };
+	std::string rawMidiDevice{};	//Reads this rawmidi device instead of opening a port through RtMidi
 };
 
 class Visualizer
 {
 public:
-	static bool Initialize();
+	static constexpr U32 InputQueueCapacity = 1024;
+
+	static bool Initialize(const LaunchOptions& options = {});
 	static void Shutdown();
 
 	static void MidiCallback(F64 deltatime, std::vector<U8>* message, void* userData);
+	static void RawMidiCallback(const MidiEvent& event, void* userData);
 	static void KeyCallback(GLFWwindow* window, I32 key, I32 scancode, I32 action, I32 mods);
 	static void ErrorCallback(I32 error, const C8* description);
 
@@ -141,52 +81,107 @@ public:
 	static void SetProfile(I32 profileId);
 	static void SetColorProfile(const std::string& name);
 	static void SetMidiProfile(const std::string& name);
+	static void SetRecording(bool record);
+	static void SettingsChanged();
+	static void ApplyRecordedSetting(const std::string& name, const std::string& value);
+	static bool ProcessEvent(const MidiEvent& event);
+	static void ResetState();
+	static U64 StateHash();
+	static Engine& GetEngine();
 	static Settings& GetSettings();
 	static std::array<Stats, 8>& GetStats();
-	static std::array<NoteInfo, 8>& GetNoteInfos();
-	static std::vector<char*>& GetPorts();
-	static std::vector<char*>& GetProfiles();
-	static std::vector<char*>& GetColorProfiles();
-	static std::vector<char*>& GetMidiProfiles();
+	static NoteLayout& GetNoteInfos();
+	static const StringTable& GetPorts();
+	static const StringTable& GetProfiles();
+	static const StringTable& GetColorProfiles();
+	static const StringTable& GetMidiProfiles();
+	static const std::vector<Mapping>& GetMappings();
 
 private:
 	static void MainLoop();
 
+	/// <summary>
+	/// Uploads and draws the notes and both windows' UI, then presents them
+	/// </summary>
+	static void RenderFrame();
+
+	static bool RunStartup();
 	static bool InitializeGlfw();
-	static bool InitializeWindows();
+	static bool InitializeWindows(bool configLoaded);
 	static bool InitializeCH();
 	static bool InitializeMidi();
+	static void FinishMidi(bool connected);
+
+	/// <summary>
+	/// Opens a port on the given input, the startup task opens its own input before the UI can see it
+	/// </summary>
+	static bool OpenPort(rt::midi::RtMidiIn* input, const std::string& portName);
+
+	/// <summary>
+	/// Strips the part of a port's name the backend adds to tell ports apart, so a saved port is still found after
+	/// it's plugged back in
+	/// </summary>
+	static std::string PortName(const std::string& backendName);
 	static bool LoadConfig();
+	/// <summary>
+	/// Hands a snapshot of the settings to the background writer
+	/// </summary>
 	static void SaveConfig();
+
+	/// <summary>
+	/// Copies the windows' placement into the settings
+	/// </summary>
+	/// <returns>True if either window moved or was resized</returns>
+	static bool StoreWindowPlacement();
+	static std::string SerializeConfig();
 	static void PrepareTextures();
-	static std::wstring GetCloneHeroFolder();
-	static void LoadProfiles();
-	static void LoadColorProfiles();
-	static void LoadMidiProfiles();
-	static void LoadColors(const std::wstring& path);
-	static Vector3 HexToRBG(const std::string& hex);
-	static bool LoadMidiProfile(const std::wstring& path);
-	static void ParseMappings(const std::string& data, NoteType type, U64 start, U64 end);
+
+	/// <summary>
+	/// Watches the Clone Hero folders and settings.cfg, reparsing whatever changes and queueing it for ApplyReload
+	/// </summary>
+	static void WatchFiles();
+	static void ReloadFiles(const std::vector<FileChange>& changes, std::string& config);
+	static void StopWatching();
+
+	/// <summary>
+	/// Swaps in tables the watcher finished reparsing, called once per frame from the main loop
+	/// </summary>
+	static void ApplyReload();
 
 	static Settings settings;
-	static std::wstring cloneHeroFolder;
-	static std::array<NoteInfo, 8> noteInfos;
-	static std::array<Stats, 8> noteStats;
+	static std::filesystem::path cloneHeroFolder;
+	static NoteLayout noteInfos;
 	static ColorProfile colorProfile;
+	static Engine engine;
 	static std::vector<Profile> profiles;
-	static std::vector<char*> profileNames;
-	static std::vector<char*> colorProfileNames;
-	static std::vector<char*> midiProfileNames;
-	static std::vector<char*> midiPorts;
-	static std::vector<Mapping> mappings;
+	static StringTable profileNames;
+	static StringTable colorProfileNames;
+	static StringTable midiProfileNames;
+	static StringTable midiPorts;
+	static StringTable foundPorts;
 	static Window settingsWindow;
 	static Window visualizerWindow;
 	static GLFWmonitor* monitor;
-	static rt::midi::RtMidiIn* midiIn;
+	static rt::midi::RtMidiIn* midiIn;			//Main thread only, published by FinishMidi
+	static rt::midi::RtMidiIn* pendingMidiIn;	//Owned by the MIDI task until FinishMidi
 	static rt::midi::RtMidiOut* midiOut;
-	static F64 lastInput;
+	static DeviceClock midiClock;		//Guarded by inputMutex
+	static RawMidiReader rawMidi;
+	static MidiDispatch inputDispatch;	//Sorts messages on the input threads, rebuilt by the main thread
+	static ThreadPolicy inputPolicy;	//Copied at startup, input threads read it while settings can be reloaded
+	static U32 midiTask;
+	static bool startupFailed;
 	static bool configureMode;
-	static std::mutex midiMutex;
+	static LaunchOptions launchOptions;
+	static RingBuffer<MidiEvent, InputQueueCapacity> inputQueue;
+	static std::mutex inputMutex;
+	static std::thread watcher;
+	static std::atomic<bool> watching;
+	static std::atomic<bool> reloadPending;
+	static std::mutex reloadMutex;
+	static ReloadTables pendingReload;
+	static std::string watchedColorProfile;	//Copies of the profile names for the watcher, guarded by reloadMutex
+	static std::string watchedMidiProfile;
 
 	STATIC_CLASS(Visualizer)
 };
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "Defines.hpp"
+
+#include "Analysis.hpp"
+
+#include <iostream>
+#include <string>
+
+static constexpr const C8* Usage = "Usage: DrumVisualizerAnalyze [--analyze] <session, .mid or folder>... [--format json|csv] "
+	"[--output <file>] [--midi-profile <name>] [--threads N] [--window <seconds>]";
+
+int main(int argc, char** argv)
+{
+	AnalysisOptions options{};
+
+	for (I32 i = 1; i < argc; ++i)
+	{
+		//Plain paths are inputs too, --analyze is optional here
+		if (Analysis::ParseArgument(argc, argv, i, options)) { continue; }
+		if (argv[i][0] != '-') { options.inputs.push_back(argv[i]); continue; }
+
+		std::cout << Usage << std::endl;
+		return std::string(argv[i]) == "--help" ? 0 : -1;
+	}
+
+	if (options.inputs.empty())
+	{
+		std::cout << Usage << std::endl;
+		return -1;
+	}
+
+	return Analysis::Run(options);
+}
\ No newline at end of file
@@ -0,0 +1,479 @@
+#include "Defines.hpp"
+
+#include "AssetPack.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct PackItem
+{
+	std::string name;
+	PackEntryType type;
+	PackFormat format;
+	U32 width;
+	U32 height;
+	U32 levels;
+	std::vector<U8> data;
+};
+
+static bool IsImage(const std::string& extension)
+{
+	switch (HashCI(extension.c_str(), extension.length()))
+	{
+	case "jpg"_Hash:
+	case "jpeg"_Hash:
+	case "png"_Hash:
+	case "bmp"_Hash:
+	case "tga"_Hash:
+	case "jfif"_Hash:
+	case "tiff"_Hash: return true;
+	default: return false;
+	}
+}
+
+static U16 To565(const F32* color)
+{
+	U32 r = static_cast<U32>(color[0] * 31.0f / 255.0f + 0.5f);
+	U32 g = static_cast<U32>(color[1] * 63.0f / 255.0f + 0.5f);
+	U32 b = static_cast<U32>(color[2] * 31.0f / 255.0f + 0.5f);
+
+	return static_cast<U16>((r << 11) | (g << 5) | b);
+}
+
+static void From565(U16 value, I32* color)
+{
+	color[0] = ((value >> 11) & 31) * 255 / 31;
+	color[1] = ((value >> 5) & 63) * 255 / 63;
+	color[2] = (value & 31) * 255 / 31;
+}
+
+/// <summary>
+/// Encodes a BC1 color block, endpoints are the extremes of the texels along their principal axis
+/// </summary>
+/// <param name="texels:">16 RGBA texels in rows</param>
+/// <param name="destination:">8 bytes</param>
+static void EncodeColorBlock(const U8* texels, U8* destination)
+{
+	//Fully transparent texels are discarded by the sprite shader, their color doesn't matter
+	bool weights[16];
+	U32 count = 0;
+	for (U32 i = 0; i < 16; ++i) { count += weights[i] = texels[i * 4 + 3] > 0; }
+	if (count == 0) { for (bool& weight : weights) { weight = true; } count = 16; }
+
+	F32 mean[3]{};
+	for (U32 i = 0; i < 16; ++i)
+	{
+		if (!weights[i]) { continue; }
+		for (U32 c = 0; c < 3; ++c) { mean[c] += texels[i * 4 + c]; }
+	}
+
+	for (F32& m : mean) { m /= count; }
+
+	F32 covariance[6]{};
+	for (U32 i = 0; i < 16; ++i)
+	{
+		if (!weights[i]) { continue; }
+
+		F32 d[3] = { texels[i * 4] - mean[0], texels[i * 4 + 1] - mean[1], texels[i * 4 + 2] - mean[2] };
+		covariance[0] += d[0] * d[0];
+		covariance[1] += d[0] * d[1];
+		covariance[2] += d[0] * d[2];
+		covariance[3] += d[1] * d[1];
+		covariance[4] += d[1] * d[2];
+		covariance[5] += d[2] * d[2];
+	}
+
+	//A few rounds of power iteration are plenty for a 3x3 matrix
+	F32 axis[3] = { 1.0f, 1.0f, 1.0f };
+	for (U32 iteration = 0; iteration < 8; ++iteration)
+	{
+		F32 next[3] = {
+			covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+			covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+			covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]
+		};
+
+		F32 length = sqrtf(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+		if (length < 1e-6f) { break; }
+
+		for (U32 c = 0; c < 3; ++c) { axis[c] = next[c] / length; }
+	}
+
+	F32 minimum = 1e9f, maximum = -1e9f;
+	for (U32 i = 0; i < 16; ++i)
+	{
+		if (!weights[i]) { continue; }
+
+		F32 t = (texels[i * 4] - mean[0]) * axis[0] + (texels[i * 4 + 1] - mean[1]) * axis[1] + (texels[i * 4 + 2] - mean[2]) * axis[2];
+		if (t < minimum) { minimum = t; }
+		if (t > maximum) { maximum = t; }
+	}
+
+	F32 high[3], low[3];
+	for (U32 c = 0; c < 3; ++c)
+	{
+		high[c] = mean[c] + axis[c] * maximum;
+		low[c] = mean[c] + axis[c] * minimum;
+		high[c] = high[c] < 0.0f ? 0.0f : (high[c] > 255.0f ? 255.0f : high[c]);
+		low[c] = low[c] < 0.0f ? 0.0f : (low[c] > 255.0f ? 255.0f : low[c]);
+	}
+
+	U16 color0 = To565(high);
+	U16 color1 = To565(low);
+
+	//The first endpoint being larger selects the four color mode
+	if (color0 < color1)
+	{
+		U16 swap = color0;
+		color0 = color1;
+		color1 = swap;
+	}
+
+	I32 palette[4][3];
+	From565(color0, palette[0]);
+	From565(color1, palette[1]);
+	for (U32 c = 0; c < 3; ++c)
+	{
+		palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+		palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+	}
+
+	U32 indices = 0;
+	if (color0 != color1)
+	{
+		for (U32 i = 0; i < 16; ++i)
+		{
+			U32 best = 0;
+			I32 bestDistance = INT32_MAX;
+
+			for (U32 p = 0; p < 4; ++p)
+			{
+				I32 dr = texels[i * 4] - palette[p][0];
+				I32 dg = texels[i * 4 + 1] - palette[p][1];
+				I32 db = texels[i * 4 + 2] - palette[p][2];
+				I32 distance = dr * dr + dg * dg + db * db;
+
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					best = p;
+				}
+			}
+
+			indices |= best << (i * 2);
+		}
+	}
+
+	memcpy(destination, &color0, 2);
+	memcpy(destination + 2, &color1, 2);
+	memcpy(destination + 4, &indices, 4);
+}
+
+/// <summary>
+/// Encodes a BC3 alpha block with the 8 value mode
+/// </summary>
+/// <param name="texels:">16 RGBA texels in rows</param>
+/// <param name="destination:">8 bytes</param>
+static void EncodeAlphaBlock(const U8* texels, U8* destination)
+{
+	U8 alpha0 = 0, alpha1 = 255;
+	for (U32 i = 0; i < 16; ++i)
+	{
+		U8 alpha = texels[i * 4 + 3];
+		if (alpha > alpha0) { alpha0 = alpha; }
+		if (alpha < alpha1) { alpha1 = alpha; }
+	}
+
+	I32 palette[8] = { alpha0, alpha1 };
+	for (U32 i = 2; i < 8; ++i) { palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7; }
+
+	U64 indices = 0;
+	if (alpha0 != alpha1)
+	{
+		for (U32 i = 0; i < 16; ++i)
+		{
+			U64 best = 0;
+			I32 bestDistance = INT32_MAX;
+
+			for (U32 p = 0; p < 8; ++p)
+			{
+				I32 distance = texels[i * 4 + 3] - palette[p];
+				distance = distance < 0 ? -distance : distance;
+
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					best = p;
+				}
+			}
+
+			indices |= best << (i * 3);
+		}
+	}
+
+	destination[0] = alpha0;
+	destination[1] = alpha1;
+	for (U32 i = 0; i < 6; ++i) { destination[2 + i] = static_cast<U8>(indices >> (i * 8)); }
+}
+
+/// <summary>
+/// Block compresses one RGBA8 level, edge blocks repeat the last row and column
+/// </summary>
+static void Compress(PackFormat format, const U8* source, U32 width, U32 height, U8* destination)
+{
+	U8 texels[64];
+
+	for (U32 blockY = 0; blockY < height; blockY += 4)
+	{
+		for (U32 blockX = 0; blockX < width; blockX += 4)
+		{
+			for (U32 y = 0; y < 4; ++y)
+			{
+				U32 sourceY = blockY + y < height ? blockY + y : height - 1;
+
+				for (U32 x = 0; x < 4; ++x)
+				{
+					U32 sourceX = blockX + x < width ? blockX + x : width - 1;
+					memcpy(texels + (y * 4 + x) * 4, source + (static_cast<U64>(sourceY) * width + sourceX) * 4, 4);
+				}
+			}
+
+			if (format == PackFormat::BC3)
+			{
+				EncodeAlphaBlock(texels, destination);
+				destination += 8;
+			}
+
+			EncodeColorBlock(texels, destination);
+			destination += 8;
+		}
+	}
+}
+
+/// <summary>
+/// Decodes an image the same way Resources does and appends its mip chain, block compressed if asked
+/// </summary>
+static bool PackImage(const std::filesystem::path& path, bool mips, bool compress, PackItem& item)
+{
+	I32 width, height, comp;
+	U8* pixels = stbi_load(path.string().c_str(), &width, &height, &comp, 4);
+	if (!pixels)
+	{
+		std::cout << "Failed To Decode, Skipping: " << path.string() << std::endl;
+		return false;
+	}
+
+	item.type = PackEntryType::Texture;
+	item.format = PackFormat::RGBA8;
+	item.width = static_cast<U32>(width);
+	item.height = static_cast<U32>(height);
+	item.levels = mips ? AssetPack::LevelCount(item.width, item.height) : 1;
+	item.data.resize(AssetPack::TextureSize(PackFormat::RGBA8, item.width, item.height, item.levels));
+
+	memcpy(item.data.data(), pixels, static_cast<U64>(width) * height * 4);
+	stbi_image_free(pixels);
+
+	U8* level = item.data.data();
+	for (U32 i = 1; i < item.levels; ++i)
+	{
+		U8* next = level + AssetPack::LevelBytes(PackFormat::RGBA8, item.width, item.height, i - 1);
+		AssetPack::Downsample(level, AssetPack::LevelSize(item.width, i - 1), AssetPack::LevelSize(item.height, i - 1), next);
+		level = next;
+	}
+
+	if (!compress) { return true; }
+
+	//Opaque images get the smaller format
+	bool opaque = true;
+	for (U64 i = 3; i < static_cast<U64>(width) * height * 4 && opaque; i += 4) { opaque = item.data[i] == 255; }
+
+	PackFormat format = opaque ? PackFormat::BC1 : PackFormat::BC3;
+	std::vector<U8> compressed(AssetPack::TextureSize(format, item.width, item.height, item.levels));
+
+	const U8* source = item.data.data();
+	U8* destination = compressed.data();
+	for (U32 i = 0; i < item.levels; ++i)
+	{
+		Compress(format, source, AssetPack::LevelSize(item.width, i), AssetPack::LevelSize(item.height, i), destination);
+		source += AssetPack::LevelBytes(PackFormat::RGBA8, item.width, item.height, i);
+		destination += AssetPack::LevelBytes(format, item.width, item.height, i);
+	}
+
+	item.format = format;
+	item.data = std::move(compressed);
+
+	return true;
+}
+
+static bool PackText(const std::filesystem::path& path, PackItem& item)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+	{
+		std::cout << "Failed To Read, Skipping: " << path.string() << std::endl;
+		return false;
+	}
+
+	item.type = PackEntryType::Text;
+	item.format = PackFormat::None;
+	item.width = 0;
+	item.height = 0;
+	item.levels = 0;
+	item.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	return true;
+}
+
+static bool WritePack(const std::string& output, const std::vector<PackItem>& items)
+{
+	std::string names;
+	for (const PackItem& item : items) { names += item.name; }
+
+	U64 offset = sizeof(PackHeader) + items.size() * sizeof(PackEntry) + names.size();
+
+	std::vector<PackEntry> entries;
+	U32 nameOffset = 0;
+
+	for (const PackItem& item : items)
+	{
+		offset = (offset + AssetPack::DataAlignment - 1) & ~(AssetPack::DataAlignment - 1);
+
+		PackEntry entry{};
+		entry.type = item.type;
+		entry.format = item.format;
+		entry.nameOffset = nameOffset;
+		entry.nameLength = static_cast<U32>(item.name.size());
+		entry.width = item.width;
+		entry.height = item.height;
+		entry.levels = item.levels;
+		entry.offset = offset;
+		entry.size = item.data.size();
+		entries.push_back(entry);
+
+		nameOffset += entry.nameLength;
+		offset += entry.size;
+	}
+
+	PackHeader header{};
+	header.magic = AssetPack::Magic;
+	header.version = AssetPack::Version;
+	header.entryCount = static_cast<U32>(items.size());
+	header.namesSize = static_cast<U32>(names.size());
+	header.fileSize = offset;
+
+	//Written next to the output and renamed over it, a running visualizer never maps a half written pack
+	std::string temporary = output + ".tmp";
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		std::cout << "Failed To Write Asset Pack: " << output << std::endl;
+		return false;
+	}
+
+	file.write(reinterpret_cast<const C8*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const C8*>(entries.data()), entries.size() * sizeof(PackEntry));
+	file.write(names.data(), names.size());
+
+	static const C8 padding[AssetPack::DataAlignment]{};
+	for (U64 i = 0; i < items.size(); ++i)
+	{
+		U64 position = static_cast<U64>(file.tellp());
+		file.write(padding, entries[i].offset - position);
+		file.write(reinterpret_cast<const C8*>(items[i].data.data()), items[i].data.size());
+	}
+
+	file.close();
+	if (!file)
+	{
+		std::cout << "Failed To Write Asset Pack: " << output << std::endl;
+		return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporary, output, error);
+	if (error)
+	{
+		std::cout << "Failed To Replace Asset Pack: " << output << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	std::string input = "assets";
+	std::string output = AssetPack::DefaultPath;
+	bool mips = true;
+	bool compress = false;
+	U32 positional = 0;
+
+	for (I32 i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--no-mips") { mips = false; }
+		else if (arg == "--compress") { compress = true; }
+		else if (arg[0] != '-' && positional == 0) { input = arg; ++positional; }
+		else if (arg[0] != '-' && positional == 1) { output = arg; ++positional; }
+		else
+		{
+			std::cout << "Usage: DrumVisualizerPacker [--no-mips] [--compress] [assets folder] [output file]" << std::endl;
+			return arg == "--help" ? 0 : -1;
+		}
+	}
+
+	std::error_code error;
+	std::vector<std::filesystem::path> paths;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(input, error))
+	{
+		if (entry.is_regular_file()) { paths.push_back(entry.path()); }
+	}
+
+	if (error)
+	{
+		std::cout << "Failed To Open Assets Folder: " << input << std::endl;
+		return -1;
+	}
+
+	//Sorted so the same folder always builds the same pack
+	std::sort(paths.begin(), paths.end());
+
+	//Same flip as Resources, the packed rows are uploaded as is
+	stbi_set_flip_vertically_on_load(true);
+
+	std::vector<PackItem> items;
+	U64 textures = 0;
+
+	for (const std::filesystem::path& path : paths)
+	{
+		PackItem item{};
+		item.name = path.filename().string();
+
+		std::string extension = path.extension().string();
+		if (!extension.empty()) { extension.erase(0, 1); }
+		if (HashCI(extension.c_str(), extension.length()) == "dvpack"_Hash) { continue; }
+
+		bool packed = IsImage(extension) ? PackImage(path, mips, compress, item) : PackText(path, item);
+		if (!packed) { continue; }
+
+		if (item.type == PackEntryType::Texture) { ++textures; }
+		items.push_back(std::move(item));
+	}
+
+	if (!WritePack(output, items)) { return -1; }
+
+	std::cout << "Packed " << textures << " textures and " << items.size() - textures << " files into " << output << std::endl;
+
+	return 0;
+}
\ No newline at end of file